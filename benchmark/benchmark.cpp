@@ -0,0 +1,550 @@
+/**
+ * benchmark.cpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 22:10:38 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Throughput and latency of the queue types across element sizes,
+ * capacities, the single item and range APIs and pinned core pairs.
+ * Every run prints one JSON object per line on stdout so results
+ * can be diffed between builds, e.g.
+ *
+ *   benchmark --items 4194304 > before.json
+ *
+ * Options:
+ *   --items N        items per run, default 2^22
+ *   --sample N       stamp one item in N for latency, power of two,
+ *                    default 64
+ *   --type T         only Heap, FixedHeap, SharedMemory or Infinite,
+ *                    FixedHeap is Heap with the capacity fixed at
+ *                    compile time
+ *   --wait W         spin, yield (default) or park
+ *   --quick          one small configuration per type, for smoke tests
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+#include "ringbuffer.tcc"
+#include "placement.hpp"
+
+/** items per batch for insert / pop_range **/
+#define BATCH 32
+
+/**
+ * Payload - N bytes, the first eight carry the time the item
+ * was handed to the queue or zero if it isn't sampled.
+ */
+template < std::size_t N > struct Payload
+{
+   static_assert( N >= sizeof( std::uint64_t ), "payload holds at least the stamp" );
+   std::uint64_t                                    stamp;
+   std::array< char, N - sizeof( std::uint64_t ) >  pad;
+};
+
+static std::uint64_t
+now_ns()
+{
+   return( std::chrono::duration_cast< std::chrono::nanoseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+enum class Api { Push, Allocate, Insert };
+
+static const char*
+api_name( const Api api )
+{
+   switch( api )
+   {
+      case( Api::Push ):      return( "push" );
+      case( Api::Allocate ):  return( "allocate" );
+      case( Api::Insert ):    return( "insert" );
+   }
+   return( "" );
+}
+
+/**
+ * Pinning - where the producer and consumer run, -1 leaves
+ * the thread to the scheduler.
+ */
+struct Pinning
+{
+   std::string name;
+   int         producer;
+   int         consumer;
+};
+
+struct CPU
+{
+   int id;
+   int core;
+   int package;
+};
+
+static int
+read_topology( const int cpu, const char *what, const int fallback )
+{
+   std::ifstream in( "/sys/devices/system/cpu/cpu" + std::to_string( cpu ) +
+                     "/topology/" + what );
+   int value( fallback );
+   if( ! ( in >> value ) )
+   {
+      return( fallback );
+   }
+   return( value );
+}
+
+/**
+ * placements - unpinned, both on one cpu, SMT siblings, two
+ * cores of one package and two packages, whichever of them
+ * the cpus we're allowed on can provide.
+ */
+static std::vector< Pinning >
+placements()
+{
+   std::vector< CPU > cpus;
+   cpu_set_t set;
+   CPU_ZERO( &set );
+   if( sched_getaffinity( 0, sizeof( set ), &set ) == 0 )
+   {
+      for( int i( 0 ); i < CPU_SETSIZE; i++ )
+      {
+         if( CPU_ISSET( i, &set ) )
+         {
+            cpus.push_back( CPU{ i,
+                                 read_topology( i, "core_id", i ),
+                                 read_topology( i, "physical_package_id", 0 ) } );
+         }
+      }
+   }
+   std::vector< Pinning > out{ Pinning{ "unpinned", -1, -1 } };
+   if( cpus.empty() )
+   {
+      return( out );
+   }
+   out.push_back( Pinning{ "same-cpu", cpus[ 0 ].id, cpus[ 0 ].id } );
+   enum Kind { SMT, Core, Socket };
+   const char *names[] = { "smt-sibling", "cross-core", "cross-socket" };
+   for( const auto kind : { SMT, Core, Socket } )
+   {
+      [&]()
+      {
+         for( const auto &a : cpus )
+         {
+            for( const auto &b : cpus )
+            {
+               const bool same_package( a.package == b.package );
+               const bool same_core   ( same_package && a.core == b.core );
+               if( a.id != b.id &&
+                   ( ( kind == SMT    && same_core ) ||
+                     ( kind == Core   && same_package && ! same_core ) ||
+                     ( kind == Socket && ! same_package ) ) )
+               {
+                  out.push_back( Pinning{ names[ kind ], a.id, b.id } );
+                  return;
+               }
+            }
+         }
+      }();
+   }
+   return( out );
+}
+
+static void
+pin( const int cpu )
+{
+   if( cpu < 0 )
+   {
+      return;
+   }
+   Placement::pin_cpu( cpu );
+}
+
+struct Options
+{
+   std::uint64_t  items   = 1 << 22;
+   std::uint64_t  sample  = 64;
+   std::string    type;
+   Wait::Policy   policy;
+   bool           quick   = false;
+};
+
+/**
+ * Run - one measurement, latencies are in nanoseconds from
+ * the producer handing an item over to the consumer having it.
+ */
+struct Run
+{
+   std::string                   type;
+   std::size_t                   element_bytes;
+   std::size_t                   capacity;
+   Api                           api;
+   std::string                   placement;
+   std::string                   side;
+   std::uint64_t                 items;
+   double                        seconds;
+   std::vector< std::uint64_t >  latency;
+};
+
+static void
+report( Run &run )
+{
+   std::cout << "{\"type\":\""        << run.type          << "\""
+             << ",\"element_bytes\":" << run.element_bytes
+             << ",\"capacity\":"      << run.capacity
+             << ",\"api\":\""         << api_name( run.api ) << "\""
+             << ",\"placement\":\""   << run.placement     << "\""
+             << ",\"side\":\""        << run.side          << "\""
+             << ",\"items\":"         << run.items
+             << ",\"seconds\":"       << run.seconds
+             << ",\"items_per_sec\":" << ( run.seconds > 0 ? run.items / run.seconds : 0 );
+   if( ! run.latency.empty() )
+   {
+      auto &l( run.latency );
+      std::sort( l.begin(), l.end() );
+      auto pct( [&]( const double p ) -> std::uint64_t
+      {
+         return( l[ std::min< std::size_t >( l.size() - 1, p * l.size() ) ] );
+      } );
+      std::cout << ",\"latency_ns\":{\"samples\":" << l.size()
+                << ",\"p50\":"  << pct( 0.50 )
+                << ",\"p90\":"  << pct( 0.90 )
+                << ",\"p99\":"  << pct( 0.99 )
+                << ",\"p999\":" << pct( 0.999 )
+                << ",\"max\":"  << l.back() << "}";
+   }
+   std::cout << "}\n";
+   std::cout.flush();
+}
+
+template < class E > static void
+produce( FIFO &fifo, const Api api, const std::uint64_t items, const std::uint64_t mask )
+{
+   auto stamp( [&]( const std::uint64_t i ) -> std::uint64_t
+   {
+      return( ( i & mask ) == 0 ? now_ns() : 0 );
+   } );
+   switch( api )
+   {
+      case( Api::Push ):
+      {
+         E item;
+         for( std::uint64_t i( 0 ); i < items; i++ )
+         {
+            item.stamp = stamp( i );
+            fifo.push( item );
+         }
+      }
+      break;
+      case( Api::Allocate ):
+      {
+         for( std::uint64_t i( 0 ); i < items; i++ )
+         {
+            auto &ref( fifo.allocate< E >() );
+            ref.stamp = stamp( i );
+            fifo.push();
+         }
+      }
+      break;
+      case( Api::Insert ):
+      {
+         std::array< E, BATCH > batch;
+         for( std::uint64_t i( 0 ); i < items; i += BATCH )
+         {
+            const auto n( std::min< std::uint64_t >( BATCH, items - i ) );
+            for( std::uint64_t j( 0 ); j < n; j++ )
+            {
+               batch[ j ].stamp = stamp( i + j );
+            }
+            fifo.insert( batch.begin(), batch.begin() + n );
+         }
+      }
+      break;
+   }
+}
+
+template < class E > static void
+consume( FIFO &fifo,
+         const Api api,
+         const std::uint64_t items,
+         std::vector< std::uint64_t > *latency )
+{
+   auto record( [&]( const E &item )
+   {
+      if( latency != nullptr && item.stamp != 0 )
+      {
+         latency->push_back( now_ns() - item.stamp );
+      }
+   } );
+   if( api == Api::Insert )
+   {
+      std::array< E, BATCH > batch;
+      for( std::uint64_t i( 0 ); i < items; i += BATCH )
+      {
+         const auto n( std::min< std::uint64_t >( BATCH, items - i ) );
+         fifo.pop_range( batch.data(), n );
+         for( std::uint64_t j( 0 ); j < n; j++ )
+         {
+            record( batch[ j ] );
+         }
+      }
+   }
+   else
+   {
+      E item;
+      for( std::uint64_t i( 0 ); i < items; i++ )
+      {
+         fifo.pop( item );
+         record( item );
+      }
+   }
+}
+
+/**
+ * make_fixed - heap queue with the capacity fixed at compile 
+ * time, only for the capacities the benchmark runs.
+ */
+template < class E > static std::unique_ptr< FIFO >
+make_fixed( const std::size_t capacity, const Wait::Policy &policy )
+{
+   switch( capacity )
+   {
+      case( 64 ):
+         return( std::unique_ptr< FIFO >( 
+            new RingBuffer< E, Type::Heap, Layout::Split, 64 >( policy ) ) );
+      case( 1024 ):
+         return( std::unique_ptr< FIFO >( 
+            new RingBuffer< E, Type::Heap, Layout::Split, 1024 >( policy ) ) );
+      case( 16384 ):
+         return( std::unique_ptr< FIFO >( 
+            new RingBuffer< E, Type::Heap, Layout::Split, 16384 >( policy ) ) );
+      default:
+         std::cerr << "no fixed capacity of " << capacity << "\n";
+         exit( EXIT_FAILURE );
+   }
+}
+
+template < class E > static void
+run_type( const std::string &type,
+          const std::size_t capacity,
+          const Api api,
+          const Pinning &placement,
+          const Options &options )
+{
+   Run run{ type, sizeof( E ), capacity, api, placement.name, "both", options.items, 0, {} };
+   /** producer and consumer on their own threads, both pinned as asked **/
+   auto pair( [&]( FIFO &producer_end, FIFO &consumer_end )
+   {
+      run.latency.reserve( run.items / options.sample + 1 );
+      std::uint64_t end( 0 );
+      std::thread consumer( [&]()
+      {
+         pin( placement.consumer );
+         consume< E >( consumer_end, run.api, run.items, &run.latency );
+         end = now_ns();
+      } );
+      std::uint64_t start( 0 );
+      std::thread producer( [&]()
+      {
+         pin( placement.producer );
+         start = now_ns();
+         produce< E >( producer_end, run.api, run.items, options.sample - 1 );
+      } );
+      producer.join();
+      consumer.join();
+      run.seconds = ( end - start ) / 1e9;
+      report( run );
+   } );
+   if( type == "Heap" )
+   {
+      RingBuffer< E, Type::Heap > buffer( capacity, 16, options.policy );
+      pair( buffer, buffer );
+   }
+   else if( type == "FixedHeap" )
+   {
+      auto buffer( make_fixed< E >( capacity, options.policy ) );
+      pair( *buffer, *buffer );
+   }
+   else if( type == "SharedMemory" )
+   {
+      /** both ends in this process, each on its own mapping **/
+      char key[ 256 ];
+      SHM::GenKey( key, 256 );
+      RingBuffer< E, Type::SharedMemory > producer_end( capacity, key, Direction::Producer,
+                                                        16, options.policy );
+      RingBuffer< E, Type::SharedMemory > consumer_end( capacity, key, Direction::Consumer,
+                                                        16, options.policy );
+      pair( producer_end, consumer_end );
+   }
+   else if( type == "Infinite" )
+   {
+      /** never blocks, each side is timed alone to show its raw cost **/
+      RingBuffer< E, Type::Infinite > buffer( capacity );
+      run.side = "producer";
+      std::thread producer( [&]()
+      {
+         pin( placement.producer );
+         const auto start( now_ns() );
+         produce< E >( buffer, run.api, run.items, options.sample - 1 );
+         run.seconds = ( now_ns() - start ) / 1e9;
+      } );
+      producer.join();
+      report( run );
+      run.side = "consumer";
+      std::thread consumer( [&]()
+      {
+         pin( placement.consumer );
+         const auto start( now_ns() );
+         consume< E >( buffer, run.api, run.items, nullptr );
+         run.seconds = ( now_ns() - start ) / 1e9;
+      } );
+      consumer.join();
+      report( run );
+   }
+}
+
+static void
+run_size( const std::size_t element_bytes,
+          const std::string &type,
+          const std::size_t capacity,
+          const Api api,
+          const Pinning &placement,
+          const Options &options )
+{
+   switch( element_bytes )
+   {
+      case( 8 ):
+         run_type< Payload< 8 > >( type, capacity, api, placement, options );
+      break;
+      case( 64 ):
+         run_type< Payload< 64 > >( type, capacity, api, placement, options );
+      break;
+      case( 256 ):
+         run_type< Payload< 256 > >( type, capacity, api, placement, options );
+      break;
+      default:
+         std::cerr << "unsupported element size " << element_bytes << "\n";
+         exit( EXIT_FAILURE );
+   }
+}
+
+static void
+usage( const char *name )
+{
+   std::cerr << "usage: " << name << " [--items N] [--sample N] "
+             << "[--type Heap|FixedHeap|SharedMemory|Infinite] [--wait spin|yield|park] [--quick]\n";
+   exit( EXIT_FAILURE );
+}
+
+int
+main( int argc, char **argv )
+{
+   Options options;
+   for( int i( 1 ); i < argc; i++ )
+   {
+      const std::string arg( argv[ i ] );
+      const bool has_value( i + 1 < argc );
+      if( arg == "--items" && has_value )
+      {
+         options.items = std::strtoull( argv[ ++i ], nullptr, 10 );
+      }
+      else if( arg == "--sample" && has_value )
+      {
+         options.sample = std::strtoull( argv[ ++i ], nullptr, 10 );
+      }
+      else if( arg == "--type" && has_value )
+      {
+         options.type = argv[ ++i ];
+      }
+      else if( arg == "--wait" && has_value )
+      {
+         const std::string wait( argv[ ++i ] );
+         if( wait == "spin" )
+         {
+            options.policy = Wait::Policy( Wait::Spin );
+         }
+         else if( wait == "yield" )
+         {
+            options.policy = Wait::Policy( Wait::Yield );
+         }
+         else if( wait == "park" )
+         {
+            options.policy = Wait::Policy( Wait::Park );
+         }
+         else
+         {
+            usage( argv[ 0 ] );
+         }
+      }
+      else if( arg == "--quick" )
+      {
+         options.quick = true;
+      }
+      else
+      {
+         usage( argv[ 0 ] );
+      }
+   }
+   if( options.sample == 0 || ( options.sample & ( options.sample - 1 ) ) != 0 )
+   {
+      usage( argv[ 0 ] );
+   }
+
+   std::vector< std::string >  types{ "Heap", "FixedHeap", "SharedMemory", "Infinite" };
+   std::vector< std::size_t >  sizes{ 8, 64, 256 };
+   std::vector< std::size_t >  capacities{ 64, 1024, 16384 };
+   std::vector< Api >          apis{ Api::Push, Api::Allocate, Api::Insert };
+   auto                        where( placements() );
+   if( options.quick )
+   {
+      options.items = std::min< std::uint64_t >( options.items, 1 << 14 );
+      sizes      = { 64 };
+      capacities = { 1024 };
+      where.resize( 1 );
+   }
+   for( const auto &type : types )
+   {
+      if( ! options.type.empty() && options.type != type )
+      {
+         continue;
+      }
+      for( const auto &placement : where )
+      {
+         for( const auto size : sizes )
+         {
+            for( const auto capacity : capacities )
+            {
+               for( const auto api : apis )
+               {
+                  run_size( size, type, capacity, api, placement, options );
+               }
+            }
+         }
+      }
+   }
+   return( EXIT_SUCCESS );
+}
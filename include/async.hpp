@@ -0,0 +1,186 @@
+/**
+ * async.hpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 17:40:12 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _ASYNC_HPP_
+#define _ASYNC_HPP_  1
+#include <atomic>
+#include <thread>
+
+/**
+ * FIFO_COROUTINES - set when the translation unit is built as
+ * C++20 with coroutine support, the heap queues then have
+ * async_push / async_pop / async_pop_range.  The rest of the
+ * library doesn't change so it may be built as C++14.
+ */
+#ifndef FIFO_COROUTINES
+#if defined( __cpp_impl_coroutine ) && __cpp_impl_coroutine >= 201902L && \
+    defined( __has_include )
+#if __has_include( <coroutine> )
+#define FIFO_COROUTINES 1
+#endif
+#endif
+#endif
+#ifndef FIFO_COROUTINES
+#define FIFO_COROUTINES 0
+#endif
+
+#if FIFO_COROUTINES
+#include <coroutine>
+#endif
+
+namespace Async
+{
+   /**
+    * Waiter - something suspended on one end of a queue,
+    * wake() is called at most once by the other end once it
+    * has made the queue ready.
+    */
+   class Waiter
+   {
+   public:
+      virtual ~Waiter() = default;
+
+      virtual void wake() = 0;
+   };
+
+   /**
+    * Slot - holds at most one Waiter for one end of a queue.
+    * The other end calls fire() after it publishes, following
+    * a sequentially consistent fence (Pointer::wake() has one),
+    * otherwise a waiter that parked at the same moment might
+    * not be seen.
+    */
+   class Slot
+   {
+   public:
+      Slot() : waiter( nullptr )
+      {
+      }
+
+      /**
+       * park - puts w in the slot, readiness must be checked
+       * again after this.
+       * @param   w - Waiter*
+       */
+      void park( Waiter *w )
+      {
+         waiter.store( w, std::memory_order_release );
+         std::atomic_thread_fence( std::memory_order_seq_cst );
+      }
+
+      /**
+       * cancel - takes w back out of the slot.
+       * @param   w - Waiter*
+       * @return  bool, false if fire() got to it first
+       */
+      bool cancel( Waiter *w )
+      {
+         return( waiter.compare_exchange_strong( w, nullptr, std::memory_order_acq_rel ) );
+      }
+
+      /** wakes whatever is parked, called by the other end **/
+      void fire()
+      {
+         if( waiter.load( std::memory_order_relaxed ) == nullptr )
+         {
+            return;
+         }
+         auto *w( waiter.exchange( nullptr, std::memory_order_acq_rel ) );
+         if( w != nullptr )
+         {
+            w->wake();
+         }
+      }
+
+   private:
+      std::atomic< Waiter* >  waiter;
+   };
+
+#if FIFO_COROUTINES
+   /**
+    * Awaiter - common part of the heap queue awaitables.  The
+    * coroutine is resumed by the thread that made the queue
+    * ready, inline in its push or pop, co_await your executor's
+    * schedule() afterwards to move back onto the executor.  The
+    * awaiter lives in the coroutine frame, nothing is allocated.
+    */
+   class Awaiter : public Waiter
+   {
+   public:
+      Awaiter() : done( false ),
+                  state( Registering )
+      {
+      }
+
+      /** see Slot::fire() **/
+      virtual void wake()
+      {
+         if( state.exchange( Woken, std::memory_order_acq_rel ) == Suspended )
+         {
+            handle.resume();
+         }
+      }
+
+   protected:
+      /**
+       * suspend - parks on slot and tries attempt once more,
+       * nobody resumes the coroutine until it commits to being
+       * suspended so attempt may touch the queue.
+       * @param   slot    - Slot&
+       * @param   h       - std::coroutine_handle<>
+       * @param   attempt - F, tries the operation without blocking
+       * @return  bool, true if the coroutine stays suspended
+       */
+      template < class F > bool suspend( Slot &slot,
+                                         std::coroutine_handle<> h,
+                                         F &&attempt )
+      {
+         handle = h;
+         slot.park( this );
+         if( attempt() )
+         {
+            done = true;
+            if( ! slot.cancel( this ) )
+            {
+               /** the other end is inside wake(), we go on once it is out **/
+               while( state.load( std::memory_order_acquire ) != Woken )
+               {
+                  std::this_thread::yield();
+               }
+            }
+            return( false );
+         }
+         Registering_t expected( Registering );
+         /** nothing may touch this after a successful exchange **/
+         return( state.compare_exchange_strong( expected,
+                                                Suspended,
+                                                std::memory_order_acq_rel ) );
+      }
+
+      bool                          done;
+
+   private:
+      enum Registering_t { Registering, Suspended, Woken };
+
+      std::coroutine_handle<>       handle;
+      std::atomic< Registering_t >  state;
+   };
+#endif
+}
+#endif /* END _ASYNC_HPP_ */
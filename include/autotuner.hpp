@@ -0,0 +1,121 @@
+/**
+ * autotuner.hpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 20:12:44 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _AUTOTUNER_HPP_
+#define _AUTOTUNER_HPP_  1
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fifo.hpp"
+
+/**
+ * AutoTuner - sizes FIFOs from their blocking statistics.  Every
+ * period the write side stats of each FIFO are read (and zeroed,
+ * see FIFO::get_zero_write_stats), a FIFO whose writer blocked is
+ * grown, one that has been lightly used for idle_periods in a row
+ * is shrunk.  Resizing goes through FIFO::resize() so it is safe
+ * while the FIFOs are in use, FIFOs that can't be resized are
+ * left alone.  Nothing else should be reading the stats of a
+ * FIFO while it is being tuned.
+ */
+class AutoTuner
+{
+public:
+   struct Policy
+   {
+      Policy() : period( 10 ),
+                 min_cap( 64 ),
+                 max_cap( 1 << 20 ),
+                 idle_periods( 100 )
+      {
+      }
+
+      /** time between passes of the background thread **/
+      std::chrono::milliseconds  period;
+      /** never shrink below / grow beyond these **/
+      std::size_t                min_cap;
+      std::size_t                max_cap;
+      /**
+       * passes in a row without blocking and with fewer than
+       * a quarter of the capacity written before shrinking
+       */
+      std::uint32_t              idle_periods;
+   };
+
+   AutoTuner( const Policy &policy = Policy() );
+
+   /** stops the background thread if it is running **/
+   ~AutoTuner();
+
+   /**
+    * add - starts tuning fifo, it must stay alive until it
+    * is removed or the tuner is destroyed.
+    * @param   fifo - FIFO*
+    */
+   void add( FIFO *fifo );
+
+   /**
+    * remove - stops tuning fifo, once this returns the tuner
+    * won't touch it again.
+    * @param   fifo - FIFO*
+    */
+   void remove( FIFO *fifo );
+
+   /**
+    * tune - a single pass over every FIFO, called by the
+    * background thread each period, may also be called
+    * directly instead of starting the thread.
+    */
+   void tune();
+
+   /**
+    * start - starts a background thread calling tune() once
+    * per period.
+    */
+   void start();
+
+   /**
+    * stop - stops the background thread, returns once it
+    * has exited.
+    */
+   void stop();
+
+private:
+   struct Entry
+   {
+      FIFO          *fifo;
+      std::uint32_t  idle;
+   };
+
+   /** decides on and requests a new size for one FIFO **/
+   void tune( Entry &entry );
+
+   const Policy             policy;
+   std::vector< Entry >     entries;
+   std::mutex               mutex;
+   std::condition_variable  cond;
+   std::thread              thread;
+   bool                     running;
+};
+#endif /* END _AUTOTUNER_HPP_ */
@@ -20,6 +20,7 @@
 #ifndef _BLOCKED_HPP_
 #define _BLOCKED_HPP_  1
 #include <cstdint>
+#include <atomic>
 
 union Blocked
 {
@@ -50,4 +51,65 @@ union Blocked
    std::uint64_t all;
 } __attribute__ ((aligned( 8 )));
 
+/**
+ * BlockedCounter - the live side of Blocked.  One end of a queue
+ * owns it and only ever moves its words forward with plain relaxed
+ * loads and stores, no locked read-modify-writes on the element
+ * path.  A single monitor (e.g., the AutoTuner) reads the words
+ * from another thread and reports the difference to what it saw
+ * last time, so nothing the owner adds is ever lost to a reset.
+ */
+class BlockedCounter
+{
+public:
+   BlockedCounter() : count( 0 ),
+                      blocked( 0 )
+   {}
+
+   /**
+    * add - count n items moved by the owning end, owner only
+    * @param   n - const std::uint32_t
+    */
+   void add( const std::uint32_t n )
+   {
+      count.store( count.load( std::memory_order_relaxed ) + n,
+                   std::memory_order_relaxed );
+   }
+
+   /**
+    * mark_blocked - note that the owning end had to wait, 
+    * owner only, cheap to call every time around a wait loop.
+    */
+   void mark_blocked()
+   {
+      blocked.store( blocked.load( std::memory_order_relaxed ) + 1,
+                     std::memory_order_relaxed );
+   }
+
+   /**
+    * take - returns the stats since the last call, monitor
+    * only, the owner's words are left alone.
+    * @return  Blocked
+    */
+   Blocked take()
+   {
+      const auto now_count  ( count.load( std::memory_order_relaxed ) );
+      const auto now_blocked( blocked.load( std::memory_order_relaxed ) );
+      Blocked copy;
+      copy.count   = static_cast< std::uint32_t >( now_count - seen_count );
+      copy.blocked = ( now_blocked != seen_blocked ? 1 : 0 );
+      seen_count   = now_count;
+      seen_blocked = now_blocked;
+      return( copy );
+   }
+
+private:
+   /** written by the owning end only **/
+   std::atomic< std::uint64_t > count;
+   std::atomic< std::uint64_t > blocked;
+   /** what the monitor saw last, touched by take() only **/
+   std::uint64_t                seen_count   = 0;
+   std::uint64_t                seen_blocked = 0;
+};
+
 #endif /* END _BLOCKED_HPP_ */
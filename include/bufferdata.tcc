@@ -23,14 +23,20 @@
 #include <cstring>
 #include <cassert>
 #include <thread>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <iostream>
 
-#ifdef __USE_SHM__
 #include "shm.hpp"
-#endif
-
 #include "signalvars.hpp"
+#include "fifoarena.hpp"
+#include "placement.hpp"
 #include "pointer.hpp"
 #include "ringbuffertypes.hpp"
+#include "signalqueue.hpp"
 
 
 namespace Buffer
@@ -41,27 +47,35 @@ namespace Buffer
  * a ``signal'' to enable synchronous signaling
  * that is element aligned.  The send_signal()
  * function enables asynchronous signaling with
- * the same signal type (RBSignal).
+ * the same signal type (RBSignal).  For the 
+ * Split and SignalFree layouts the element is 
+ * just the item, for Interleaved see below.
+ *
+ * The item is raw storage, neither the constructor nor
+ * the destructor touch it.  It is constructed in place
+ * when pushed and destroyed when popped, so X needn't be
+ * default constructible and nothing is built up front 
+ * for an empty slot.
  */
-template < class X > struct Element
+template < class X, 
+           Layout::SlotLayout L = Layout::Split > struct Element
 {
-   /** default constructor **/
+   /** default constructor, leaves item unconstructed **/
    Element()
    {
    }
-   /**
-    * Element - copy constructor, the type
-    * X must have a defined assignment operator.
-    * This is simple for primitive types, but
-    * probably must be defined for objects,
-    * structs and more complex types.
-    */
-   Element( const Element< X > &other )
+
+   ~Element()
    {
-      (this)->item   = other.item;
    }
 
-   X item;
+   Element( const Element< X, L > &other ) = delete;
+   Element& operator = ( const Element< X, L > &other ) = delete;
+
+   union
+   {
+      X item;
+   };
 };
 
 struct Signal
@@ -70,12 +84,244 @@ struct Signal
    {
    }
 
-   Signal( const Signal &other )
+   /** 
+    * left with the default copy so that ranges of signals
+    * can be moved with memcpy, see static_assert below.
+    */
+   RBSignal sig;
+};
+
+static_assert( sizeof( Signal ) == sizeof( RBSignal ) &&
+               std::is_trivially_copyable< Signal >::value,
+               "Signal must stay layout compatible with RBSignal" );
+
+/**
+ * Element - Interleaved layout, the signal sits right 
+ * behind the item so that a push or pop touches a single
+ * slot instead of a slot in each of two arrays.
+ */
+template < class X > struct Element< X, Layout::Interleaved >
+{
+   Element()
+   {
+   }
+
+   ~Element()
    {
-      (this)->sig = other.sig;
    }
+   
+   Element( const Element< X, Layout::Interleaved > &other ) = delete;
+   Element& operator = ( const Element< X, Layout::Interleaved > &other ) = delete;
 
-   RBSignal sig;
+   union
+   {
+      X   item;
+   };
+   Signal signal;
+};
+
+/**
+ * copy_construct - copy constructs src into the raw slot at
+ * dst.  Move only types can still be queued with push( T&& )
+ * and emplace, the copying paths are compiled for every type
+ * (they're virtual) so for those they're a run time error.
+ * @param   dst - X*, raw storage
+ * @param   src - const X&
+ */
+template < class X > void copy_construct( X *dst, const X &src, std::true_type )
+{
+   new ( dst ) X( src );
+}
+
+template < class X > void copy_construct( X *dst, const X &src, std::false_type )
+{
+   std::cerr << "attempt to copy a move only type into a FIFO, use push( T&& )\n";
+   exit( EXIT_FAILURE );
+}
+
+template < class X > void copy_construct( X *dst, const X &src )
+{
+   copy_construct( dst, src, std::is_copy_constructible< X >() );
+}
+
+/**
+ * copy_assign - same as copy_construct for a live dst.
+ * @param   dst - X&
+ * @param   src - const X&
+ */
+template < class X > void copy_assign( X &dst, const X &src, std::true_type )
+{
+   dst = src;
+}
+
+template < class X > void copy_assign( X &dst, const X &src, std::false_type )
+{
+   std::cerr << "attempt to copy a move only type out of a FIFO\n";
+   exit( EXIT_FAILURE );
+}
+
+template < class X > void copy_assign( X &dst, const X &src )
+{
+   copy_assign( dst, src, std::is_copy_assignable< X >() );
+}
+
+/**
+ * SignalAccess - reads and writes the per element signals
+ * for each layout, everything is resolved at compile time.
+ * The caller guarantees no run crosses the end of the buffer.
+ */
+template < Layout::SlotLayout L > struct SignalAccess
+{
+   template < class E > static RBSignal read( const E *store,
+                                              const Signal *signal,
+                                              const size_t index )
+   {
+      return( signal[ index ].sig );
+   }
+
+   template < class E > static void write( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const RBSignal sig )
+   {
+      signal[ index ].sig = sig;
+   }
+
+   template < class E > static void clear( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const size_t n )
+   {
+      static_assert( RBSignal::NONE == 0, "clear assumes NONE is zero" );
+      std::memset( (void*) &signal[ index ], 0, n * sizeof( Signal ) );
+   }
+
+   template < class E > static void copy( RBSignal *dst,
+                                          const E *store,
+                                          const Signal *signal,
+                                          const size_t index,
+                                          const size_t n )
+   {
+      std::memcpy( dst, &signal[ index ], n * sizeof( Signal ) );
+   }
+
+   template < class E > static size_t find( const E *store,
+                                            const Signal *signal,
+                                            const size_t index,
+                                            const size_t n )
+   {
+      return( Signals::find( reinterpret_cast< const RBSignal* >( &signal[ index ] ), n ) );
+   }
+};
+
+template <> struct SignalAccess< Layout::Interleaved >
+{
+   template < class E > static RBSignal read( const E *store,
+                                              const Signal *signal,
+                                              const size_t index )
+   {
+      return( store[ index ].signal.sig );
+   }
+
+   template < class E > static void write( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const RBSignal sig )
+   {
+      store[ index ].signal.sig = sig;
+   }
+
+   template < class E > static void clear( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const size_t n )
+   {
+      for( size_t i( index ); i < index + n; i++ )
+      {
+         store[ i ].signal.sig = RBSignal::NONE;
+      }
+   }
+
+   template < class E > static void copy( RBSignal *dst,
+                                          const E *store,
+                                          const Signal *signal,
+                                          const size_t index,
+                                          const size_t n )
+   {
+      for( size_t i( 0 ); i < n; i++ )
+      {
+         dst[ i ] = store[ index + i ].signal.sig;
+      }
+   }
+
+   /** one per slot, nothing to vectorize over **/
+   template < class E > static size_t find( const E *store,
+                                            const Signal *signal,
+                                            const size_t index,
+                                            const size_t n )
+   {
+      for( size_t i( 0 ); i < n; i++ )
+      {
+         if( store[ index + i ].signal.sig != RBSignal::NONE )
+         {
+            return( i );
+         }
+      }
+      return( n );
+   }
+};
+
+template <> struct SignalAccess< Layout::SignalFree >
+{
+   template < class E > static RBSignal read( const E *store,
+                                              const Signal *signal,
+                                              const size_t index )
+   {
+      return( RBSignal::NONE );
+   }
+
+   template < class E > static void write( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const RBSignal sig )
+   {
+      /** there is nowhere to put it, don't lose an EOF silently **/
+      if( sig != RBSignal::NONE )
+      {
+         std::cerr << "Signal pushed to a queue with the SignalFree layout, "
+                      "use another layout to carry signals, exiting.\n";
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   template < class E > static void clear( E *store,
+                                           Signal *signal,
+                                           const size_t index,
+                                           const size_t n )
+   {
+   }
+
+   template < class E > static void copy( RBSignal *dst,
+                                          const E *store,
+                                          const Signal *signal,
+                                          const size_t index,
+                                          const size_t n )
+   {
+      std::fill( dst, dst + n, RBSignal::NONE );
+   }
+
+   template < class E > static size_t find( const E *store,
+                                            const Signal *signal,
+                                            const size_t index,
+                                            const size_t n )
+   {
+      return( n );
+   }
+};
+
+/** Sparse keeps no signals in the slots, see DataBase **/
+template <> struct SignalAccess< Layout::Sparse > : public SignalAccess< Layout::SignalFree >
+{
 };
 
 /**
@@ -83,17 +329,288 @@ struct Signal
  * conjure up a relational database, but it is
  * literally the base for the Data structs below.
  */
-template < class T > struct DataBase 
+template < class T, 
+           Layout::SlotLayout L = Layout::Split > struct DataBase 
 {
+   using element_t = Element< T, L >;
+   using signal_t  = SignalAccess< L >;
+   
+   /** 
+    * true if the items sit back to back in the store so
+    * that a run of them can be copied in one go
+    */
+   static constexpr bool contiguous = ( sizeof( element_t ) == sizeof( T ) );
+
    DataBase( const size_t max_cap ) : read_pt ( nullptr ),
                                       write_pt( nullptr ),
                                       max_cap ( max_cap ),
                                       store   ( nullptr ),
-                                      signal  ( nullptr )
+                                      signal  ( nullptr ),
+                                      next    ( nullptr ),
+                                      released( false ),
+                                      sparse  ( L == Layout::Sparse ? 
+                                                   new Signals::Sparse( max_cap ) : nullptr ),
+                                      arena   ( nullptr )
    {
 
-      length_store   = ( sizeof( Element< T > ) * max_cap ); 
-      length_signal  = ( sizeof( Signal ) * max_cap );
+      length_store   = ( sizeof( element_t ) * max_cap ); 
+      length_signal  = ( L == Layout::Split ? sizeof( Signal ) * max_cap : 0 );
+   }
+
+   /**
+    * DataBase - as above with the sparse signals carved out
+    * of arena, see FIFOArena.
+    * @param   max_cap - const size_t
+    * @param   arena   - FIFOArena&
+    */
+   DataBase( const size_t max_cap, FIFOArena &arena ) : 
+      read_pt ( nullptr ),
+      write_pt( nullptr ),
+      max_cap ( max_cap ),
+      store   ( nullptr ),
+      signal  ( nullptr ),
+      next    ( nullptr ),
+      released( false ),
+      sparse  ( L == Layout::Sparse ? 
+                   new ( arena.allocate( sizeof( Signals::Sparse ) ) ) 
+                      Signals::Sparse( max_cap, 
+                                       arena.allocate( Signals::Sparse::storage_bytes( max_cap ) ) ) : 
+                   nullptr ),
+      arena   ( &arena )
+   {
+      length_store   = ( sizeof( element_t ) * max_cap ); 
+      length_signal  = ( L == Layout::Split ? sizeof( Signal ) * max_cap : 0 );
+   }
+
+   ~DataBase()
+   {
+      if( arena == nullptr )
+      {
+         delete( sparse );
+      }
+      else if( sparse != nullptr )
+      {
+         sparse->~Sparse();
+      }
+   }
+
+   /**
+    * arena_bytes - what the DataBase part of a buffer of 
+    * max_cap takes from a FIFOArena, rounded to cache lines.
+    * @param   max_cap - const size_t
+    * @return  size_t
+    */
+   static size_t arena_bytes( const size_t max_cap )
+   {
+      return( L == Layout::Sparse ? 
+                 line_round( sizeof( Signals::Sparse ) ) +
+                    line_round( Signals::Sparse::storage_bytes( max_cap ) ) :
+                 0 );
+   }
+
+   static size_t line_round( const size_t length )
+   {
+      return( ( ( length + L1D_CACHE_LINE_SIZE - 1 ) / L1D_CACHE_LINE_SIZE ) * 
+                 L1D_CACHE_LINE_SIZE );
+   }
+
+   DataBase( const DataBase& ) = delete;
+   DataBase& operator = ( const DataBase& ) = delete;
+
+   /**
+    * read_signal - returns the signal for the element 
+    * at index regardless of layout.
+    * @param   index - const size_t
+    * @return  RBSignal
+    */
+   RBSignal read_signal( const size_t index ) const
+   {
+      if( L == Layout::Sparse )
+      {
+         return( sparse->read( position_of( read_pt, index ), read_pt ) );
+      }
+      return( signal_t::read( store, signal, index ) );
+   }
+
+   /**
+    * write_signal - sets the signal for the element at
+    * index regardless of layout.
+    * @param   index - const size_t
+    * @param   sig   - const RBSignal
+    */
+   void write_signal( const size_t index, const RBSignal sig )
+   {
+      if( L == Layout::Sparse )
+      {
+         if( sig != RBSignal::NONE )
+         {
+            sparse->write( position_of( write_pt, index ), sig );
+         }
+         return;
+      }
+      signal_t::write( store, signal, index, sig );
+   }
+
+   /**
+    * clear_signals - sets n signals starting at index to
+    * RBSignal::NONE, run must not cross the end of the buffer.
+    * @param   index - const size_t
+    * @param   n     - const size_t
+    */
+   void clear_signals( const size_t index, const size_t n )
+   {
+      signal_t::clear( store, signal, index, n );
+   }
+
+   /**
+    * copy_signals - copies n signals starting at index to
+    * dst, run must not cross the end of the buffer.
+    * @param   dst   - RBSignal*
+    * @param   index - const size_t
+    * @param   n     - const size_t
+    */
+   void copy_signals( RBSignal *dst, const size_t index, const size_t n ) const
+   {
+      if( L == Layout::Sparse )
+      {
+         sparse->copy( dst, position_of( read_pt, index ), n, read_pt );
+         return;
+      }
+      signal_t::copy( dst, store, signal, index, n );
+   }
+
+   /**
+    * find_signal - consumer, offset from index of the first
+    * of the n elements there that carries a signal, n if none
+    * do, run must not cross the end of the buffer.
+    * @param   index - const size_t
+    * @param   n     - const size_t
+    * @return  size_t
+    */
+   size_t find_signal( const size_t index, const size_t n ) const
+   {
+      if( L == Layout::Sparse )
+      {
+         return( sparse->find( position_of( read_pt, index ), n, read_pt ) );
+      }
+      return( signal_t::find( store, signal, index, n ) );
+   }
+
+   /**
+    * retire_signals - consumer, called before the read pointer
+    * moves on by n, only the Sparse layout has anything to do.
+    * @param   n - const size_t
+    * @return  bool, true if one of the n carried RBSignal::RBEOF
+    */
+   bool retire_signals( const size_t n )
+   {
+      if( L == Layout::Sparse )
+      {
+         return( sparse->retire( Pointer::position( read_pt ) + n, read_pt ) );
+      }
+      return( false );
+   }
+
+   /**
+    * position_of - monotonic position of the slot at index
+    * within the window starting at the position of ptr, 
+    * only valid on the side owning ptr.
+    * @param   ptr   - Pointer*
+    * @param   index - const size_t
+    * @return  std::uint64_t
+    */
+   std::uint64_t position_of( Pointer *ptr, const size_t index ) const
+   {
+      const auto base( Pointer::position( ptr ) );
+      return( base + ( index + max_cap - base % max_cap ) % max_cap );
+   }
+
+   /**
+    * destroy - ends the lifetime of n items starting at 
+    * index, run must not cross the end of the buffer.  Does
+    * nothing for trivially destructible types.
+    * @param   index - const size_t
+    * @param   n     - const size_t
+    */
+   void destroy( const size_t index, const size_t n )
+   {
+      if( std::is_trivially_destructible< T >::value )
+      {
+         return;
+      }
+      for( size_t i( index ); i < index + n; i++ )
+      {
+         store[ i ].item.~T();
+      }
+   }
+
+   /**
+    * destroy_items - ends the lifetime of every item still 
+    * in the buffer, called when the buffer is freed.
+    */
+   void destroy_items()
+   {
+      if( std::is_trivially_destructible< T >::value )
+      {
+         return;
+      }
+      const auto end( Pointer::position( write_pt ) );
+      for( auto pos( Pointer::position( read_pt ) ); pos < end; pos++ )
+      {
+         store[ pos % max_cap ].item.~T();
+      }
+   }
+
+   /**
+    * new_pointer - allocates a Pointer on its own cache
+    * line(s) so that the read and write pointers never
+    * false share, plain new won't honor the alignment
+    * of Pointer prior to C++17.
+    * @param   max_cap - const size_t
+    * @return  Pointer*
+    */
+   static Pointer* new_pointer( const size_t max_cap, 
+                                const int node = Placement::Any )
+   {
+      void *mem( nullptr );
+      /** placed pointers get a page each, mbind can't do less **/
+      const size_t length( node == Placement::Any ? 
+                              sizeof( Pointer ) : 
+                              page_round( sizeof( Pointer ) ) );
+      const int ret_val( posix_memalign( &mem, 
+                                         ( node == Placement::Any ? 
+                                              L1D_CACHE_LINE_SIZE : 
+                                              Placement::page_size() ),
+                                         length ) );
+      if( ret_val != 0 )
+      {
+         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+         exit( EXIT_FAILURE );
+      }
+      Placement::bind( mem, length, node );
+      return( new ( mem ) Pointer( max_cap ) );
+   }
+
+   /** length rounded up to whole pages **/
+   static size_t page_round( const size_t length )
+   {
+      const auto page( Placement::page_size() );
+      return( ( ( length + page - 1 ) / page ) * page );
+   }
+
+   /**
+    * delete_pointer - counterpart to new_pointer.
+    * @param   ptr - Pointer*
+    */
+   static void delete_pointer( Pointer *ptr )
+   {
+      if( ptr == nullptr )
+      {
+         return;
+      }
+      ptr->~Pointer();
+      free( ptr );
    }
 
    Pointer           *read_pt;
@@ -108,222 +625,566 @@ template < class T > struct DataBase
     * be a case for adding items in the store
     * as well.
     */
-   Element< T >      *store;
+   element_t         *store;
+   /** only allocated for the Split layout **/
    Signal            *signal;
    size_t             length_store;
    size_t             length_signal;
+   /** 
+    * set by the producer when it moves on to a resized
+    * buffer, the consumer follows it once this one is 
+    * drained and frees this one once released is set.
+    */
+   std::atomic< DataBase* >   next;
+   std::atomic< bool >        released;
+   /** only allocated for the Sparse layout **/
+   Signals::Sparse           *sparse;
+   /** where everything came from, null for the heap **/
+   FIFOArena                 *arena;
+};
+
+/**
+ * InlineStore - slots, signals and both pointers for a heap 
+ * buffer whose capacity SIZE is fixed at compile time, all 
+ * in the one allocation as the Data that holds it.  Over 
+ * aligned, so it brings its own operator new (plain new 
+ * won't honor the alignment prior to C++17).  Empty when 
+ * SIZE is zero, the capacity is then set at run time.
+ */
+template < class T, 
+           Layout::SlotLayout L, 
+           size_t SIZE > struct InlineStore
+{
+   static_assert( ( SIZE & ( SIZE - 1 ) ) == 0, 
+                  "a fixed capacity must be a power of two" );
+
+   InlineStore() : inline_read ( SIZE ),
+                   inline_write( SIZE )
+   {
+   }
+
+   static void* operator new( const size_t length )
+   {
+      void *mem( nullptr );
+      const int ret_val( posix_memalign( &mem, 
+                                         alignof( InlineStore ), 
+                                         length ) );
+      if( ret_val != 0 )
+      {
+         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+         exit( EXIT_FAILURE );
+      }
+      return( mem );
+   }
+
+   static void operator delete( void *ptr )
+   {
+      free( ptr );
+   }
+
+   Pointer                                      inline_read;
+   Pointer                                      inline_write;
+   alignas( L1D_CACHE_LINE_SIZE ) Element< T, L > inline_store [ SIZE ];
+   /** one unused signal for the layouts that keep none apart **/
+   alignas( L1D_CACHE_LINE_SIZE ) Signal          inline_signal[ L == Layout::Split ? SIZE : 1 ];
+};
+
+template < class T, Layout::SlotLayout L > struct InlineStore< T, L, 0 >
+{
 };
 
 template < class T, 
            Type::RingBufferType B = Type::Heap, 
-           size_t SIZE = 0 > struct Data : public DataBase< T >
+           Layout::SlotLayout L = Layout::Split,
+           size_t SIZE = 0 > struct Data : public DataBase< T, L >,
+                                           public InlineStore< T, L, SIZE >
 {
 
+   /**
+    * Data - heap buffer of max_cap items, the store is
+    * aligned to align.  If SIZE is set max_cap must equal it
+    * and everything lives inline, aligned to a cache line.
+    * @param   max_cap   - size_t
+    * @param   align     - const size_t, default 16
+    * @param   placement - const Placement::Options&, resolved,
+    *                      run time capacity only
+    */
+   Data( size_t max_cap , 
+         const size_t align = 16,
+         const Placement::Options &placement = Placement::Options() ) : 
+      DataBase< T, L >( max_cap ),
+      alignment( align ),
+      placement( placement )
+   {
+      assert( SIZE == 0 || max_cap == SIZE );
+      assert( SIZE == 0 || ! placement.placed() );
+      allocate( std::integral_constant< bool, SIZE != 0 >() );
+   }
+
+   /**
+    * Data - heap buffer with the slots, signals and indices
+    * carved out of arena, each on its own cache line(s).  Use
+    * make() so the Data itself comes from the arena as well 
+    * and Buffer::release() to get rid of it.
+    * @param   max_cap - size_t
+    * @param   align   - const size_t
+    * @param   arena   - FIFOArena&
+    */
+   Data( size_t max_cap, const size_t align, FIFOArena &arena ) : 
+      DataBase< T, L >( max_cap, arena ),
+      alignment( align ),
+      placement()
+   {
+      static_assert( SIZE == 0, "the arena is for run time capacities" );
+      (this)->store = reinterpret_cast< Element< T, L >* >( 
+         arena.allocate( (this)->length_store, std::max< size_t >( align, L1D_CACHE_LINE_SIZE ) ) );
+      if( (this)->length_signal > 0 )
+      {
+         (this)->signal = reinterpret_cast< Signal* >( 
+            arena.allocate( (this)->length_signal ) );
+         std::memset( (void*) (this)->signal, 0, (this)->length_signal );
+      }
+      else
+      {
+         (this)->clear_signals( 0, max_cap );
+      }
+      (this)->read_pt  = new ( arena.allocate( sizeof( Pointer ) ) ) Pointer( max_cap );
+      (this)->write_pt = new ( arena.allocate( sizeof( Pointer ) ) ) Pointer( max_cap );
+   }
+
+   /**
+    * make - a Data of max_cap items entirely within arena.
+    * @param   max_cap - const size_t
+    * @param   align   - const size_t
+    * @param   arena   - FIFOArena&
+    * @return  Data*
+    */
+   static Data* make( const size_t max_cap, const size_t align, FIFOArena &arena )
+   {
+      void *mem( arena.allocate( sizeof( Data ), 
+                                 std::max< size_t >( alignof( Data ), L1D_CACHE_LINE_SIZE ) ) );
+      return( new ( mem ) Data( max_cap, align, arena ) );
+   }
+
+   /**
+    * arena_bytes - what make() takes from an arena for
+    * max_cap items, worst case alignment included.
+    * @param   max_cap - const size_t
+    * @param   align   - const size_t, default 16
+    * @return  size_t
+    */
+   static size_t arena_bytes( const size_t max_cap, const size_t align = 16 )
+   {
+      const size_t store_align( std::max< size_t >( align, L1D_CACHE_LINE_SIZE ) );
+      return( DataBase< T, L >::line_round( sizeof( Data ) + alignof( Data ) - 1 ) +
+              DataBase< T, L >::line_round( sizeof( Element< T, L > ) * max_cap + store_align - 1 ) +
+              ( L == Layout::Split ? 
+                   DataBase< T, L >::line_round( sizeof( Signal ) * max_cap ) : 0 ) +
+              2 * DataBase< T, L >::line_round( sizeof( Pointer ) ) +
+              DataBase< T, L >::arena_bytes( max_cap ) );
+   }
+
+
+   ~Data()
+   {
+      (this)->destroy_items();
+      deallocate( std::integral_constant< bool, SIZE != 0 >() );
+   }
 
-   Data( size_t max_cap , const size_t align = 16 ) : DataBase< T >( max_cap )
+   /** kept so a resized buffer gets the same alignment **/
+   const size_t alignment;
+   /** and lands on the same nodes **/
+   const Placement::Options placement;
+
+private:
+   void allocate( std::false_type /** capacity set at run time **/ )
    {
+      const auto max_cap( (this)->max_cap );
+      const bool placed( placement.store != Placement::Any );
+      /** mbind works on whole pages, bound before the first touch **/
+      const size_t store_bytes( placed ? 
+                                   DataBase< T, L >::page_round( (this)->length_store ) : 
+                                   (this)->length_store );
       int ret_val( posix_memalign( (void**)&((this)->store), 
-                                   align, 
-                                   (this)->length_store ) );
+                                   ( placed ? 
+                                        std::max( alignment, Placement::page_size() ) : 
+                                        alignment ), 
+                                   store_bytes ) );
       if( ret_val != 0 )
       {
          std::cerr << "posix_memalign returned error code (" << ret_val << ")";
          std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
          exit( EXIT_FAILURE );
       }
+      if( placed )
+      {
+         Placement::bind( (this)->store, store_bytes, placement.store );
+      }
+      if( placement.prefault )
+      {
+         Placement::prefault( (this)->store, (this)->length_store );
+      }
       
-      errno = 0;
-      (this)->signal = (Signal*)       calloc( (this)->length_signal,
-                                               sizeof( Signal ) );
-      if( (this)->signal == nullptr )
+      if( (this)->length_signal > 0 && placed )
       {
-         perror( "Failed to allocate signal queue!" );
-         exit( EXIT_FAILURE );
+         const size_t signal_bytes( DataBase< T, L >::page_round( (this)->length_signal ) );
+         ret_val = posix_memalign( (void**)&((this)->signal), 
+                                   Placement::page_size(), 
+                                   signal_bytes );
+         if( ret_val != 0 )
+         {
+            std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+            std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+            exit( EXIT_FAILURE );
+         }
+         Placement::bind( (this)->signal, signal_bytes, placement.store );
+         std::memset( (void*) (this)->signal, 0, (this)->length_signal );
       }
-      /** allocate read and write pointers **/
-      /** TODO, see if there are optimizations to be made with sizing and alignment **/
-      (this)->read_pt   = new Pointer( max_cap );
-      (this)->write_pt  = new Pointer( max_cap ); 
+      else if( (this)->length_signal > 0 )
+      {
+         errno = 0;
+         (this)->signal = (Signal*)       calloc( max_cap,
+                                                  sizeof( Signal ) );
+         if( (this)->signal == nullptr )
+         {
+            perror( "Failed to allocate signal queue!" );
+            exit( EXIT_FAILURE );
+         }
+         if( placement.prefault )
+         {
+            /** calloc may hand back untouched zero pages **/
+            Placement::prefault( (this)->signal, (this)->length_signal );
+         }
+      }
+      else
+      {
+         /** signals live in the store, or nowhere at all **/
+         (this)->clear_signals( 0, max_cap );
+      }
+      /** 
+       * allocate read and write pointers, each on its own line,
+       * or its own page on the node of the end that writes it
+       */
+      (this)->read_pt   = DataBase< T, L >::new_pointer( max_cap, placement.read );
+      (this)->write_pt  = DataBase< T, L >::new_pointer( max_cap, placement.write ); 
    }
 
+   void allocate( std::true_type /** inline, see InlineStore **/ )
+   {
+      (this)->store     = (this)->inline_store;
+      (this)->read_pt   = &(this)->inline_read;
+      (this)->write_pt  = &(this)->inline_write;
+      if( (this)->length_signal > 0 )
+      {
+         (this)->signal = (this)->inline_signal;
+      }
+      else
+      {
+         (this)->clear_signals( 0, SIZE );
+      }
+   }
 
-   ~Data()
+   void deallocate( std::false_type )
    {
-      //DELETE USED HERE
-      delete( (this)->read_pt );
-      delete( (this)->write_pt );
+      if( (this)->arena != nullptr )
+      {
+         /** the memory goes with the arena **/
+         (this)->read_pt->~Pointer();
+         (this)->write_pt->~Pointer();
+         return;
+      }
+      DataBase< T, L >::delete_pointer( (this)->read_pt );
+      DataBase< T, L >::delete_pointer( (this)->write_pt );
 
       //FREE USED HERE
-      std::memset( (this)->store, 0, ( sizeof( Element< T > ) * (this)->max_cap ) );
+      std::memset( (void*) (this)->store, 0, (this)->length_store );
       free( (this)->store );
-      std::memset( (this)->signal, 0, ( sizeof( Signal ) * (this)->max_cap ) );
-      free( (this)->signal );
+      if( (this)->signal != nullptr )
+      {
+         std::memset( (void*) (this)->signal, 0, (this)->length_signal );
+         free( (this)->signal );
+      }
+   }
+
+   void deallocate( std::true_type )
+   {
+      /** goes with the object **/
    }
 }; /** end heap **/
 
-#ifdef __USE_SHM__
-template < class T > struct Data< T, Type::SharedMemory > : 
-   public DataBase< T > 
+/**
+ * release - deletes buff, or just destroys it if it was
+ * made in a FIFOArena, the arena gives the memory back.
+ * @param   buff - D*, any of the DataBase derived buffers
+ */
+template < class D > void release( D *buff )
+{
+   if( buff == nullptr )
+   {
+      return;
+   }
+   if( buff->arena != nullptr )
+   {
+      buff->~D();
+   }
+   else
+   {
+      delete( buff );
+   }
+}
+
+/**
+ * Handle - the producer's current buffer.  Only the producer
+ * moves it (see RingBufferBase::resize) but either end may
+ * follow it, so it is atomic while still reading like a
+ * plain pointer, the loads are free on x86.
+ */
+template < class D > class Handle
+{
+public:
+   Handle( D *ptr = nullptr ) : ptr( ptr )
+   {
+   }
+
+   Handle& operator = ( D *other )
+   {
+      ptr.store( other, std::memory_order_release );
+      return( *this );
+   }
+
+   D* operator -> () const
+   {
+      return( ptr.load( std::memory_order_acquire ) );
+   }
+
+   operator D* () const
+   {
+      return( ptr.load( std::memory_order_acquire ) );
+   }
+
+private:
+   std::atomic< D* > ptr;
+};
+
+/**
+ * Slot - element type for the multi producer and/or multi 
+ * consumer buffers (MPSC, SPMC, MPMC).  seq says whose turn 
+ * it is, the slot is free for the producer at position p 
+ * when seq == p, holds an item for the consumer at p when
+ * seq == p + 1, and is handed back for p + max_cap once it
+ * has been read.  skip marks a slot a producer reserved but
+ * never filled, consumers step over it.  As with Element
+ * the item is raw storage, live only while the slot holds
+ * an item that isn't skipped.
+ */
+template < class X > struct Slot
+{
+   std::atomic< std::uint64_t >  seq;
+   RBSignal                      signal;
+   bool                          skip;
+   union
+   {
+      X                          item;
+   };
+};
+
+/**
+ * MultiData - store for the MPSC, SPMC and MPMC buffers.  The
+ * enqueue and dequeue positions each get their own cache line
+ * at the front of the same allocation as the slots.  read_pt
+ * and write_pt are only used to park and wake blocked threads,
+ * their positions never move.
+ */
+template < class T > struct MultiData
+{
+   using slot_t = Slot< T >;
+
+   MultiData( const size_t max_cap, 
+              const size_t align = 16 ) : read_pt ( nullptr ),
+                                          write_pt( nullptr ),
+                                          max_cap ( max_cap ),
+                                          slots   ( nullptr ),
+                                          length_store( sizeof( slot_t ) * max_cap ),
+                                          block   ( nullptr )
+   {
+      const size_t header( std::max< size_t >( 2 * L1D_CACHE_LINE_SIZE, align ) );
+      int ret_val( posix_memalign( &block, 
+                                   std::max< size_t >( L1D_CACHE_LINE_SIZE, align ), 
+                                   header + length_store ) );
+      if( ret_val != 0 )
+      {
+         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+         exit( EXIT_FAILURE );
+      }
+      auto *base( reinterpret_cast< char* >( block ) );
+      enqueue_pos = new ( base ) std::atomic< std::uint64_t >( 0 );
+      dequeue_pos = new ( base + L1D_CACHE_LINE_SIZE ) std::atomic< std::uint64_t >( 0 );
+      slots       = reinterpret_cast< slot_t* >( base + header );
+      for( size_t i( 0 ); i < max_cap; i++ )
+      {
+         new ( &slots[ i ].seq ) std::atomic< std::uint64_t >( i );
+         slots[ i ].signal = RBSignal::NONE;
+         slots[ i ].skip   = false;
+      }
+      read_pt  = DataBase< T >::new_pointer( max_cap );
+      write_pt = DataBase< T >::new_pointer( max_cap );
+   }
+
+   ~MultiData()
+   {
+      if( ! std::is_trivially_destructible< T >::value )
+      {
+         /** whatever was pushed and never popped **/
+         const auto end( enqueue_pos->load( std::memory_order_acquire ) );
+         for( auto pos( dequeue_pos->load( std::memory_order_acquire ) ); pos < end; pos++ )
+         {
+            auto &s( slot( pos ) );
+            if( s.seq.load( std::memory_order_acquire ) == pos + 1 && ! s.skip )
+            {
+               s.item.~T();
+            }
+         }
+      }
+      DataBase< T >::delete_pointer( read_pt );
+      DataBase< T >::delete_pointer( write_pt );
+      free( block );
+   }
+
+   /**
+    * slot - returns the slot for the monotonic position pos.
+    * @param   pos - const std::uint64_t
+    * @return  slot_t&
+    */
+   slot_t& slot( const std::uint64_t pos )
+   {
+      return( slots[ pos % max_cap ] );
+   }
+
+   std::atomic< std::uint64_t > *enqueue_pos;
+   std::atomic< std::uint64_t > *dequeue_pos;
+   /** consumers wake read_pt after freeing a slot **/
+   Pointer                      *read_pt;
+   /** producers wake write_pt after filling a slot **/
+   Pointer                      *write_pt;
+   size_t                        max_cap;
+   slot_t                       *slots;
+   size_t                        length_store;
+   void                         *block;
+};
+
+/** MPSC, SPMC and MPMC all share the slot store, layout is ignored **/
+template < class T, Layout::SlotLayout L, size_t SIZE > 
+   struct Data< T, Type::MPSC, L, SIZE > : public MultiData< T >
+{
+   Data( const size_t max_cap, const size_t align = 16 ) : 
+      MultiData< T >( max_cap, align ){}
+};
+
+template < class T, Layout::SlotLayout L, size_t SIZE > 
+   struct Data< T, Type::SPMC, L, SIZE > : public MultiData< T >
+{
+   Data( const size_t max_cap, const size_t align = 16 ) : 
+      MultiData< T >( max_cap, align ){}
+};
+
+template < class T, Layout::SlotLayout L, size_t SIZE > 
+   struct Data< T, Type::MPMC, L, SIZE > : public MultiData< T >
+{
+   Data( const size_t max_cap, const size_t align = 16 ) : 
+      MultiData< T >( max_cap, align ){}
+};
+
+template < class T, Layout::SlotLayout L > struct Data< T, Type::SharedMemory, L > : 
+   public DataBase< T, L > 
 {
    /**
-    * Data - Constructor for SHM based ringbuffer.  Allocates store, signal and 
-    * ptr structures in separate SHM segments.  Could have been a single one but
-    * makes reading the ptr arithmatic a bit more difficult.  TODO, reevaluate
-    * if performance wise that might be a good idea, also decide how best to 
-    * align data elements.
-    * @param   max_cap, size_t with number of items to allocate queue for
-    * @param   shm_key, const std::string key for opening the SHM, must be same for both ends of the queue
-    * @param   dir,     Direction enum for letting this queue know which side we're allocating
-    * @param   alignment, size_t with alignment NOTE: haven't implemented yet
+    * Data - Constructor for SHM based ringbuffer.  Header, read and write
+    * pointers, signals (Split layout only) and store all live in a single 
+    * segment, see shm.hpp.  The producer creates and lays out the segment,
+    * the consumer sleeps until it is ready and reads capacity and element
+    * size from the header so it may pass zero for max_cap.  Either end may
+    * be started first.
+    * @param   max_cap,    size_t with number of items to allocate queue for, 
+    *                      may be 0 for the consumer
+    * @param   shm_key,    const std::string key for opening the SHM, must be same for both ends of the queue
+    * @param   dir,        Direction enum for letting this queue know which side we're allocating
+    * @param   alignment,  size_t with alignment of the store
+    * @param   huge_pages, bool, back the segment with huge pages if possible
     */
    Data( size_t max_cap, 
          const std::string shm_key,
          Direction dir,
-         const size_t alignment ) : DataBase< T >( max_cap ),
-                                    store_key( shm_key + "_store" ),
-                                    signal_key( shm_key + "_key" ),
-                                    ptr_key( shm_key + "_ptr" )
+         const size_t alignment,
+         const bool huge_pages = false ) : DataBase< T, L >( max_cap ),
+                                           segment( shm_key )
    {
-      /** now work through opening SHM **/
-      switch( dir )
+      try
       {
-         case( Direction::Producer ):
+         switch( dir )
          {
-            auto alloc_with_error = 
-            [&]( void **ptr, const size_t length, const char *key )
+            case( Direction::Producer ):
             {
-               try
-               {
-                  *ptr = shm::init( key, length );
-               }catch( bad_shm_alloc &ex )
-               {
-                  std::cerr << 
-                  "Bad SHM allocate for key (" << 
-                     key << ") with length (" << length << ")\n";
-                  std::cerr << "Message: " << ex.what() << ", exiting.\n";
-                  exit( EXIT_FAILURE );
-               }
-               assert( *ptr != nullptr );
-            };
-            alloc_with_error( (void**)&(this)->store, 
-                              (this)->length_store, 
-                              store_key.c_str() );
-            alloc_with_error( (void**)&(this)->signal, 
-                              (this)->length_signal, 
-                              signal_key.c_str() );
-            alloc_with_error( (void**)&(this)->read_pt, 
-                              (sizeof( Pointer ) * 2 ) + sizeof( Cookie ), 
-                              ptr_key.c_str() );
-
-            (this)->write_pt = &(this)->read_pt[ 1 ];
-            
-            Pointer temp( max_cap );
-            std::memcpy( (this)->read_pt,  &temp, sizeof( Pointer ) );
-            std::memcpy( (this)->write_pt, &temp, sizeof( Pointer ) );
-            
-            (this)->cookie   = (Cookie*) &(this)->read_pt[ 2 ];
-            (this)->cookie->producer = 0x1337;
-            while( (this)->cookie->consumer != 0x1337 )
-            {
-               std::this_thread::yield();
+               segment.create( SHM::make_geometry( max_cap, 
+                                                   sizeof( typename DataBase< T, L >::element_t ),
+                                                   ( (this)->length_signal > 0 ? sizeof( Signal ) : 0 ),
+                                                   L,
+                                                   alignment,
+                                                   huge_pages ) );
+               const auto &g( segment.header().geometry );
+               (this)->read_pt  = new ( segment.at( g.read_offset  ) ) Pointer( max_cap );
+               (this)->write_pt = new ( segment.at( g.write_offset ) ) Pointer( max_cap );
+               /** freshly truncated so signals are already RBSignal::NONE **/
+               segment.ready();
             }
-         }
-         break;
-         case( Direction::Consumer ):
-         {
-            auto retry_func = [&]( void **ptr, const char *str )
+            break;
+            case( Direction::Consumer ):
             {
-               std::string error_copy;
-               int timeout( 1000 );
-               while( timeout-- )
+               segment.attach();
+               const auto &g( segment.header().geometry );
+               if( g.element_size != sizeof( typename DataBase< T, L >::element_t ) ||
+                   g.layout       != L ||
+                   ( max_cap != 0 && g.capacity != max_cap ) )
                {
-                  try
-                  {
-                     *ptr = shm::open( str );
-                  }
-                  catch( bad_shm_alloc &ex )
-                  {
-                     //do nothing
-                     timeout--;
-                     error_copy = ex.what();
-                     std::this_thread::yield();
-                     continue;
-                  }
-                  goto SUCCESS;
+                  throw bad_shm_alloc( "segment " + shm_key + 
+                     " doesn't match this queue, capacity (" + 
+                     std::to_string( g.capacity ) + ") element size (" +
+                     std::to_string( g.element_size ) + ")" );
                }
-               /** timeout reached **/
-               std::cerr << "Failed to open shared memory for \"" << 
-                  str << "\", exiting!!\n";
-               std::cerr << "Error message: " << error_copy << "\n";
-               exit( EXIT_FAILURE );
-               SUCCESS:;
-            };
-            retry_func( (void**) &(this)->store,  store_key.c_str() );
-            retry_func( (void**) &(this)->signal, signal_key.c_str() );
-            retry_func( (void**) &(this)->read_pt, ptr_key.c_str() );
-            
-            assert( (this)->store != nullptr );
-            assert( (this)->signal != nullptr );
-            assert( (this)->read_pt   != nullptr );
-            
-            /** fix write_pt **/
-            (this)->write_pt  = &(this)->read_pt[ 1 ];
-            assert( (this)->write_pt  != nullptr );
-            (this)->cookie    = (Cookie*)&(this)->read_pt[ 2 ]; 
-            
-            Pointer temp( max_cap );
-            std::memcpy( (this)->read_pt,  &temp, sizeof( Pointer ) );
-            std::memcpy( (this)->write_pt, &temp, sizeof( Pointer ) );
-            
-            (this)->cookie->consumer = 0x1337;
-            while( (this)->cookie->producer != 0x1337 )
+               (this)->max_cap       = g.capacity;
+               (this)->length_store  = g.store_length;
+               (this)->length_signal = g.signal_length;
+               (this)->read_pt  = reinterpret_cast< Pointer* >( segment.at( g.read_offset  ) );
+               (this)->write_pt = reinterpret_cast< Pointer* >( segment.at( g.write_offset ) );
+            }
+            break;
+            default:
             {
-               std::this_thread::yield();
+               //TODO, add signal handler to cleanup
+               std::cerr << "Invalid direction, exiting\n";
+               exit( EXIT_FAILURE );
             }
          }
-         break;
-         default:
-         {
-            //TODO, add signal handler to cleanup
-            std::cerr << "Invalid direction, exiting\n";
-            exit( EXIT_FAILURE );
-         }
       }
+      catch( bad_shm_alloc &ex )
+      {
+         std::cerr << "Bad SHM allocate for key (" << shm_key << ")\n";
+         std::cerr << "Message: " << ex.what() << ", exiting.\n";
+         exit( EXIT_FAILURE );
+      }
+      const auto &g( segment.header().geometry );
+      (this)->store  = 
+         reinterpret_cast< typename DataBase< T, L >::element_t* >( segment.at( g.store_offset ) );
+      (this)->signal = ( g.signal_length > 0 ? 
+         reinterpret_cast< Signal* >( segment.at( g.signal_offset ) ) : nullptr );
       /** should be all set now **/
    }
 
-   ~Data()
-   {
-      /** three segments of SHM to close **/
-      shm::close( store_key.c_str(), 
-                  (void*) (this)->store, 
-                  (this)->length_store,
-                  false,
-                  true );
-      shm::close( signal_key.c_str(),
-                  (void*) (this)->signal,
-                  (this)->length_signal,
-                  false,
-                  true );
-      shm::close( ptr_key.c_str(),   
-                  (void*) (this)->read_pt, 
-                  (sizeof( Pointer ) * 2) + sizeof( Cookie ),
-                  false,
-                  true );
-   }
-   struct Cookie
-   {
-      int32_t producer;
-      int32_t consumer;;
-   };
-
-   volatile Cookie         *cookie;
+   /** the segment unmaps itself, pointers are trivially destructible **/
+   ~Data() = default;
 
-   /** process local key copies **/
-   const std::string store_key; 
-   const std::string signal_key;  
-   const std::string ptr_key; 
+   SHM::Segment  segment;
 };
-#endif
 }
 #endif /* END _BUFFERDATA_TCC_ */
@@ -0,0 +1,126 @@
+/**
+ * bulkcopy.hpp - 
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 10:02:14 2026
+ * 
+ * Copyright 2014 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _BULKCOPY_HPP_
+#define _BULKCOPY_HPP_  1
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#if __cplusplus > 201703L
+#include <concepts>
+#endif
+
+#if __x86_64
+#include <emmintrin.h>
+#endif
+
+/**
+ * STREAMING_COPY_MIN_BYTES - copies at least this large are done
+ * with non-temporal stores on x86_64 so that they don't evict the
+ * rest of the cache, anything smaller goes through memcpy.  Set to
+ * zero at compile time to turn streaming stores off altogether.
+ */
+#ifndef STREAMING_COPY_MIN_BYTES
+#define STREAMING_COPY_MIN_BYTES ( 1 << 20 )
+#endif
+
+namespace Buffer
+{
+
+/**
+ * bulk_copy - copies bytes from src to dst, used for the range
+ * operations on trivially copyable types.  The regions must not
+ * overlap.
+ * @param   dst   - void*
+ * @param   src   - const void*
+ * @param   bytes - const std::size_t
+ */
+inline void bulk_copy( void *dst, const void *src, const std::size_t bytes )
+{
+#if __x86_64
+   if( STREAMING_COPY_MIN_BYTES > 0 && bytes >= STREAMING_COPY_MIN_BYTES )
+   {
+      auto *d( reinterpret_cast< std::uint8_t* >( dst ) );
+      auto *s( reinterpret_cast< const std::uint8_t* >( src ) );
+      std::size_t remaining( bytes );
+      /** get dst aligned for the streaming stores **/
+      const std::size_t head( ( 16 - ( reinterpret_cast< std::uintptr_t >( d ) & 15 ) ) & 15 );
+      std::memcpy( d, s, head );
+      d         += head;
+      s         += head;
+      remaining -= head;
+      while( remaining >= 64 )
+      {
+         const __m128i a( _mm_loadu_si128( reinterpret_cast< const __m128i* >( s      ) ) );
+         const __m128i b( _mm_loadu_si128( reinterpret_cast< const __m128i* >( s + 16 ) ) );
+         const __m128i c( _mm_loadu_si128( reinterpret_cast< const __m128i* >( s + 32 ) ) );
+         const __m128i e( _mm_loadu_si128( reinterpret_cast< const __m128i* >( s + 48 ) ) );
+         _mm_stream_si128( reinterpret_cast< __m128i* >( d      ), a );
+         _mm_stream_si128( reinterpret_cast< __m128i* >( d + 16 ), b );
+         _mm_stream_si128( reinterpret_cast< __m128i* >( d + 32 ), c );
+         _mm_stream_si128( reinterpret_cast< __m128i* >( d + 48 ), e );
+         d         += 64;
+         s         += 64;
+         remaining -= 64;
+      }
+      std::memcpy( d, s, remaining );
+      /** streaming stores are weakly ordered, fence before publishing **/
+      _mm_sfence();
+      return;
+   }
+#endif
+   std::memcpy( dst, src, bytes );
+}
+
+/**
+ * is_contiguous_iterator - true for iterators whose elements are
+ * known to be laid out back to back in memory, these can be 
+ * copied with bulk_copy instead of one element at a time.
+ */
+template < class iterator_type > struct is_contiguous_iterator : 
+   std::integral_constant< bool,
+      std::is_pointer< iterator_type >::value ||
+#if __cpp_lib_concepts
+      std::contiguous_iterator< iterator_type > ||
+#endif
+      std::is_same< iterator_type, 
+         typename std::vector< 
+            typename std::iterator_traits< iterator_type >::value_type >::iterator >::value ||
+      std::is_same< iterator_type, 
+         typename std::vector< 
+            typename std::iterator_traits< iterator_type >::value_type >::const_iterator >::value >
+{
+};
+
+/** std::vector< bool > is packed, never contiguous **/
+template <> struct is_contiguous_iterator< std::vector< bool >::iterator > : 
+   std::false_type
+{
+};
+
+template <> struct is_contiguous_iterator< std::vector< bool >::const_iterator > : 
+   std::false_type
+{
+};
+
+} /** end namespace Buffer **/
+#endif /* END _BULKCOPY_HPP_ */
@@ -19,16 +19,24 @@
  */
 #ifndef _FIFO_HPP_
 #define _FIFO_HPP_  1
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cstddef>
-#include <typeinfo>
 #include <iterator>
 #include <list>
+#include <new>
+#include <string>
+#include <utility>
 #include <vector>
-#include <map>
-#include <functional>
+#include <type_traits>
 
 #include "blocked.hpp"
+#include "notifier.hpp"
 #include "signalvars.hpp"
+#include "span.hpp"
+#include "bulkcopy.hpp"
+#include "waitstrategy.hpp"
 
 
 class FIFO
@@ -89,7 +97,9 @@ public:
     * allocate - returns a reference to a writeable 
     * member at the tail of the FIFO.  You must have 
     * a subsequent call to push in order to release
-    * this object to the FIFO once it is written.
+    * this object to the FIFO once it is written.  The
+    * slot is default constructed here, calling allocate
+    * twice without a push in between is an error.
     * @return  T&
     */
    template < class T > T& allocate()
@@ -97,7 +107,61 @@ public:
       void *ptr( nullptr );
       /** call blocks till an element is available **/
       local_allocate( &ptr );
-      return( *( reinterpret_cast< T* >( ptr ) ) );
+      /** slots are raw storage until something is put in them **/
+      return( *( new ( ptr ) T ) );
+   }
+
+   /**
+    * try_allocate - allocate() that doesn't block.
+    * @return  T*, nullptr if the FIFO is full
+    */
+   template < class T > T* try_allocate()
+   {
+      return( try_allocate_until< T >( Wait::Deadline::min() ) );
+   }
+
+   /**
+    * try_allocate_for - allocate() that gives up after 
+    * timeout.
+    * @param   timeout - const std::chrono::duration&
+    * @return  T*, nullptr if the FIFO stayed full
+    */
+   template < class T, class Rep, class Period > 
+   T* try_allocate_for( const std::chrono::duration< Rep, Period > &timeout )
+   {
+      return( try_allocate_until< T >( deadline_after( timeout ) ) );
+   }
+
+   /**
+    * try_allocate_until - allocate() that gives up at 
+    * deadline.
+    * @param   deadline - const Wait::Deadline&
+    * @return  T*, nullptr if the FIFO stayed full
+    */
+   template < class T > T* try_allocate_until( const Wait::Deadline &deadline )
+   {
+      void *ptr( nullptr );
+      if( ! local_try_allocate( &ptr, deadline ) )
+      {
+         return( nullptr );
+      }
+      return( new ( ptr ) T );
+   }
+
+   /**
+    * emplace - constructs an item in place at the tail of
+    * the FIFO from args and releases it, nothing is copied
+    * or moved.  For a signal other than NONE use 
+    * push( T&&, signal ).
+    * @param   args - Args&&..., passed to T's constructor
+    */
+   template < class T, class... Args > void emplace( Args&&... args )
+   {
+      void *ptr( nullptr );
+      /** call blocks till an element is available **/
+      local_allocate( &ptr );
+      new ( ptr ) T( std::forward< Args >( args )... );
+      push( RBSignal::NONE );
    }
 
    /**
@@ -108,6 +172,40 @@ public:
     */
    virtual void push( const RBSignal signal = RBSignal::NONE ) = 0;
 
+   /**
+    * allocate_range - returns a range of up to n writeable
+    * slots at the tail of the FIFO, blocks until at least
+    * one slot is available.  If the range crosses the end
+    * of the buffer it is returned as two spans.  The slots
+    * are released to the FIFO with a subsequent call to 
+    * push_range.
+    * @param   n - const std::size_t, max number of slots
+    * @return  SplitRange< T >
+    */
+   template < class T > SplitRange< T > allocate_range( const std::size_t n )
+   {
+      auto range( raw_range< T >( n ) );
+      /** see allocate(), slots push_range() doesn't release are destroyed **/
+      for( std::size_t i( 0 ); i < range.size(); i++ )
+      {
+         new ( &range[ i ] ) T;
+      }
+      return( range );
+   }
+
+   /**
+    * push_range - releases the first count slots handed out
+    * by the last call to allocate_range() to the queue with 
+    * a single update of the write pointer.  The signal is 
+    * attached to the last element released, the rest get 
+    * RBSignal::NONE.  Function will simply return if allocate
+    * wasn't called prior to calling this function.
+    * @param   count  - const std::size_t, <= size of range
+    * @param   signal - const RBSignal, default: NONE
+    */
+   virtual void push_range( const std::size_t count,
+                            const RBSignal signal = RBSignal::NONE ) = 0;
+
 
    /**
     * push - function which takes an object of type T and a 
@@ -122,19 +220,96 @@ public:
    template < class T > 
    void push( T &item, const RBSignal signal = RBSignal::NONE )
    {
+      static_assert( std::is_copy_constructible< T >::value,
+                     "push( T& ) copies, use push( std::move( item ) ) for move only types" );
       void *ptr( (void*) &item );
       /** call blocks till element is written and released to queue **/
       local_push( ptr, signal );
       return;
    }
 
+   /**
+    * push - rvalue version of the above, the item is move
+    * constructed into the FIFO instead of copied.
+    * @param   item   - T&&
+    * @param   signal - RBSignal, default RBSignal::NONE
+    */
+   template < class T,
+              typename std::enable_if< ! std::is_lvalue_reference< T >::value, int >::type = 0 >
+   void push( T &&item, const RBSignal signal = RBSignal::NONE )
+   {
+      void *ptr( (void*) &item );
+      /** call blocks till element is moved in and released to queue **/
+      local_push_move( ptr, signal );
+      return;
+   }
+
+   /**
+    * try_push - push() that doesn't block, an rvalue is 
+    * only moved from if it was pushed.
+    * @param   item   - T&&, lvalues are copied, rvalues moved
+    * @param   signal - RBSignal, default RBSignal::NONE
+    * @return  bool, false if the FIFO is full
+    */
+   template < class T > 
+   bool try_push( T &&item, const RBSignal signal = RBSignal::NONE )
+   {
+      return( try_push_until( std::forward< T >( item ), 
+                              Wait::Deadline::min(), 
+                              signal ) );
+   }
+
+   /**
+    * try_push_for - push() that gives up after timeout.
+    * @param   item    - T&&, lvalues are copied, rvalues moved
+    * @param   timeout - const std::chrono::duration&
+    * @param   signal  - RBSignal, default RBSignal::NONE
+    * @return  bool, false if the FIFO stayed full
+    */
+   template < class T, class Rep, class Period > 
+   bool try_push_for( T &&item, 
+                      const std::chrono::duration< Rep, Period > &timeout,
+                      const RBSignal signal = RBSignal::NONE )
+   {
+      return( try_push_until( std::forward< T >( item ), 
+                              deadline_after( timeout ), 
+                              signal ) );
+   }
+
+   /**
+    * try_push_until - push() that gives up at deadline.
+    * @param   item     - T&&, lvalues are copied, rvalues moved
+    * @param   deadline - const Wait::Deadline&
+    * @param   signal   - RBSignal, default RBSignal::NONE
+    * @return  bool, false if the FIFO stayed full
+    */
+   template < class T > 
+   bool try_push_until( T &&item, 
+                        const Wait::Deadline &deadline,
+                        const RBSignal signal = RBSignal::NONE )
+   {
+      static_assert( ! std::is_lvalue_reference< T >::value ||
+                     std::is_copy_constructible< typename std::decay< T >::type >::value,
+                     "an lvalue is copied, use std::move( item ) for move only types" );
+      void *ptr( (void*) &item );
+      if( std::is_lvalue_reference< T >::value )
+      {
+         return( local_try_push( ptr, signal, deadline ) );
+      }
+      return( local_try_push_move( ptr, signal, deadline ) );
+   }
+
    /**
     * insert - inserts the range from begin to end in the FIFO,
     * blocks until space is available.  If the range is greater
     * than the space available it'll simply block and add items
     * as space becomes available.  There is the implicit assumption
     * that another thread is consuming the data, so eventually there 
-    * will be room.
+    * will be room.  Any input iterator whose value_type is the type
+    * held by the FIFO works, contiguous ranges (pointers, arrays, 
+    * std::vector) are handed to the FIFO in one call so that they
+    * can be bulk copied, anything else is written in place through
+    * allocate_range().  The dispatch is resolved at compile time.
     * @param   begin - iterator_type, iterator to begin of range
     * @param   end   - iterator_type, iterator to end of range
     * @param   signal - RBSignal, default RBSignal::NONE
@@ -144,16 +319,28 @@ public:
                   iterator_type end,
                   const RBSignal signal = RBSignal::NONE )
    {
-      void *begin_ptr( (void*)&begin );
-      void *end_ptr  ( (void*)&end   );
-      local_insert( begin_ptr, end_ptr, signal, typeid( iterator_type ).hash_code() );
+      /** 
+       * a std::move_iterator hands out rvalues and is fine for 
+       * move only types, the element type is checked against the
+       * queue's by FIFOAbstract::insert(), through a FIFO& it 
+       * can't be, same as push() and pop()
+       */
+      static_assert( std::is_constructible< 
+                        typename std::iterator_traits< iterator_type >::value_type,
+                        typename std::iterator_traits< iterator_type >::reference >::value,
+                     "insert() copies, use std::make_move_iterator for move only types" );
+      insert_dispatch( begin, 
+                       end, 
+                       signal, 
+                       Buffer::is_contiguous_iterator< iterator_type >() );
       return;
    }
    
    /**
     * pop - pops the head of the queue.  If the receiving
     * object wants to watch use the signal, then the signal
-    * parameter should not be null.
+    * parameter should not be null.  The item is moved out
+    * and the slot destroyed.
     * @param   item - T&
     * @param   signal - RBSignal
     */
@@ -184,6 +371,131 @@ public:
       return;
    }
 
+   /**
+    * try_pop - pop() that doesn't block.
+    * @param   item   - T&
+    * @param   signal - RBSignal*, default = nullptr
+    * @return  bool, false if the FIFO is empty
+    */
+   template< class T >
+   bool try_pop( T &item, RBSignal *signal = nullptr )
+   {
+      return( try_pop_until( item, Wait::Deadline::min(), signal ) );
+   }
+
+   /**
+    * try_pop_for - pop() that gives up after timeout.
+    * @param   item    - T&
+    * @param   timeout - const std::chrono::duration&
+    * @param   signal  - RBSignal*, default = nullptr
+    * @return  bool, false if the FIFO stayed empty
+    */
+   template< class T, class Rep, class Period >
+   bool try_pop_for( T &item, 
+                     const std::chrono::duration< Rep, Period > &timeout,
+                     RBSignal *signal = nullptr )
+   {
+      return( try_pop_until( item, deadline_after( timeout ), signal ) );
+   }
+
+   /**
+    * try_pop_until - pop() that gives up at deadline.
+    * @param   item     - T&
+    * @param   deadline - const Wait::Deadline&
+    * @param   signal   - RBSignal*, default = nullptr
+    * @return  bool, false if the FIFO stayed empty
+    */
+   template< class T >
+   bool try_pop_until( T &item, 
+                       const Wait::Deadline &deadline,
+                       RBSignal *signal = nullptr )
+   {
+      return( local_try_pop( (void*)&item, signal, deadline ) );
+   }
+
+   /**
+    * try_pop_range - pops whatever is in the FIFO, up to 
+    * n_items, without blocking.
+    * @param   items   - T*
+    * @param   n_items - std::size_t
+    * @param   signal  - RBSignal*, default = nullptr
+    * @return  std::size_t, number of items popped
+    */
+   template< class T >
+   std::size_t try_pop_range( T *items,
+                              std::size_t n_items,
+                              RBSignal   *signal = nullptr )
+   {
+      return( try_pop_range_until( items, n_items, Wait::Deadline::min(), signal ) );
+   }
+
+   /**
+    * try_pop_range_for - waits up to timeout for the FIFO 
+    * to hold something, then pops up to n_items.
+    * @param   items   - T*
+    * @param   n_items - std::size_t
+    * @param   timeout - const std::chrono::duration&
+    * @param   signal  - RBSignal*, default = nullptr
+    * @return  std::size_t, number of items popped
+    */
+   template< class T, class Rep, class Period >
+   std::size_t try_pop_range_for( T *items,
+                                  std::size_t n_items,
+                                  const std::chrono::duration< Rep, Period > &timeout,
+                                  RBSignal   *signal = nullptr )
+   {
+      return( try_pop_range_until( items, n_items, deadline_after( timeout ), signal ) );
+   }
+
+   /**
+    * try_pop_range_until - waits until deadline for the FIFO 
+    * to hold something, then pops up to n_items.
+    * @param   items    - T*
+    * @param   n_items  - std::size_t
+    * @param   deadline - const Wait::Deadline&
+    * @param   signal   - RBSignal*, default = nullptr
+    * @return  std::size_t, number of items popped
+    */
+   template< class T >
+   std::size_t try_pop_range_until( T *items,
+                                    std::size_t n_items,
+                                    const Wait::Deadline &deadline,
+                                    RBSignal   *signal = nullptr )
+   {
+      if( n_items == 0 )
+      {
+         return( 0 );
+      }
+      return( local_try_pop_range( (void*)items, signal, n_items, deadline ) );
+   }
+
+   /**
+    * pop_until_signal - blocks until the FIFO holds something,
+    * then pops whatever is there up to max_n, stopping after
+    * the first item that carries a signal.  That signal goes
+    * to signal, NONE if none of the items popped had one, so a
+    * bulk consumer sees RBEOF without asking for more than was
+    * sent.  The signals are scanned a vector at a time.
+    * @param   items  - T*, room for max_n
+    * @param   max_n  - const std::size_t, non-zero
+    * @param   signal - RBSignal*, default = nullptr
+    * @return  std::size_t, number of items popped
+    */
+   template< class T >
+   std::size_t pop_until_signal( T *items,
+                                 const std::size_t max_n,
+                                 RBSignal *signal = nullptr )
+   {
+      assert( max_n > 0 );
+      RBSignal last( RBSignal::NONE );
+      const auto popped( local_pop_until_signal( (void*)items, &last, max_n ) );
+      if( signal != nullptr )
+      {
+         *signal = last;
+      }
+      return( popped );
+   }
+
    template< class T >
    T& peek( RBSignal *signal = nullptr )
    {
@@ -193,11 +505,35 @@ public:
    }
 
 
+   /**
+    * peek_range - read-only views of up to max_n items at the
+    * head of the FIFO, in place, blocks until there is at least
+    * one.  If the items cross the end of the buffer they come
+    * back as two spans.  Nothing is removed, recycle( n ) drops
+    * the first n once done with them; the views are valid until
+    * then.  The MPSC / SPMC / MPMC queues return one item at a
+    * time.
+    * @param   max_n  - const std::size_t, non-zero
+    * @param   signal - RBSignal*, if not null gets the signal of
+    *                   each item returned, max_n of them
+    * @return  SplitRange< const T >
+    */
+   template< class T >
+   SplitRange< const T > peek_range( const std::size_t max_n, RBSignal *signal = nullptr )
+   {
+      assert( max_n > 0 );
+      void        *ptr   [ 2 ] = { nullptr, nullptr };
+      std::size_t  length[ 2 ] = { 0, 0 };
+      std::size_t  stride( sizeof( T ) );
+      local_peek_range( ptr, length, stride, signal, max_n );
+      return( SplitRange< const T >( 
+         Span< const T >( reinterpret_cast< const T* >( ptr[ 0 ] ), length[ 0 ], stride ),
+         Span< const T >( reinterpret_cast< const T* >( ptr[ 1 ] ), length[ 1 ], stride ) ) );
+   }
+
    /** 
-    * recycle - if using peek() to view an element and you wish
-    * to discard it then this is your function.  Takes a parameter
-    * for future expansion where we allow more than one item to be
-    * peeked.
+    * recycle - discards range items from the head of the FIFO,
+    * use after peek() or peek_range() once done with them.
     * @param   range - const std::size_t
     */
    virtual void recycle( const std::size_t range = 1 ) = 0;
@@ -232,7 +568,83 @@ public:
     */
    virtual void get_write_finished( bool &write_finished ) = 0;
 
+   /**
+    * set_wait_policy - sets what the producer and consumer
+    * do while blocked on this FIFO, see waitstrategy.hpp.
+    * Should be called before the FIFO is in use.  Default
+    * version does nothing, for FIFOs that never block.
+    * @param   policy - const Wait::Policy&
+    */
+   virtual void set_wait_policy( const Wait::Policy &policy );
+
+   /**
+    * resize - asks for the FIFO to be moved to a buffer of
+    * new_cap items.  Safe to call from any thread while both
+    * ends are running, the producer switches over on its next
+    * write and the consumer follows once it has drained the
+    * old buffer so order and signals are kept.  Default 
+    * version does nothing, for FIFOs that can't be resized.
+    * @param   new_cap - const std::size_t
+    * @return  bool, true if the request was taken
+    */
+   virtual bool resize( const std::size_t new_cap );
+
+   /**
+    * set_label - names this FIFO in instrumentation snapshots
+    * (see instrument.hpp).  Default version does nothing, for
+    * FIFOs that aren't instrumented.
+    * @param   label - const std::string&
+    */
+   virtual void set_label( const std::string &label );
+
+   /**
+    * readable - cheap hint that a pop wouldn't block right
+    * now, meant for the consumer's thread (queues may answer
+    * from what the consumer has cached).  Default version is
+    * size() > 0.
+    * @return  bool
+    */
+   virtual bool readable();
+
+   /**
+    * writable - producer side version of readable(), default
+    * version is space_avail() > 0.
+    * @return  bool
+    */
+   virtual bool writable();
+
+   /**
+    * notifies - false if publishes on the other end can't 
+    * fire a Select::Notifier in this process (the other end
+    * is in another process), FIFOSelector polls those.
+    * @return  bool
+    */
+   virtual bool notifies() const;
+
+   /**
+    * watch_read - notifier is fired each time this FIFO may
+    * have become readable, nullptr stops it.  One notifier 
+    * at a time, once this returns with nullptr the old one 
+    * won't be touched again.  See FIFOSelector.
+    * @param   notifier - Select::Notifier*
+    */
+   void watch_read( Select::Notifier *notifier );
+
+   /**
+    * watch_write - as watch_read(), for the FIFO becoming
+    * writable.
+    * @param   notifier - Select::Notifier*
+    */
+   void watch_write( Select::Notifier *notifier );
+
 protected:
+   /** 
+    * fired by the producer after it publishes and by the
+    * consumer after it frees slots, respectively
+    */
+   Select::Hook   read_hook;
+   Select::Hook   write_hook;
+
    /** 
     * local_allocate - in order to get this whole thing
     * to work with multiple "ports" contained within the
@@ -245,6 +657,23 @@ protected:
     * @param   ptr - void **
     */
    virtual void local_allocate( void **ptr ) = 0;
+
+   /**
+    * local_allocate_range - type erased version of 
+    * allocate_range, ptr and length are both arrays of 
+    * two, the first entry describes the run of slots up 
+    * to the end of the buffer and the second the run that
+    * wraps to the front (length zero if there is none).
+    * Stride is set to the distance in bytes between slots.
+    * @param   ptr    - void**, array of two
+    * @param   length - std::size_t*, array of two
+    * @param   stride - std::size_t&
+    * @param   n      - const std::size_t, max slots wanted
+    */
+   virtual void local_allocate_range( void **ptr,
+                                      std::size_t *length,
+                                      std::size_t &stride,
+                                      const std::size_t n ) = 0;
    
    /**
     * local_push - pushes the object reference by the void
@@ -258,21 +687,29 @@ protected:
    virtual void local_push( void *ptr, const RBSignal &signal ) = 0;
 
    /**
-    * local_insert - inserts a range from ptr_begin to ptr_end
-    * and inserts the signal at the last element inserted, the 
-    * rest of the signals are set to RBSignal::NONE.
-    * @param   ptr_begin - void*
-    * @param   ptr_end   - void*
+    * local_push_move - same as local_push except the object
+    * is move constructed into the FIFO, ptr is left in 
+    * whatever state its move constructor leaves it in.
+    * @param   ptr - void* 
+    * @param   signal - RBSignal reference
+    */
+   virtual void local_push_move( void *ptr, const RBSignal &signal ) = 0;
+
+   /**
+    * local_insert - inserts the n_items contiguous elements 
+    * starting at ptr and inserts the signal at the last element
+    * inserted, the rest of the signals are set to RBSignal::NONE.
+    * @param   ptr       - const void*, array of T
+    * @param   n_items   - const std::size_t
     * @param   signal    - const RBSignal&
     */
-   virtual void local_insert( void *ptr_begin, 
-                              void *ptr_end, 
-                              const RBSignal &signal,
-                              const std::size_t iterator_type ) = 0;
+   virtual void local_insert( const void *ptr,
+                              const std::size_t n_items,
+                              const RBSignal &signal ) = 0;
   
    /**
-    * local_pop - makes a copy, pops an item from the queue and 
-    * stores the copy at memory located at *ptr.
+    * local_pop - pops an item from the queue, moving it to
+    * the memory located at *ptr, and destroys the slot.
     * @param   ptr    - void*
     * @param   signal - RBSignal*
     */
@@ -296,5 +733,211 @@ protected:
     */
    virtual void local_peek( void **ptr,
                             RBSignal *signal ) = 0;
+
+   /**
+    * local_peek_range - type erased version of peek_range,
+    * ptr and length are arrays of two as for 
+    * local_allocate_range().
+    * @param   ptr    - void**, array of two
+    * @param   length - std::size_t*, array of two
+    * @param   stride - std::size_t&, bytes between items
+    * @param   signal - RBSignal*, may be null
+    * @param   n      - const std::size_t, max items wanted
+    */
+   virtual void local_peek_range( void **ptr,
+                                  std::size_t *length,
+                                  std::size_t &stride,
+                                  RBSignal *signal,
+                                  const std::size_t n ) = 0;
+
+   /**
+    * local_try_allocate - local_allocate() that gives up at
+    * deadline, Wait::Deadline::min() doesn't wait at all.
+    * @param   ptr      - void **
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if no slot was free by then
+    */
+   virtual bool local_try_allocate( void **ptr, 
+                                    const Wait::Deadline &deadline ) = 0;
+
+   /**
+    * local_try_push - local_push() that gives up at deadline.
+    * @param   ptr      - void*
+    * @param   signal   - const RBSignal&
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if nothing was pushed
+    */
+   virtual bool local_try_push( void *ptr, 
+                                const RBSignal &signal,
+                                const Wait::Deadline &deadline ) = 0;
+
+   /**
+    * local_try_push_move - local_push_move() that gives up at
+    * deadline, ptr is left alone if nothing was pushed.
+    * @param   ptr      - void*
+    * @param   signal   - const RBSignal&
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if nothing was pushed
+    */
+   virtual bool local_try_push_move( void *ptr, 
+                                     const RBSignal &signal,
+                                     const Wait::Deadline &deadline ) = 0;
+
+   /**
+    * local_try_pop - local_pop() that gives up at deadline.
+    * @param   ptr      - void*
+    * @param   signal   - RBSignal*
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if nothing was popped
+    */
+   virtual bool local_try_pop( void *ptr, 
+                               RBSignal *signal,
+                               const Wait::Deadline &deadline ) = 0;
+
+   /**
+    * local_try_pop_range - waits until deadline for at least 
+    * one item then pops up to n_items without waiting again.
+    * @param   ptr_data - void*
+    * @param   signal   - RBSignal*
+    * @param   n_items  - std::size_t, > 0
+    * @param   deadline - const Wait::Deadline&
+    * @return  std::size_t, number of items popped
+    */
+   virtual std::size_t local_try_pop_range( void *ptr_data,
+                                            RBSignal *signal,
+                                            std::size_t n_items,
+                                            const Wait::Deadline &deadline ) = 0;
+
+   /**
+    * local_pop_until_signal - type erased pop_until_signal.
+    * @param   ptr_data - void*
+    * @param   signal   - RBSignal*, not null
+    * @param   n_items  - const std::size_t, > 0
+    * @return  std::size_t, number of items popped
+    */
+   virtual std::size_t local_pop_until_signal( void *ptr_data,
+                                               RBSignal *signal,
+                                               const std::size_t n_items ) = 0;
+
+private:
+   /** deadline timeout from now, clamped so it can't overflow **/
+   template < class Rep, class Period >
+   static Wait::Deadline deadline_after( const std::chrono::duration< Rep, Period > &timeout )
+   {
+      const auto now( std::chrono::steady_clock::now() );
+      using seconds = std::chrono::duration< double >;
+      if( seconds( timeout ) >= seconds( Wait::Deadline::max() - now ) )
+      {
+         return( Wait::Deadline::max() );
+      }
+      return( now + std::chrono::duration_cast< Wait::Deadline::duration >( timeout ) );
+   }
+
+   /**
+    * insert_dispatch - contiguous range, hand the whole 
+    * thing over as an array.
+    */
+   template< class iterator_type >
+   void insert_dispatch( iterator_type begin,
+                         iterator_type end,
+                         const RBSignal signal,
+                         std::true_type /** contiguous **/ )
+   {
+      const auto n_items( std::distance( begin, end ) );
+      if( n_items <= 0 )
+      {
+         return;
+      }
+      local_insert( (const void*) &(*begin), n_items, signal );
+   }
+
+   /**
+    * raw_range - allocate_range() without constructing the
+    * slots, every slot handed out has to be constructed by
+    * the caller before push_range() releases the lot.
+    * @param   n - const std::size_t, max number of slots
+    * @return  SplitRange< T >
+    */
+   template < class T > SplitRange< T > raw_range( const std::size_t n )
+   {
+      void        *ptr   [ 2 ] = { nullptr, nullptr };
+      std::size_t  length[ 2 ] = { 0, 0 };
+      std::size_t  stride( sizeof( T ) );
+      /** call blocks till at least one element is available **/
+      local_allocate_range( ptr, length, stride, n );
+      return( SplitRange< T >( 
+         Span< T >( reinterpret_cast< T* >( ptr[ 0 ] ), length[ 0 ], stride ),
+         Span< T >( reinterpret_cast< T* >( ptr[ 1 ] ), length[ 1 ], stride ) ) );
+   }
+
+   /**
+    * insert_dispatch - everything else, elements are
+    * constructed straight into raw slots from raw_range()
+    * and released a range at a time.
+    */
+   template< class iterator_type >
+   void insert_dispatch( iterator_type begin,
+                         iterator_type end,
+                         const RBSignal signal,
+                         std::false_type )
+   {
+      insert_walk( begin, 
+                   end, 
+                   signal, 
+                   typename std::iterator_traits< iterator_type >::iterator_category() );
+   }
+
+   /**
+    * insert_walk - iterators that can be walked twice, the
+    * distance is known so each range handed out is filled 
+    * completely and nothing is left unconstructed.
+    */
+   template< class iterator_type >
+   void insert_walk( iterator_type begin,
+                     iterator_type end,
+                     const RBSignal signal,
+                     std::forward_iterator_tag )
+   {
+      using value_type = typename std::iterator_traits< iterator_type >::value_type;
+      while( begin != end )
+      {
+         auto range( raw_range< value_type >( std::distance( begin, end ) ) );
+         for( std::size_t i( 0 ); i < range.size(); i++, ++begin )
+         {
+            new ( &range[ i ] ) value_type( *begin );
+         }
+         push_range( range.size(), ( begin == end ? signal : RBSignal::NONE ) );
+      }
+   }
+
+   /**
+    * insert_walk - single pass iterators can't be measured,
+    * items are gathered a modest chunk at a time and then
+    * moved in as above, a short input never holds slots it
+    * can't fill.
+    */
+   template< class iterator_type >
+   void insert_walk( iterator_type begin,
+                     iterator_type end,
+                     const RBSignal signal,
+                     std::input_iterator_tag )
+   {
+      using value_type = typename std::iterator_traits< iterator_type >::value_type;
+      std::vector< value_type > chunk;
+      chunk.reserve( std::min< std::size_t >( capacity(), 64 ) );
+      while( begin != end )
+      {
+         chunk.clear();
+         while( chunk.size() < chunk.capacity() && begin != end )
+         {
+            chunk.emplace_back( *begin );
+            ++begin;
+         }
+         insert_walk( std::make_move_iterator( chunk.begin() ),
+                      std::make_move_iterator( chunk.end() ),
+                      ( begin == end ? signal : RBSignal::NONE ),
+                      std::forward_iterator_tag() );
+      }
+   }
 };
 #endif /* END _FIFO_HPP_ */
@@ -19,8 +19,11 @@
  */
 #ifndef _FIFOABSTRACT_TCC_
 #define _FIFOABSTRACT_TCC_  1
+#include <iterator>
+#include <type_traits>
 #include "ringbuffertypes.hpp"
 #include "fifo.hpp"
+#include "signalqueue.hpp"
 
 template < class T, Type::RingBufferType type > 
    class FIFOAbstract : public FIFO
@@ -32,6 +35,47 @@ public:
 
    virtual ~FIFOAbstract() = default;
 
+   /**
+    * get_signal - takes the oldest asynchronous signal,
+    * these travel apart from the elements so they are 
+    * seen right away no matter how full the queue is.
+    * @return  RBSignal, NONE if none are waiting
+    */
+   virtual RBSignal get_signal()
+   {
+      return( channel.receive() );
+   }
+
+   /**
+    * send_signal - queues an asynchronous signal, any thread 
+    * may call this.
+    * @param   signal - const RBSignal reference
+    * @return  bool   - false if too many are already waiting
+    */
+   virtual bool send_signal( const RBSignal &signal )
+   {
+      return( channel.send( signal ) );
+   }
+
+   /**
+    * insert - FIFO::insert() with the element type checked,
+    * items of another type would land in slots sized for T.
+    * @param   begin  - iterator_type
+    * @param   end    - iterator_type
+    * @param   signal - RBSignal, default RBSignal::NONE
+    */
+   template< class iterator_type >
+   void insert( iterator_type begin,
+                iterator_type end,
+                const RBSignal signal = RBSignal::NONE )
+   {
+      static_assert( std::is_same< typename std::iterator_traits< iterator_type >::value_type,
+                                   T >::value,
+                     "insert() needs a range of the queue's element type" );
+      FIFO::insert( begin, end, signal );
+   }
+
 protected:
+   Signals::Channel<>   channel;
 };
 #endif /* END _FIFOABSTRACT_TCC_ */
@@ -0,0 +1,205 @@
+/**
+ * fifoarena.hpp -
+ * @author: Jonathan Beard
+ * @version: Mon Oct 19 13:37:02 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FIFOARENA_HPP_
+#define _FIFOARENA_HPP_  1
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <string>
+
+#include "fifo.hpp"
+#include "pointer.hpp"
+#include "waitstrategy.hpp"
+
+/**
+ * FIFOArena - one mapped region that heap RingBuffers are
+ * built in, the queue objects, their buffers, slots, signals
+ * and indices are all carved out of it, each cache line
+ * aligned, so thousands of small queues cost one mmap.  Queues
+ * made here belong to the arena: never delete them, clear()
+ * or the destructor destroys all of them at once.  A queue
+ * that is resized moves to a buffer from the ordinary heap,
+ * the arena space it leaves is only given back by clear().
+ * Creating queues isn't thread safe, using them is as usual.
+ */
+class FIFOArena
+{
+public:
+   /**
+    * FIFOArena -
+    * @param   bytes      - const std::size_t, size of the region,
+    *                       see bytes_for()
+    * @param   huge_pages - const bool, back it with huge pages
+    *                       if the system has them reserved,
+    *                       otherwise ask for transparent ones
+    */
+   FIFOArena( const std::size_t bytes, const bool huge_pages = false );
+
+   /**
+    * FIFOArena - as above but mapped from a file created in
+    * directory and unlinked right away, the kernel can write
+    * it out instead of holding it in memory, see 
+    * RingBuffer::spill_to().  clear() gives the blocks back.
+    * @param   bytes     - const std::size_t, size of the region
+    * @param   directory - const std::string&
+    */
+   FIFOArena( const std::size_t bytes, const std::string &directory );
+
+   /** destroys every queue made here and unmaps the region **/
+   ~FIFOArena();
+
+   FIFOArena( const FIFOArena& ) = delete;
+   FIFOArena& operator = ( const FIFOArena& ) = delete;
+
+   /**
+    * make - builds a heap queue of n_items in the arena,
+    * Q is the RingBuffer type, e.g. RingBuffer< int >.
+    * @param   n_items - const std::size_t
+    * @param   policy  - const Wait::Policy&
+    * @return  Q*, owned by the arena
+    */
+   template < class Q >
+   Q* make( const std::size_t n_items, const Wait::Policy &policy = Wait::Policy() )
+   {
+      static_assert( std::is_base_of< FIFO, Q >::value, "FIFOArena only builds FIFOs" );
+      auto *entry( new ( allocate( sizeof( Entry ), alignof( Entry ) ) ) Entry() );
+      void *mem( allocate( sizeof( Q ), std::max< std::size_t >( alignof( Q ),
+                                                                 L1D_CACHE_LINE_SIZE ) ) );
+      Q *fifo( new ( mem ) Q( n_items, *this, policy ) );
+      entry->fifo = fifo;
+      entry->next = head;
+      head        = entry;
+      count++;
+      return( fifo );
+   }
+
+   /**
+    * make_many - n_queues queues of n_items each, one after
+    * another in the region.
+    * @param   n_items  - const std::size_t
+    * @param   n_queues - const std::size_t
+    * @param   out      - FIFO**, n_queues of them
+    * @param   policy   - const Wait::Policy&
+    */
+   template < class Q >
+   void make_many( const std::size_t n_items,
+                   const std::size_t n_queues,
+                   FIFO **out,
+                   const Wait::Policy &policy = Wait::Policy() )
+   {
+      for( std::size_t i( 0 ); i < n_queues; i++ )
+      {
+         out[ i ] = make< Q >( n_items, policy );
+      }
+   }
+
+   /**
+    * bytes_for - region size that holds n_queues queues of
+    * n_items each, Q::arena_bytes() plus the bookkeeping.
+    * @param   n_items  - const std::size_t
+    * @param   n_queues - const std::size_t, default 1
+    * @return  std::size_t
+    */
+   template < class Q >
+   static std::size_t bytes_for( const std::size_t n_items, const std::size_t n_queues = 1 )
+   {
+      const std::size_t one( round( sizeof( Entry ) ) +
+                             round( sizeof( Q ) + alignof( Q ) - 1 ) +
+                             Q::arena_bytes( n_items ) );
+      return( one * n_queues );
+   }
+
+   /**
+    * allocate - bytes from the region aligned to align,
+    * exits if the region is used up.
+    * @param   bytes - const std::size_t
+    * @param   align - const std::size_t, a power of two
+    * @return  void*
+    */
+   void* allocate( const std::size_t bytes, const std::size_t align = L1D_CACHE_LINE_SIZE );
+
+   /**
+    * clear - destroys every queue made here, newest first, and
+    * starts over at the beginning of the region.  Nothing may
+    * be using them any more.
+    */
+   void clear();
+
+   /** queues currently in the arena **/
+   std::size_t size() const
+   {
+      return( count );
+   }
+
+   /** bytes handed out so far **/
+   std::size_t used() const
+   {
+      return( offset );
+   }
+
+   std::size_t capacity() const
+   {
+      return( length );
+   }
+
+   /** true if ptr points into the region **/
+   bool owns( const void *ptr ) const
+   {
+      const char *p( reinterpret_cast< const char* >( ptr ) );
+      return( p >= region && p < region + length );
+   }
+
+   /** true if the region is backed by reserved huge pages **/
+   bool huge() const
+   {
+      return( huge_backed );
+   }
+
+   /** true if the region is mapped from a file **/
+   bool file() const
+   {
+      return( file_backed );
+   }
+
+private:
+   struct Entry
+   {
+      FIFO  *fifo = nullptr;
+      Entry *next = nullptr;
+   };
+
+   static std::size_t round( const std::size_t bytes )
+   {
+      return( ( ( bytes + L1D_CACHE_LINE_SIZE - 1 ) / L1D_CACHE_LINE_SIZE ) *
+                 L1D_CACHE_LINE_SIZE );
+   }
+
+   char         *region;
+   std::size_t   length;
+   std::size_t   offset;
+   bool          huge_backed;
+   bool          file_backed;
+   /** newest first, destroyed in that order **/
+   Entry        *head;
+   std::size_t   count;
+};
+#endif /* END _FIFOARENA_HPP_ */
@@ -0,0 +1,433 @@
+/**
+ * fifohandle.tcc -
+ * @author: Jonathan Beard
+ * @version: Tue Oct 20 10:14:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FIFOHANDLE_TCC_
+#define _FIFOHANDLE_TCC_  1
+
+namespace Typed
+{
+   /**
+    * Producer / Consumer - typed handles on one end of a Heap,
+    * SharedMemory or TCP queue.  Every call goes straight to
+    * the queue's own implementation with a qualified, non-virtual
+    * call so the compiler can inline the whole push or pop into
+    * the loop that makes it, nothing goes through the FIFO vtable.
+    * A handle is a reference, the queue has to outlive it, and
+    * the queue can still be used through FIFO& by generic code.
+    * As with the FIFO calls, only one thread uses each end.  They
+    * live in Typed, the global Producer / Consumer are Direction's.
+    */
+   template < class T,
+              Type::RingBufferType type,
+              Layout::SlotLayout layout,
+              std::size_t SIZE > class Producer
+   {
+      static_assert( type == Type::Heap ||
+                     type == Type::SharedMemory ||
+                     type == Type::TCP,
+                     "typed handles are for the single producer / consumer heap queues" );
+   public:
+      using queue_t = RingBufferBase< T, type, layout, SIZE >;
+
+      explicit Producer( queue_t &queue ) : queue( queue )
+      {
+      }
+
+      /**
+       * from - the handle for a FIFO that is known to be a
+       * RingBuffer< T, type, layout, SIZE >, exits if it isn't.
+       * @param   fifo - FIFO&
+       * @return  Producer
+       */
+      static Producer from( FIFO &fifo )
+      {
+         auto *queue( dynamic_cast< queue_t* >( &fifo ) );
+         if( queue == nullptr )
+         {
+            std::cerr << "Typed::Producer< T >::from() given a FIFO of some other type, exiting.\n";
+            exit( EXIT_FAILURE );
+         }
+         return( Producer( *queue ) );
+      }
+
+      /**
+       * push - copies item to the tail of the queue, blocks while
+       * the queue is full.
+       * @param   item   - const T&
+       * @param   signal - const RBSignal, default NONE
+       */
+      void push( const T &item, const RBSignal signal = RBSignal::NONE )
+      {
+         static_assert( std::is_copy_constructible< T >::value,
+                        "push( const T& ) copies, move only types have to be moved in" );
+         queue.queue_t::local_try_push( (void*) &item, signal, Wait::Deadline::max() );
+      }
+
+      /**
+       * push - rvalue version of the above, item is moved in.
+       * @param   item   - T&&
+       * @param   signal - const RBSignal, default NONE
+       */
+      void push( T &&item, const RBSignal signal = RBSignal::NONE )
+      {
+         queue.queue_t::local_try_push_move( (void*) &item, signal, Wait::Deadline::max() );
+      }
+
+      /**
+       * try_push - push() that doesn't block.
+       * @param   item   - const T&
+       * @param   signal - const RBSignal, default NONE
+       * @return  bool, false if the queue is full
+       */
+      bool try_push( const T &item, const RBSignal signal = RBSignal::NONE )
+      {
+         return( try_push_until( item, Wait::Deadline::min(), signal ) );
+      }
+
+      /**
+       * try_push - rvalue version, item is only moved from if
+       * it was pushed.
+       * @param   item   - T&&
+       * @param   signal - const RBSignal, default NONE
+       * @return  bool, false if the queue is full
+       */
+      bool try_push( T &&item, const RBSignal signal = RBSignal::NONE )
+      {
+         return( try_push_until( std::move( item ), Wait::Deadline::min(), signal ) );
+      }
+
+      /**
+       * try_push_until - push() that gives up at deadline.
+       * @param   item     - const T&
+       * @param   deadline - const Wait::Deadline&
+       * @param   signal   - const RBSignal, default NONE
+       * @return  bool, false if the queue stayed full
+       */
+      bool try_push_until( const T &item,
+                           const Wait::Deadline &deadline,
+                           const RBSignal signal = RBSignal::NONE )
+      {
+         static_assert( std::is_copy_constructible< T >::value,
+                        "try_push( const T& ) copies, move only types have to be moved in" );
+         return( queue.queue_t::local_try_push( (void*) &item, signal, deadline ) );
+      }
+
+      /** rvalue version of the above **/
+      bool try_push_until( T &&item,
+                           const Wait::Deadline &deadline,
+                           const RBSignal signal = RBSignal::NONE )
+      {
+         return( queue.queue_t::local_try_push_move( (void*) &item, signal, deadline ) );
+      }
+
+      /**
+       * emplace - constructs an item in place at the tail and
+       * releases it with signal NONE.
+       * @param   args - Args&&..., passed to T's constructor
+       */
+      template < class... Args > void emplace( Args&&... args )
+      {
+         void *ptr( nullptr );
+         queue.queue_t::local_try_allocate( &ptr, Wait::Deadline::max() );
+         new ( ptr ) T( std::forward< Args >( args )... );
+         queue.queue_t::push( RBSignal::NONE );
+      }
+
+      /**
+       * allocate - default constructed slot at the tail, release
+       * it with push( signal ).
+       * @return  T&
+       */
+      T& allocate()
+      {
+         void *ptr( nullptr );
+         queue.queue_t::local_try_allocate( &ptr, Wait::Deadline::max() );
+         return( *( new ( ptr ) T ) );
+      }
+
+      /**
+       * try_allocate - allocate() that doesn't block.
+       * @return  T*, nullptr if the queue is full
+       */
+      T* try_allocate()
+      {
+         void *ptr( nullptr );
+         if( ! queue.queue_t::local_try_allocate( &ptr, Wait::Deadline::min() ) )
+         {
+            return( nullptr );
+         }
+         return( new ( ptr ) T );
+      }
+
+      /**
+       * push - releases the slot from allocate().
+       * @param   signal - const RBSignal, default NONE
+       */
+      void push( const RBSignal signal = RBSignal::NONE )
+      {
+         queue.queue_t::push( signal );
+      }
+
+      /**
+       * allocate_range - up to n default constructed slots at
+       * the tail, release them with push_range().
+       * @param   n - const std::size_t
+       * @return  SplitRange< T >
+       */
+      SplitRange< T > allocate_range( const std::size_t n )
+      {
+         void        *ptr   [ 2 ] = { nullptr, nullptr };
+         std::size_t  length[ 2 ] = { 0, 0 };
+         std::size_t  stride( sizeof( T ) );
+         queue.queue_t::local_allocate_range( ptr, length, stride, n );
+         SplitRange< T > range(
+            Span< T >( reinterpret_cast< T* >( ptr[ 0 ] ), length[ 0 ], stride ),
+            Span< T >( reinterpret_cast< T* >( ptr[ 1 ] ), length[ 1 ], stride ) );
+         for( std::size_t i( 0 ); i < range.size(); i++ )
+         {
+            new ( &range[ i ] ) T;
+         }
+         return( range );
+      }
+
+      /**
+       * push_range - releases the first count slots from
+       * allocate_range().
+       * @param   count  - const std::size_t
+       * @param   signal - const RBSignal, default NONE
+       */
+      void push_range( const std::size_t count, const RBSignal signal = RBSignal::NONE )
+      {
+         queue.queue_t::push_range( count, signal );
+      }
+
+      std::size_t space_avail()
+      {
+         return( queue.space_avail() );
+      }
+
+      std::size_t capacity() const
+      {
+         return( queue.queue_t::capacity() );
+      }
+
+      /** the queue, for everything the handle doesn't do **/
+      queue_t& fifo()
+      {
+         return( queue );
+      }
+
+   private:
+      queue_t &queue;
+   };
+
+   /**
+    * Consumer - see Producer.
+    */
+   template < class T,
+              Type::RingBufferType type,
+              Layout::SlotLayout layout,
+              std::size_t SIZE > class Consumer
+   {
+      static_assert( type == Type::Heap ||
+                     type == Type::SharedMemory ||
+                     type == Type::TCP,
+                     "typed handles are for the single producer / consumer heap queues" );
+   public:
+      using queue_t = RingBufferBase< T, type, layout, SIZE >;
+
+      explicit Consumer( queue_t &queue ) : queue( queue )
+      {
+      }
+
+      /**
+       * from - the handle for a FIFO that is known to be a
+       * RingBuffer< T, type, layout, SIZE >, exits if it isn't.
+       * @param   fifo - FIFO&
+       * @return  Consumer
+       */
+      static Consumer from( FIFO &fifo )
+      {
+         auto *queue( dynamic_cast< queue_t* >( &fifo ) );
+         if( queue == nullptr )
+         {
+            std::cerr << "Typed::Consumer< T >::from() given a FIFO of some other type, exiting.\n";
+            exit( EXIT_FAILURE );
+         }
+         return( Consumer( *queue ) );
+      }
+
+      /**
+       * pop - moves the item at the head into item, blocks while
+       * the queue is empty.
+       * @param   item   - T&
+       * @param   signal - RBSignal*, default nullptr
+       */
+      void pop( T &item, RBSignal *signal = nullptr )
+      {
+         queue.queue_t::local_try_pop( (void*) &item, signal, Wait::Deadline::max() );
+      }
+
+      /**
+       * try_pop - pop() that doesn't block.
+       * @param   item   - T&
+       * @param   signal - RBSignal*, default nullptr
+       * @return  bool, false if the queue is empty
+       */
+      bool try_pop( T &item, RBSignal *signal = nullptr )
+      {
+         return( try_pop_until( item, Wait::Deadline::min(), signal ) );
+      }
+
+      /**
+       * try_pop_until - pop() that gives up at deadline.
+       * @param   item     - T&
+       * @param   deadline - const Wait::Deadline&
+       * @param   signal   - RBSignal*, default nullptr
+       * @return  bool, false if the queue stayed empty
+       */
+      bool try_pop_until( T &item,
+                          const Wait::Deadline &deadline,
+                          RBSignal *signal = nullptr )
+      {
+         return( queue.queue_t::local_try_pop( (void*) &item, signal, deadline ) );
+      }
+
+      /**
+       * pop_range - pops exactly n_items, blocking as needed.
+       * @param   items   - T*
+       * @param   n_items - const std::size_t
+       * @param   signal  - RBSignal*, n_items of them or nullptr
+       */
+      void pop_range( T *items, const std::size_t n_items, RBSignal *signal = nullptr )
+      {
+         queue.queue_t::local_pop_range( (void*) items, signal, n_items );
+      }
+
+      /**
+       * try_pop_range - pops whatever is there up to n_items.
+       * @param   items   - T*
+       * @param   n_items - const std::size_t
+       * @param   signal  - RBSignal*, n_items of them or nullptr
+       * @return  std::size_t, items popped
+       */
+      std::size_t try_pop_range( T *items,
+                                 const std::size_t n_items,
+                                 RBSignal *signal = nullptr )
+      {
+         return( try_pop_range_until( items, n_items, Wait::Deadline::min(), signal ) );
+      }
+
+      /**
+       * try_pop_range_until - waits until deadline for something
+       * to pop, then pops whatever is there up to n_items.
+       * @param   items    - T*
+       * @param   n_items  - const std::size_t
+       * @param   deadline - const Wait::Deadline&
+       * @param   signal   - RBSignal*, n_items of them or nullptr
+       * @return  std::size_t, items popped
+       */
+      std::size_t try_pop_range_until( T *items,
+                                       const std::size_t n_items,
+                                       const Wait::Deadline &deadline,
+                                       RBSignal *signal = nullptr )
+      {
+         return( queue.queue_t::local_try_pop_range( (void*) items, signal, n_items, deadline ) );
+      }
+
+      /**
+       * pop_until_signal - pops what is there up to max_n,
+       * through the first item with a signal, see
+       * FIFO::pop_until_signal().
+       * @param   items  - T*
+       * @param   max_n  - const std::size_t, non-zero
+       * @param   signal - RBSignal*, default nullptr
+       * @return  std::size_t, items popped
+       */
+      std::size_t pop_until_signal( T *items,
+                                    const std::size_t max_n,
+                                    RBSignal *signal = nullptr )
+      {
+         assert( max_n > 0 );
+         RBSignal last( RBSignal::NONE );
+         const auto popped( queue.queue_t::local_pop_until_signal( (void*) items, &last, max_n ) );
+         if( signal != nullptr )
+         {
+            *signal = last;
+         }
+         return( popped );
+      }
+
+      /**
+       * peek - the item at the head, left in the queue until
+       * recycle().
+       * @param   signal - RBSignal*, default nullptr
+       * @return  T&
+       */
+      T& peek( RBSignal *signal = nullptr )
+      {
+         void *ptr( nullptr );
+         queue.queue_t::local_peek( &ptr, signal );
+         return( *reinterpret_cast< T* >( ptr ) );
+      }
+
+      /**
+       * peek_range - views of up to max_n items at the head,
+       * see FIFO::peek_range().
+       * @param   max_n  - const std::size_t, non-zero
+       * @param   signal - RBSignal*, max_n of them or nullptr
+       * @return  SplitRange< const T >
+       */
+      SplitRange< const T > peek_range( const std::size_t max_n, RBSignal *signal = nullptr )
+      {
+         assert( max_n > 0 );
+         void        *ptr   [ 2 ] = { nullptr, nullptr };
+         std::size_t  length[ 2 ] = { 0, 0 };
+         std::size_t  stride( sizeof( T ) );
+         queue.queue_t::local_peek_range( ptr, length, stride, signal, max_n );
+         return( SplitRange< const T >(
+            Span< const T >( reinterpret_cast< const T* >( ptr[ 0 ] ), length[ 0 ], stride ),
+            Span< const T >( reinterpret_cast< const T* >( ptr[ 1 ] ), length[ 1 ], stride ) ) );
+      }
+
+      /**
+       * recycle - drops range items from the head.
+       * @param   range - const std::size_t, default 1
+       */
+      void recycle( const std::size_t range = 1 )
+      {
+         queue.queue_t::recycle( range );
+      }
+
+      std::size_t size()
+      {
+         return( queue.queue_t::size() );
+      }
+
+      /** the queue, for everything the handle doesn't do **/
+      queue_t& fifo()
+      {
+         return( queue );
+      }
+
+   private:
+      queue_t &queue;
+   };
+}
+#endif /* END _FIFOHANDLE_TCC_ */
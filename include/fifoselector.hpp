@@ -0,0 +1,138 @@
+/**
+ * fifoselector.hpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 14:05:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FIFOSELECTOR_HPP_
+#define _FIFOSELECTOR_HPP_  1
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fifo.hpp"
+#include "notifier.hpp"
+#include "waitstrategy.hpp"
+
+/**
+ * FIFOSelector - waits on many FIFOs at once and says which
+ * ones are readable and / or writable.  Readiness comes from
+ * FIFO::readable() / writable(), which the queues answer from
+ * the pointer positions their owning end has cached, so the
+ * selector must run on the thread that owns the watched ends
+ * (the consumer for Read, the producer for Write).  When nothing
+ * is ready it sleeps on a single futex that the queues fire as
+ * they publish, fd() exports the same thing as an eventfd for an
+ * existing epoll loop.  FIFOs whose other end is in another
+ * process (FIFO::notifies()) are polled every poll period.
+ */
+class FIFOSelector
+{
+public:
+   enum Interest : std::uint32_t { Read = 1, Write = 2 };
+
+   struct Event
+   {
+      FIFO           *fifo;
+      /** Read and / or Write **/
+      std::uint32_t   ready;
+   };
+
+   /**
+    * FIFOSelector -
+    * @param   poll - std::chrono::microseconds, how often FIFOs
+    *                 that can't notify are looked at while
+    *                 waiting
+    */
+   FIFOSelector( const std::chrono::microseconds poll = std::chrono::microseconds( 1000 ) );
+
+   /** stops watching every FIFO **/
+   ~FIFOSelector();
+
+   FIFOSelector( const FIFOSelector& ) = delete;
+   FIFOSelector& operator = ( const FIFOSelector& ) = delete;
+
+   /**
+    * add - starts watching fifo, it must stay alive until it
+    * is removed or the selector is destroyed.  A FIFO may be
+    * watched for each of Read and Write by one selector at a
+    * time.  A publish racing with add() may go unnoticed until
+    * the next, add before the other end starts if that matters.
+    * @param   fifo     - FIFO*
+    * @param   interest - const std::uint32_t, Read | Write
+    */
+   void add( FIFO *fifo, const std::uint32_t interest );
+
+   /**
+    * remove - stops watching fifo, once this returns the
+    * selector won't touch it again.
+    * @param   fifo - FIFO*
+    */
+   void remove( FIFO *fifo );
+
+   /**
+    * select - fills events with the FIFOs that are ready,
+    * waits until deadline if none are.
+    * @param   events   - std::vector< Event >&, cleared first
+    * @param   deadline - const Wait::Deadline&, default none,
+    *                     Wait::Deadline::min() just looks
+    * @return  std::size_t, events.size()
+    */
+   std::size_t select( std::vector< Event > &events,
+                       const Wait::Deadline &deadline = Wait::Deadline::max() );
+
+   /**
+    * select_for - select() that waits at most timeout.
+    * @param   events  - std::vector< Event >&
+    * @param   timeout - const std::chrono::duration&
+    * @return  std::size_t, events.size()
+    */
+   template < class Rep, class Period >
+   std::size_t select_for( std::vector< Event > &events,
+                           const std::chrono::duration< Rep, Period > &timeout )
+   {
+      return( select( events,
+                      std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast< Wait::Deadline::duration >( timeout ) ) );
+   }
+
+   /**
+    * fd - eventfd that turns readable once something may be
+    * ready, edge triggered: after it fires call
+    * select( events, Wait::Deadline::min() ) until it comes
+    * back empty, that re-arms it.  -1 without eventfds.
+    * @return  int
+    */
+   int fd() const;
+
+private:
+   struct Entry
+   {
+      FIFO           *fifo;
+      std::uint32_t   interest;
+   };
+
+   /** one pass over every FIFO **/
+   void scan( std::vector< Event > &events );
+
+   const std::chrono::microseconds  poll;
+   std::vector< Entry >             entries;
+   /** entries that have to be polled **/
+   std::size_t                      polled;
+   Select::Notifier                 notifier;
+};
+#endif /* END _FIFOSELECTOR_HPP_ */
@@ -0,0 +1,59 @@
+/**
+ * futex.hpp - 
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 11:20:47 2026
+ * 
+ * Copyright 2014 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _FUTEX_HPP_
+#define _FUTEX_HPP_  1
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * thin wrappers around the futex syscall, the process shared
+ * variants are used so that the word may live in a SHM segment
+ * mapped by both ends of a queue.  Platforms without futexes 
+ * fall back to yielding, callers must always re-check their 
+ * condition after wait returns.
+ */
+namespace Futex
+{
+   /**
+    * wait - blocks the caller as long as *addr == expected,
+    * may return spuriously.
+    * @param   addr     - std::atomic< std::uint32_t >*
+    * @param   expected - const std::uint32_t
+    */
+   void wait( std::atomic< std::uint32_t > *addr, const std::uint32_t expected );
+
+   /**
+    * wait_for - as wait but gives up after timeout.
+    * @param   addr     - std::atomic< std::uint32_t >*
+    * @param   expected - const std::uint32_t
+    * @param   timeout  - const std::chrono::nanoseconds
+    */
+   void wait_for( std::atomic< std::uint32_t > *addr, 
+                  const std::uint32_t expected,
+                  const std::chrono::nanoseconds timeout );
+
+   /**
+    * wake - wakes every thread blocked in wait on addr.
+    * @param   addr - std::atomic< std::uint32_t >*
+    */
+   void wake( std::atomic< std::uint32_t > *addr );
+}
+#endif /* END _FUTEX_HPP_ */
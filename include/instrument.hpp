@@ -0,0 +1,375 @@
+/**
+ * instrument.hpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 21:03:17 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _INSTRUMENT_HPP_
+#define _INSTRUMENT_HPP_  1
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if __x86_64
+#include <x86intrin.h>
+#endif
+
+#include "pointer.hpp"
+
+/**
+ * FIFO_INSTRUMENT - set to 1 at compile time to have every
+ * single producer / single consumer queue (Heap, SharedMemory,
+ * TCP) keep the counters below and show up in the registry.
+ * Left at 0 the probes are empty and compile away.  Every
+ * translation unit of a program must agree on the setting.
+ */
+#ifndef FIFO_INSTRUMENT
+#define FIFO_INSTRUMENT 0
+#endif
+
+/**
+ * FIFO_INSTRUMENT_SAMPLE - occupancy is sampled by the producer
+ * once every this many items written, must be a power of two.
+ */
+#ifndef FIFO_INSTRUMENT_SAMPLE
+#define FIFO_INSTRUMENT_SAMPLE 64
+#endif
+
+namespace Stats
+{
+   static_assert( ( FIFO_INSTRUMENT_SAMPLE & ( FIFO_INSTRUMENT_SAMPLE - 1 ) ) == 0,
+                  "FIFO_INSTRUMENT_SAMPLE must be a power of two" );
+
+   /**
+    * cycles - time stamp counter on x86_64, nanoseconds from
+    * the steady clock anywhere else.
+    * @return  std::uint64_t
+    */
+   inline std::uint64_t cycles()
+   {
+#if __x86_64
+      return( __rdtsc() );
+#else
+      return( std::chrono::duration_cast< std::chrono::nanoseconds >(
+         std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+   }
+
+   /** bin i holds values v with 2^(i-1) <= v < 2^i, bin 0 holds zero **/
+   constexpr std::size_t bins = 65;
+
+   /**
+    * bin - histogram bin for value.
+    * @param   value - const std::uint64_t
+    * @return  std::size_t
+    */
+   inline std::size_t bin( const std::uint64_t value )
+   {
+      return( value == 0 ? 0 : 64 - __builtin_clzll( value ) );
+   }
+
+   /**
+    * Histogram - log2 binned, a single thread adds to it and
+    * any thread may read it, so increments are a plain load
+    * and store rather than a locked add.
+    */
+   struct Histogram
+   {
+      Histogram()
+      {
+         for( auto &b : bin )
+         {
+            b.store( 0, std::memory_order_relaxed );
+         }
+      }
+
+      void add( const std::uint64_t value )
+      {
+         auto &b( bin[ Stats::bin( value ) ] );
+         b.store( b.load( std::memory_order_relaxed ) + 1,
+                  std::memory_order_relaxed );
+      }
+
+      std::atomic< std::uint64_t > bin[ bins ];
+   };
+
+   /**
+    * Side - counters kept by one end of a queue, on their own
+    * cache line(s) so the two ends don't false share.
+    */
+   struct alignas( L1D_CACHE_LINE_SIZE ) Side
+   {
+      Side() : items( 0 ), blocked_cycles( 0 ), episodes( 0 )
+      {
+      }
+
+      /** single writer, see Histogram **/
+      static void bump( std::atomic< std::uint64_t > &counter,
+                        const std::uint64_t n )
+      {
+         counter.store( counter.load( std::memory_order_relaxed ) + n,
+                        std::memory_order_relaxed );
+      }
+
+      /** items that have gone through this end **/
+      std::atomic< std::uint64_t >  items;
+      /** total time spent waiting on the other end **/
+      std::atomic< std::uint64_t >  blocked_cycles;
+      /** number of times this end had to wait **/
+      std::atomic< std::uint64_t >  episodes;
+      /** length of each wait in cycles **/
+      Histogram                     episode_cycles;
+   };
+
+   /**
+    * Counters - everything kept for one queue, the producer
+    * owns write and occupancy, the consumer owns read.
+    */
+   struct Counters
+   {
+      Counters() : capacity( 0 )
+      {
+      }
+
+      /**
+       * create - the counters are cache line aligned and the
+       * queues holding them are allocated with plain new, which
+       * won't honor that before C++17, so they live apart.
+       * @return  Counters*
+       */
+      static Counters* create();
+
+      /**
+       * destroy - counterpart to create.
+       * @param   counters - Counters*
+       */
+      static void destroy( Counters *counters );
+
+      Side                          write;
+      Side                          read;
+      /** items in the queue, sampled by the producer **/
+      alignas( L1D_CACHE_LINE_SIZE ) Histogram occupancy;
+      std::atomic< std::uint64_t >  capacity;
+   };
+
+   /**
+    * Snapshot - plain copy of a queue's Counters taken by
+    * Registry::snapshot().
+    */
+   struct Snapshot
+   {
+      struct Side
+      {
+         std::uint64_t                          items;
+         std::uint64_t                          blocked_cycles;
+         std::uint64_t                          episodes;
+         std::array< std::uint64_t, bins >      episode_cycles;
+      };
+
+      std::uint64_t                             id;
+      std::string                               label;
+      std::uint64_t                             capacity;
+      Side                                      write;
+      Side                                      read;
+      std::array< std::uint64_t, bins >         occupancy;
+   };
+
+   /**
+    * operator << - one line per side plus the non-empty
+    * histogram bins, for dumping to a log.
+    */
+   std::ostream& operator << ( std::ostream &stream, const Snapshot &snapshot );
+
+   /**
+    * Registry - every instrumented queue in the process.  Queues
+    * add themselves when built and remove themselves when
+    * destroyed, snapshot() can be called from any thread at any
+    * time without stopping traffic, each counter is read
+    * atomically but a snapshot as a whole isn't a single
+    * instant.
+    */
+   class Registry
+   {
+   public:
+      /** the process wide registry **/
+      static Registry& instance();
+
+      /**
+       * add - registers counters, returns its id.
+       * @param   counters - const Counters*
+       * @return  std::uint64_t
+       */
+      std::uint64_t add( const Counters *counters );
+
+      /**
+       * remove - counters won't be read again once this returns.
+       * @param   counters - const Counters*
+       */
+      void remove( const Counters *counters );
+
+      /**
+       * label - names a queue in later snapshots.
+       * @param   counters - const Counters*
+       * @param   label    - const std::string&
+       */
+      void label( const Counters *counters, const std::string &label );
+
+      /**
+       * snapshot - copies out the counters of every registered
+       * queue, in the order they were registered.
+       * @return  std::vector< Snapshot >
+       */
+      std::vector< Snapshot > snapshot();
+
+   private:
+      Registry();
+
+      struct Entry
+      {
+         std::uint64_t     id;
+         const Counters   *counters;
+         std::string       label;
+      };
+
+      std::mutex              mutex;
+      std::vector< Entry >    entries;
+      std::uint64_t           next_id;
+   };
+
+   /**
+    * Probe - what the ring buffers actually hold, the enabled
+    * version owns a Counters and keeps it registered for its
+    * lifetime, the disabled one is empty and every call is a
+    * no-op.  start() / *_blocked() bracket a wait, the length
+    * of it is measured in cycles().
+    */
+   template < bool enabled > class Probe
+   {
+   public:
+      Probe() : counters( Counters::create() )
+      {
+         Registry::instance().add( counters );
+      }
+
+      ~Probe()
+      {
+         Registry::instance().remove( counters );
+         Counters::destroy( counters );
+      }
+
+      Probe( const Probe& ) = delete;
+      Probe& operator = ( const Probe& ) = delete;
+
+      void label( const std::string &label )
+      {
+         Registry::instance().label( counters, label );
+      }
+
+      void capacity( const std::size_t cap )
+      {
+         counters->capacity.store( cap, std::memory_order_relaxed );
+      }
+
+      /** producer, n items published, occupancy is what's queued after **/
+      template < class F > void wrote( const std::size_t n, F &&occupancy )
+      {
+         const auto before( counters->write.items.load( std::memory_order_relaxed ) );
+         Side::bump( counters->write.items, n );
+         /** sample whenever the count crosses a multiple of the period **/
+         if( ( before ^ ( before + n ) ) >= FIFO_INSTRUMENT_SAMPLE )
+         {
+            counters->occupancy.add( occupancy() );
+         }
+      }
+
+      /** consumer, n items released **/
+      void read( const std::size_t n )
+      {
+         Side::bump( counters->read.items, n );
+      }
+
+      std::uint64_t start() const
+      {
+         return( cycles() );
+      }
+
+      void write_blocked( const std::uint64_t start )
+      {
+         blocked( counters->write, start );
+      }
+
+      void read_blocked( const std::uint64_t start )
+      {
+         blocked( counters->read, start );
+      }
+
+   private:
+      static void blocked( Side &side, const std::uint64_t start )
+      {
+         const auto end( cycles() );
+         const auto length( end > start ? end - start : 0 );
+         Side::bump( side.blocked_cycles, length );
+         Side::bump( side.episodes, 1 );
+         side.episode_cycles.add( length );
+      }
+
+      /** over aligned, so not held by value, see Counters::create **/
+      Counters *const counters;
+   };
+
+   template <> class Probe< false >
+   {
+   public:
+      void label( const std::string &label )
+      {
+      }
+
+      void capacity( const std::size_t cap )
+      {
+      }
+
+      template < class F > void wrote( const std::size_t n, F &&occupancy )
+      {
+      }
+
+      void read( const std::size_t n )
+      {
+      }
+
+      std::uint64_t start() const
+      {
+         return( 0 );
+      }
+
+      void write_blocked( const std::uint64_t start )
+      {
+      }
+
+      void read_blocked( const std::uint64_t start )
+      {
+      }
+   };
+
+   /** the probe the queues use, picked by FIFO_INSTRUMENT **/
+   using FIFOProbe = Probe< FIFO_INSTRUMENT != 0 >;
+}
+#endif /* END _INSTRUMENT_HPP_ */
@@ -0,0 +1,165 @@
+/**
+ * notifier.hpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 14:05:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NOTIFIER_HPP_
+#define _NOTIFIER_HPP_  1
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace Select
+{
+   /**
+    * Notifier - what a FIFOSelector sleeps on.  The selector
+    * arms it before it sleeps, the first queue to publish after
+    * that disarms it and wakes the selector (futex) and marks
+    * the eventfd readable (Linux) so the selector can also sit
+    * in somebody else's epoll loop.  One-shot, so while nobody
+    * is waiting a publish costs a fence and a load.
+    */
+   class Notifier
+   {
+   public:
+      Notifier();
+
+      /** closes the eventfd **/
+      ~Notifier();
+
+      Notifier( const Notifier& ) = delete;
+      Notifier& operator = ( const Notifier& ) = delete;
+
+      /**
+       * notify - called by a queue after it has published,
+       * wakes the selector if it is armed.
+       */
+      void notify()
+      {
+         /** pairs with the fence in arm() **/
+         std::atomic_thread_fence( std::memory_order_seq_cst );
+         if( armed.load( std::memory_order_relaxed ) != 0 &&
+             armed.exchange( 0, std::memory_order_relaxed ) != 0 )
+         {
+            wake();
+         }
+      }
+
+      /**
+       * arm - selector side, the next notify() wakes us,
+       * readiness must be checked again after this returns.
+       * @return  std::uint32_t, pass to wait()
+       */
+      std::uint32_t arm()
+      {
+         armed.store( 1, std::memory_order_relaxed );
+         std::atomic_thread_fence( std::memory_order_seq_cst );
+         return( epoch.load( std::memory_order_relaxed ) );
+      }
+
+      /**
+       * wait - selector side, sleeps until notify() or timeout,
+       * may return spuriously.
+       * @param   seen    - const std::uint32_t, from arm()
+       * @param   timeout - const std::chrono::nanoseconds, max
+       *                    for none
+       */
+      void wait( const std::uint32_t seen, const std::chrono::nanoseconds timeout );
+
+      /**
+       * fd - eventfd that turns readable when the notifier is
+       * fired, -1 where there are no eventfds.
+       * @return  int
+       */
+      int fd() const
+      {
+         return( event_fd );
+      }
+
+      /**
+       * drain - resets the eventfd, the selector does this
+       * before each scan.
+       */
+      void drain();
+
+   private:
+      /** the slow part of notify(), out of line **/
+      void wake();
+
+      std::atomic< std::uint32_t >  armed;
+      std::atomic< std::uint32_t >  epoch;
+      int                           event_fd;
+   };
+
+   /**
+    * Hook - where a FIFO keeps the notifier watching one of
+    * its ends, if any.  Checked after every publish, a null
+    * load when nothing is watching.  detach() doesn't return
+    * until nobody is inside fire() so the notifier can go away
+    * right after.
+    */
+   class Hook
+   {
+   public:
+      Hook() : notifier( nullptr ),
+               busy( 0 )
+      {
+      }
+
+      /** called by the side that publishes **/
+      void fire()
+      {
+         if( notifier.load( std::memory_order_relaxed ) == nullptr )
+         {
+            return;
+         }
+         busy.fetch_add( 1, std::memory_order_seq_cst );
+         auto *current( notifier.load( std::memory_order_seq_cst ) );
+         if( current != nullptr )
+         {
+            current->notify();
+         }
+         busy.fetch_sub( 1, std::memory_order_release );
+      }
+
+      void attach( Notifier *n )
+      {
+         notifier.store( n, std::memory_order_seq_cst );
+      }
+
+      void detach()
+      {
+         notifier.store( nullptr, std::memory_order_seq_cst );
+         while( busy.load( std::memory_order_seq_cst ) != 0 )
+         {
+            /** a publish is part way through notify() **/
+            std::this_thread::yield();
+         }
+      }
+
+      bool attached() const
+      {
+         return( notifier.load( std::memory_order_relaxed ) != nullptr );
+      }
+
+   private:
+      std::atomic< Notifier* >      notifier;
+      std::atomic< std::uint32_t >  busy;
+   };
+}
+#endif /* END _NOTIFIER_HPP_ */
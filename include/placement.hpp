@@ -0,0 +1,147 @@
+/**
+ * placement.hpp -
+ * @author: Jonathan Beard
+ * @version: Mon Oct 19 09:12:44 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _PLACEMENT_HPP_
+#define _PLACEMENT_HPP_  1
+#include <cstddef>
+
+/**
+ * NUMA placement for heap queues and the threads using them.
+ * Memory is placed with mbind( MPOL_PREFERRED ) before it is
+ * first touched, so a full node falls back to another rather
+ * than failing.  Everything here is a hint: without NUMA
+ * (or off Linux) nothing is moved and the calls return false.
+ */
+namespace Placement
+{
+   /** leave it to the first thread that touches the pages **/
+   constexpr int Any      = -1;
+   /** the node of the thread constructing the queue **/
+   constexpr int Local    = -2;
+   /** wherever the read index goes, store only **/
+   constexpr int Consumer = -3;
+
+   /**
+    * Options - where a heap RingBuffer puts its parts.  Each
+    * index is written by one end so it should sit on that
+    * end's node, the store is usually best next to the
+    * consumer, who takes the misses on every item.
+    */
+   struct Options
+   {
+      Options( const int store    = Any,
+               const int read     = Any,
+               const int write    = Any,
+               const bool prefault = false ) : store( store ),
+                                               read( read ),
+                                               write( write ),
+                                               prefault( prefault )
+      {
+      }
+
+      /**
+       * across - a queue from a producer on node producer to a
+       * consumer on node consumer, pages faulted in up front.
+       * @param   producer - const int
+       * @param   consumer - const int
+       * @return  Options
+       */
+      static Options across( const int producer, const int consumer )
+      {
+         return( Options( Consumer, consumer, producer, true ) );
+      }
+
+      /**
+       * resolved - Local and Consumer turned into node numbers,
+       * the queue keeps the result so a resize lands on the
+       * same nodes whichever thread does it.
+       * @return  Options
+       */
+      Options resolved() const;
+
+      bool placed() const
+      {
+         return( store != Any || read != Any || write != Any );
+      }
+
+      /** node for the store and signal array **/
+      int   store;
+      /** node for the read index (consumer writes it) **/
+      int   read;
+      /** node for the write index (producer writes it) **/
+      int   write;
+      /** touch every page at construction, not on first use **/
+      bool  prefault;
+   };
+
+   /**
+    * nodes - number of NUMA nodes, 1 without NUMA.
+    * @return  int
+    */
+   int nodes();
+
+   /**
+    * current_node - node the calling thread is running on
+    * right now, 0 if that can't be told.
+    * @return  int
+    */
+   int current_node();
+
+   /**
+    * page_size - the page granularity placement works at.
+    * @return  std::size_t
+    */
+   std::size_t page_size();
+
+   /**
+    * bind - prefers node for the pages in [ ptr, ptr + length ),
+    * ptr must be page aligned and nothing in the range touched
+    * yet.
+    * @param   ptr    - void*
+    * @param   length - const std::size_t
+    * @param   node   - const int, Any does nothing
+    * @return  bool, false if the pages weren't bound
+    */
+   bool bind( void *ptr, const std::size_t length, const int node );
+
+   /**
+    * prefault - writes one byte per page so the pages are
+    * there before the queue is used, only for raw storage.
+    * @param   ptr    - void*
+    * @param   length - const std::size_t
+    */
+   void prefault( void *ptr, const std::size_t length );
+
+   /**
+    * pin - restricts the calling thread to the CPUs of node,
+    * e.g. the producer with Options::write and the consumer
+    * with Options::read.
+    * @param   node - const int
+    * @return  bool, false if the affinity wasn't changed
+    */
+   bool pin( const int node );
+
+   /**
+    * pin_cpu - restricts the calling thread to cpu.
+    * @param   cpu - const int
+    * @return  bool
+    */
+   bool pin_cpu( const int cpu );
+}
+#endif /* END _PLACEMENT_HPP_ */
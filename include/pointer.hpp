@@ -22,29 +22,58 @@
 
 #include <cstdlib>
 #include <cstdint>
+#include <atomic>
+#include <chrono>
+
+#include "futex.hpp"
+
+/**
+ * L1D_CACHE_LINE_SIZE - the read and write pointers are each 
+ * padded out to this so that the producer and consumer never
+ * share a line, override at compile time if the target differs.
+ */
+#ifndef L1D_CACHE_LINE_SIZE
+#define L1D_CACHE_LINE_SIZE 64
+#endif
 
 class Pointer{
 public:
    /**
     * Pointer - used to synchronize read and write
-    * pointers for the ring buffer.  This class encapsulates
-    * wrapping.
+    * pointers for the ring buffer.  Internally each
+    * pointer is a monotonically increasing 64-bit 
+    * count of the items that have passed through it,
+    * the index into the buffer is that count modulo
+    * the capacity, so there is no wrap bookkeeping.
+    * Each pointer has exactly one writer (the producer
+    * for the write pointer, the consumer for the read
+    * pointer), stores are release and remote loads are
+    * acquire.
     */
    Pointer( const size_t cap );
 
    /**
-    * val - returns the current value of val.  Internally
-    * the function checks to ensure that any writes to the
-    * pointer have fully completed so that the value returned
-    * is ensured to be the correct one.  This is important
-    * as it means the producer will only see a "conservative"
+    * val - returns the current index into the buffer 
+    * for this pointer.  This is only meaningful to the
+    * owning side, the producer will only see a "conservative"
     * estimate of how many items can be written and the 
     * consumer will only see a "conservative" estimate of how
     * many items can be read.
-    * @return size_t, current 'true' value of the pointer
+    * @return size_t, current index of the pointer
     */
    static size_t val( Pointer *ptr );
 
+   /**
+    * masked - val() for a capacity that is a power of two 
+    * known at compile time, the index is the position 
+    * masked with cap - 1 rather than divided.  Only valid
+    * on the owning side.
+    * @param   ptr  - Pointer*, owned by the caller
+    * @param   mask - const size_t, cap - 1
+    * @return  size_t, current index of the pointer
+    */
+   static size_t masked( Pointer *ptr, const size_t mask );
+
    /**
     * inc - increments the pointer, takes care of wrapping
     * the pointers as well so you don't run off the page
@@ -61,29 +90,201 @@ public:
     */
    static size_t incBy( const size_t in, Pointer *ptr );
 
-   
    /**
-    * wrapIndiciator - returns the current wrap position, 
-    * the read should never be ahead of the write, and 
-    * at best they should be equal.  This is used when
-    * determining to return max_cap or zero for the current
-    * queue size.  
+    * position - returns the total count of items that
+    * have passed this pointer, loaded with acquire 
+    * semantics so that it is safe to call from the 
+    * side that doesn't own the pointer.
+    * @return std::uint64_t
+    */
+   static std::uint64_t position( Pointer *ptr );
+
+   /**
+    * space - producer side, returns the number of slots
+    * that can be written without blocking.  The producer
+    * keeps a cached copy of the read position in its own
+    * pointer and only loads the consumer's line when the
+    * cached copy says there is less than 'needed' space.
+    * @param   write_pt - Pointer*, owned by the caller
+    * @param   read_pt  - Pointer*, owned by the consumer
+    * @param   needed   - const size_t, default 1
+    * @return  size_t
+    */
+   static size_t space( Pointer *write_pt, 
+                        Pointer *read_pt,
+                        const size_t needed = 1 );
+
+   /**
+    * avail - consumer side, returns the number of items 
+    * that can be read without blocking.  Mirror image of
+    * space(), the cached write position is only refreshed
+    * when fewer than 'needed' items appear to be present.
+    * @param   read_pt  - Pointer*, owned by the caller
+    * @param   write_pt - Pointer*, owned by the producer
+    * @param   needed   - const size_t, default 1
     * @return  size_t
     */
-   static size_t wrapIndicator( Pointer *ptr );
+   static size_t avail( Pointer *read_pt, 
+                        Pointer *write_pt,
+                        const size_t needed = 1 );
+
+   /**
+    * remote - the position of the opposite pointer as last
+    * seen by space() or avail(), a plain read of the cached
+    * copy in ptr, nothing is loaded from the opposite pointer.
+    * The acquire load happens when space() or avail() refresh
+    * the cache, so everything published before the returned
+    * position is already visible to the caller.  Owning side
+    * only.
+    * @param   ptr - Pointer*, owned by the caller
+    * @return  std::uint64_t
+    */
+   static std::uint64_t remote( Pointer *ptr );
+
+   /**
+    * park - called by the side waiting on ptr to move, 
+    * registers as a waiter, re-checks ready() and if it
+    * still returns false blocks until the owner of ptr 
+    * calls wake() or timeout passes.  May return spuriously,
+    * callers loop.
+    * @param   ptr     - Pointer*, owned by the other side
+    * @param   ready   - F, returns true once no need to wait
+    * @param   timeout - const std::chrono::nanoseconds, default
+    *                    is no timeout
+    */
+   template < class F > static void park( Pointer *ptr, 
+                                          F &&ready,
+                                          const std::chrono::nanoseconds timeout = 
+                                             std::chrono::nanoseconds::max() );
+
+   /**
+    * wake - called by the owner of ptr after moving it, 
+    * wakes anything parked on ptr.  Only needed if the
+    * queue is using the Wait::Park strategy, the cost is
+    * a full fence even when nothing is parked.
+    * @param   ptr - Pointer*, owned by the caller
+    */
+   static void wake( Pointer *ptr );
    
 private:
-   volatile std::uint64_t           a;
-   volatile std::uint64_t           b;
-   /**
-    * size of wrap pointer might become an issue
-    * if GHz increase drastically or if this runs
-    * for a really really long time.
-    * TODO, get these set correctly if we do eventually
-    * wrap an unsigned 64 int.
+   /** only ever stored to by the owning side **/
+   alignas( L1D_CACHE_LINE_SIZE ) 
+   std::atomic< std::uint64_t >     pos;
+   const    size_t                  max_cap;
+   /** 
+    * threads parked waiting on this pointer to move and the 
+    * futex word they sleep on, only written when parking.
+    */
+   std::atomic< std::uint32_t >     waiters;
+   std::atomic< std::uint32_t >     epoch;
+   /** 
+    * last seen position of the opposite pointer, 
+    * touched only by the owning side so it gets 
+    * its own line as well.
     */
-   volatile std::uint64_t    wrap_a;
-   volatile std::uint64_t    wrap_b;
-   const    size_t           max_cap;
+   alignas( L1D_CACHE_LINE_SIZE ) 
+   std::uint64_t                    cached_remote;
 };
+
+/**
+ * the functions below are on the path of every push and 
+ * pop, they're defined here so that they can be inlined.
+ */
+inline size_t
+Pointer::val( Pointer *ptr )
+{
+   return( ptr->pos.load( std::memory_order_acquire ) % ptr->max_cap );
+}
+
+inline size_t
+Pointer::masked( Pointer *ptr, const size_t mask )
+{
+   /** only the owner stores to pos, a relaxed load sees its own writes **/
+   return( ptr->pos.load( std::memory_order_relaxed ) & mask );
+}
+
+inline size_t 
+Pointer::inc( Pointer *ptr )
+{
+   return( Pointer::incBy( 1, ptr ) );
+}
+
+inline size_t 
+Pointer::incBy( const size_t in, Pointer *ptr )
+{
+   /** single writer, no need for a locked RMW **/
+   const std::uint64_t next( ptr->pos.load( std::memory_order_relaxed ) + in );
+   ptr->pos.store( next, std::memory_order_release );
+   return( next % ptr->max_cap );
+}
+
+inline std::uint64_t
+Pointer::position( Pointer *ptr )
+{
+   return( ptr->pos.load( std::memory_order_acquire ) );
+}
+
+inline std::uint64_t
+Pointer::remote( Pointer *ptr )
+{
+   return( ptr->cached_remote );
+}
+
+inline size_t
+Pointer::space( Pointer *write_pt, Pointer *read_pt, const size_t needed )
+{
+   const std::uint64_t wpos( write_pt->pos.load( std::memory_order_relaxed ) );
+   size_t free_slots( write_pt->max_cap - ( wpos - write_pt->cached_remote ) );
+   if( free_slots < needed )
+   {
+      write_pt->cached_remote = read_pt->pos.load( std::memory_order_acquire );
+      free_slots = write_pt->max_cap - ( wpos - write_pt->cached_remote );
+   }
+   return( free_slots );
+}
+
+inline size_t
+Pointer::avail( Pointer *read_pt, Pointer *write_pt, const size_t needed )
+{
+   const std::uint64_t rpos( read_pt->pos.load( std::memory_order_relaxed ) );
+   size_t items( read_pt->cached_remote - rpos );
+   if( items < needed )
+   {
+      read_pt->cached_remote = write_pt->pos.load( std::memory_order_acquire );
+      items = read_pt->cached_remote - rpos;
+   }
+   return( items );
+}
+
+template < class F > inline void
+Pointer::park( Pointer *ptr, F &&ready, const std::chrono::nanoseconds timeout )
+{
+   ptr->waiters.fetch_add( 1, std::memory_order_relaxed );
+   /** pairs with the fence in wake() **/
+   std::atomic_thread_fence( std::memory_order_seq_cst );
+   const std::uint32_t epoch( ptr->epoch.load( std::memory_order_relaxed ) );
+   if( ! ready() )
+   {
+      if( timeout == std::chrono::nanoseconds::max() )
+      {
+         Futex::wait( &ptr->epoch, epoch );
+      }
+      else
+      {
+         Futex::wait_for( &ptr->epoch, epoch, timeout );
+      }
+   }
+   ptr->waiters.fetch_sub( 1, std::memory_order_relaxed );
+}
+
+inline void
+Pointer::wake( Pointer *ptr )
+{
+   std::atomic_thread_fence( std::memory_order_seq_cst );
+   if( ptr->waiters.load( std::memory_order_relaxed ) > 0 )
+   {
+      ptr->epoch.fetch_add( 1, std::memory_order_relaxed );
+      Futex::wake( &ptr->epoch );
+   }
+}
 #endif /* END _POINTER_HPP_ */
@@ -0,0 +1,422 @@
+/**
+ * recordbuffer.tcc -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 17:12:54 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RECORDBUFFER_TCC_
+#define _RECORDBUFFER_TCC_  1
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "pointer.hpp"
+#include "ringbuffertypes.hpp"
+#include "signalvars.hpp"
+#include "shm.hpp"
+#include "waitstrategy.hpp"
+
+/**
+ * RecordView - a record as seen by the consumer, data points
+ * straight into the buffer and stays valid until recycle().
+ */
+struct RecordView
+{
+   const void     *data;
+   std::size_t     length;
+   RBSignal        signal;
+};
+
+/**
+ * RecordBufferBase - single producer / single consumer ring of
+ * variable length records.  Every record is an eight byte header
+ * followed by the payload padded out to eight bytes, the read and
+ * write pointers count bytes.  A record is never split across the
+ * end of the ring, if it doesn't fit the producer fills the rest
+ * with a padding record that the consumer steps over.  The largest
+ * record that fits is max_record() bytes.
+ */
+class RecordBufferBase
+{
+public:
+   RecordBufferBase() : store( nullptr ),
+                        read_pt( nullptr ),
+                        write_pt( nullptr ),
+                        max_cap( 0 ),
+                        reserved( 0 ),
+                        peeked( 0 )
+   {
+   }
+
+   virtual ~RecordBufferBase() = default;
+
+   /**
+    * capacity - size of the ring in bytes, headers and
+    * padding included.
+    * @return  std::size_t
+    */
+   std::size_t capacity() const
+   {
+      return( max_cap );
+   }
+
+   /**
+    * max_record - largest payload a single record can have.
+    * @return  std::size_t
+    */
+   std::size_t max_record() const
+   {
+      return( max_cap - sizeof( Header ) );
+   }
+
+   /**
+    * size - bytes currently in use, headers and padding
+    * included.
+    * @return  std::size_t
+    */
+   std::size_t size()
+   {
+      const auto rpt( Pointer::position( read_pt  ) );
+      const auto wpt( Pointer::position( write_pt ) );
+      const std::size_t diff( wpt - rpt );
+      return( diff > max_cap ? max_cap : diff );
+   }
+
+   /**
+    * reserve - returns n writeable bytes in place at the tail
+    * of the ring, blocks until there is room.  Nothing is
+    * visible to the consumer until commit().  Calling reserve
+    * again before commit drops the first reservation.
+    * @param   n - const std::size_t, <= max_record()
+    * @return  void*, eight byte aligned
+    */
+   void* reserve( const std::size_t n )
+   {
+      assert( n <= max_record() && n <= UINT32_MAX );
+      const std::size_t needed( sizeof( Header ) + pad( n ) );
+      std::size_t index( Pointer::val( write_pt ) );
+      if( max_cap - index < needed )
+      {
+         /** won't fit before the end, fill it in and wrap **/
+         const std::size_t rest( max_cap - index );
+         wait_space( rest );
+         write_header( index, rest - sizeof( Header ), RBSignal::NONE, pad_record );
+         publish_write( rest );
+         index = 0;
+      }
+      wait_space( needed );
+      reserved = n;
+      return( store + index + sizeof( Header ) );
+   }
+
+   /**
+    * commit - releases the first n bytes of the last reservation
+    * to the consumer as a single record.
+    * @param   n      - const std::size_t, <= reserved
+    * @param   signal - const RBSignal, default: NONE
+    */
+   void commit( const std::size_t n, const RBSignal signal = RBSignal::NONE )
+   {
+      assert( n <= reserved );
+      write_header( Pointer::val( write_pt ), n, signal, 0 );
+      publish_write( sizeof( Header ) + pad( n ) );
+      reserved = 0;
+   }
+
+   /**
+    * push - copies n bytes at ptr into the ring as one record.
+    * @param   ptr    - const void*
+    * @param   n      - const std::size_t
+    * @param   signal - const RBSignal, default: NONE
+    */
+   void push( const void *ptr, const std::size_t n, const RBSignal signal = RBSignal::NONE )
+   {
+      std::memcpy( reserve( n ), ptr, n );
+      commit( n, signal );
+   }
+
+   /**
+    * peek - returns a view of the record at the head of the
+    * ring without copying it, blocks until there is one.  The
+    * view is valid until recycle() is called.
+    * @return  RecordView
+    */
+   RecordView peek()
+   {
+      while( true )
+      {
+         wait_items( sizeof( Header ) );
+         const std::size_t index( Pointer::val( read_pt ) );
+         Header head;
+         std::memcpy( &head, store + index, sizeof( Header ) );
+         const std::size_t length( sizeof( Header ) + pad( head.length ) );
+         if( head.flags & pad_record )
+         {
+            publish_read( length );
+            continue;
+         }
+         peeked = length;
+         return( RecordView{ store + index + sizeof( Header ),
+                             head.length,
+                             static_cast< RBSignal >( head.signal ) } );
+      }
+   }
+
+   /**
+    * recycle - releases the record returned by the last call
+    * to peek(), does nothing if there wasn't one.
+    */
+   void recycle()
+   {
+      if( peeked == 0 )
+      {
+         return;
+      }
+      publish_read( peeked );
+      peeked = 0;
+   }
+
+   /**
+    * set_wait_policy - sets what the producer and consumer
+    * do while blocked, both ends must match.
+    * @param   policy - const Wait::Policy&
+    */
+   void set_wait_policy( const Wait::Policy &policy )
+   {
+      wait_policy = policy;
+   }
+
+protected:
+   /**
+    * Header - precedes every record, length is the payload
+    * length before padding.
+    */
+   struct Header
+   {
+      std::uint32_t  length;
+      std::uint16_t  signal;
+      std::uint16_t  flags;
+   };
+   static_assert( sizeof( Header ) == 8, "record header must be eight bytes" );
+
+   /** Header::flags, record is padding up to the end of the ring **/
+   static constexpr std::uint16_t pad_record = 0x1;
+
+   /** pad - rounds n up to a whole number of headers **/
+   static std::size_t pad( const std::size_t n )
+   {
+      return( ( n + sizeof( Header ) - 1 ) & ~( sizeof( Header ) - 1 ) );
+   }
+
+   void write_header( const std::size_t index,
+                      const std::size_t length,
+                      const RBSignal signal,
+                      const std::uint16_t flags )
+   {
+      const Header head{ static_cast< std::uint32_t >( length ),
+                         static_cast< std::uint16_t >( signal ),
+                         flags };
+      std::memcpy( store + index, &head, sizeof( Header ) );
+   }
+
+   void wait_space( const std::size_t needed )
+   {
+      auto ready( [&]() -> bool
+      {
+         return( Pointer::space( write_pt, read_pt, needed ) >= needed );
+      } );
+      Wait::Backoff backoff( wait_policy );
+      while( ! ready() )
+      {
+         backoff.wait( read_pt, ready );
+      }
+   }
+
+   void wait_items( const std::size_t needed )
+   {
+      auto ready( [&]() -> bool
+      {
+         return( Pointer::avail( read_pt, write_pt, needed ) >= needed );
+      } );
+      Wait::Backoff backoff( wait_policy );
+      while( ! ready() )
+      {
+         backoff.wait( write_pt, ready );
+      }
+   }
+
+   void publish_write( const std::size_t n )
+   {
+      Pointer::incBy( n, write_pt );
+      if( wait_policy.strategy == Wait::Park )
+      {
+         Pointer::wake( write_pt );
+      }
+   }
+
+   void publish_read( const std::size_t n )
+   {
+      Pointer::incBy( n, read_pt );
+      if( wait_policy.strategy == Wait::Park )
+      {
+         Pointer::wake( read_pt );
+      }
+   }
+
+   /** rounds a requested capacity to a whole number of headers **/
+   static std::size_t ring_bytes( const std::size_t bytes )
+   {
+      const std::size_t rounded( pad( bytes ) );
+      return( rounded < 2 * sizeof( Header ) ? 2 * sizeof( Header ) : rounded );
+   }
+
+   char          *store;
+   Pointer       *read_pt;
+   Pointer       *write_pt;
+   std::size_t    max_cap;
+   /** producer local, bytes handed out by the last reserve **/
+   std::size_t    reserved;
+   /** consumer local, bytes held by the last peek **/
+   std::size_t    peeked;
+   Wait::Policy   wait_policy;
+};
+
+template < Type::RingBufferType type = Type::Heap > class RecordBuffer;
+
+/**
+ * Heap - both ends in the same process
+ */
+template <> class RecordBuffer< Type::Heap > : public RecordBufferBase
+{
+public:
+   /**
+    * RecordBuffer - allocates a ring of at least bytes bytes.
+    * @param   bytes  - const std::size_t
+    * @param   policy - const Wait::Policy&, what to do when blocked
+    */
+   RecordBuffer( const std::size_t bytes,
+                 const Wait::Policy &policy = Wait::Policy() ) : RecordBufferBase()
+   {
+      max_cap = ring_bytes( bytes );
+      int ret_val( posix_memalign( (void**)&store, L1D_CACHE_LINE_SIZE, max_cap ) );
+      if( ret_val != 0 )
+      {
+         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+         exit( EXIT_FAILURE );
+      }
+      read_pt  = new_pointer( max_cap );
+      write_pt = new_pointer( max_cap );
+      wait_policy = policy;
+   }
+
+   virtual ~RecordBuffer()
+   {
+      read_pt->~Pointer();
+      free( read_pt );
+      write_pt->~Pointer();
+      free( write_pt );
+      free( store );
+   }
+
+private:
+   static Pointer* new_pointer( const std::size_t max_cap )
+   {
+      void *mem( nullptr );
+      const int ret_val( posix_memalign( &mem, L1D_CACHE_LINE_SIZE, sizeof( Pointer ) ) );
+      if( ret_val != 0 )
+      {
+         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+         exit( EXIT_FAILURE );
+      }
+      return( new ( mem ) Pointer( max_cap ) );
+   }
+};
+
+/**
+ * SharedMemory - the ring lives in a single SHM::Segment, the
+ * consumer may pass zero bytes and take the size from the
+ * segment header.
+ */
+template <> class RecordBuffer< Type::SharedMemory > : public RecordBufferBase
+{
+public:
+   /**
+    * RecordBuffer - opens one end of a record ring in SHM.
+    * @param   bytes      - const std::size_t, ring size, 0 on the consumer side
+    * @param   key        - const std::string, same for both ends
+    * @param   dir        - Direction, which end this is
+    * @param   policy     - const Wait::Policy&, what to do when blocked
+    * @param   huge_pages - const bool, producer only, use huge pages
+    */
+   RecordBuffer( const std::size_t   bytes,
+                 const std::string   key,
+                 Direction           dir,
+                 const Wait::Policy &policy = Wait::Policy(),
+                 const bool          huge_pages = false ) : RecordBufferBase(),
+                                                            segment( key )
+   {
+      try
+      {
+         if( dir == Direction::Producer )
+         {
+            segment.create( SHM::make_geometry( ring_bytes( bytes ),
+                                                1,
+                                                0,
+                                                SHM::record_layout,
+                                                L1D_CACHE_LINE_SIZE,
+                                                huge_pages ) );
+            const auto &g( segment.header().geometry );
+            read_pt  = new ( segment.at( g.read_offset  ) ) Pointer( g.capacity );
+            write_pt = new ( segment.at( g.write_offset ) ) Pointer( g.capacity );
+            segment.ready();
+         }
+         else
+         {
+            segment.attach();
+            const auto &g( segment.header().geometry );
+            if( g.layout != SHM::record_layout ||
+                ( bytes != 0 && g.capacity != ring_bytes( bytes ) ) )
+            {
+               throw bad_shm_alloc( "segment " + key + " isn't a matching record ring" );
+            }
+            read_pt  = reinterpret_cast< Pointer* >( segment.at( g.read_offset  ) );
+            write_pt = reinterpret_cast< Pointer* >( segment.at( g.write_offset ) );
+         }
+      }
+      catch( bad_shm_alloc &ex )
+      {
+         std::cerr << "Bad SHM allocate for key (" << key << ")\n";
+         std::cerr << "Message: " << ex.what() << ", exiting.\n";
+         exit( EXIT_FAILURE );
+      }
+      const auto &g( segment.header().geometry );
+      max_cap     = g.capacity;
+      store       = reinterpret_cast< char* >( segment.at( g.store_offset ) );
+      wait_policy = policy;
+   }
+
+   virtual ~RecordBuffer() = default;
+
+private:
+   SHM::Segment   segment;
+};
+#endif /* END _RECORDBUFFER_TCC_ */
@@ -17,8 +17,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  * 
- * Notes:  When using monitoring, the cycle counter is the most accurate for
- * Linux / Unix platforms.  It is really not suited to OS X's mach_absolute_time()
+ * Notes:  When using monitoring (FIFO_INSTRUMENT, see instrument.hpp), the 
+ * cycle counter is the most accurate for Linux / Unix platforms.  It is 
+ * really not suited to OS X's mach_absolute_time()
  * function since it is so slow relative to the movement of data, the 
  * results returned for high throughput systems are simply not accurate
  * on that platform.
@@ -42,24 +43,107 @@
 
 
 
+/**
+ * RingBuffer - with a non-zero SIZE (heap only, a power of 
+ * two) the capacity is fixed at compile time, the slots live
+ * in the same allocation as the pointers, indexing is a mask
+ * and the queue can't be resized.
+ */
 template < class T, 
-           Type::RingBufferType type = Type::Heap >  class RingBuffer : 
-               public RingBufferBase< T, type >
+           Type::RingBufferType type = Type::Heap,
+           Layout::SlotLayout layout = Layout::default_for( type ),
+           std::size_t SIZE = 0 >  class RingBuffer : 
+               public RingBufferBase< T, type, layout, SIZE >
 {
 public:
    /**
     * RingBuffer - default constructor, initializes basic
     * data structures.
+    * @param   n      - const std::size_t, capacity in items,
+    *                   must equal SIZE if that is set
+    * @param   align  - const std::size_t, store alignment,
+    *                   a cache line if SIZE is set
+    * @param   policy - const Wait::Policy&, what to do when blocked
+    */
+   RingBuffer( const std::size_t n, 
+               const std::size_t align = 16,
+               const Wait::Policy &policy = Wait::Policy() ) : 
+      RingBufferBase< T, type, layout, SIZE >()
+   {
+      (this)->attach_data( new Buffer::Data<T, type, layout, SIZE >( n, align ) );
+      (this)->set_wait_policy( policy );
+   }
+
+   /**
+    * RingBuffer - heap queue with its store, signals and 
+    * indices placed on NUMA nodes, see placement.hpp.  Local
+    * and Consumer are resolved here, on the constructing 
+    * thread, and kept for buffers made by resize().
+    * @param   n         - const std::size_t, capacity in items
+    * @param   align     - const std::size_t, store alignment
+    * @param   policy    - const Wait::Policy&
+    * @param   placement - const Placement::Options&
     */
-   RingBuffer( const std::size_t n, const std::size_t align = 16 ) : 
-      RingBufferBase< T, type >()
+   template < Type::RingBufferType B = type,
+              typename std::enable_if< B == Type::Heap && SIZE == 0, int >::type = 0 >
+   RingBuffer( const std::size_t n, 
+               const std::size_t align,
+               const Wait::Policy &policy,
+               const Placement::Options &placement ) : 
+      RingBufferBase< T, type, layout, SIZE >()
+   {
+      (this)->attach_data( new Buffer::Data<T, type, layout, SIZE >( n, 
+                                                                    align, 
+                                                                    placement.resolved() ) );
+      (this)->set_wait_policy( policy );
+   }
+
+   /**
+    * RingBuffer - heap queue built inside a FIFOArena, which
+    * also holds this object, see FIFOArena::make().
+    * @param   n      - const std::size_t, capacity in items
+    * @param   arena  - FIFOArena&
+    * @param   policy - const Wait::Policy&
+    */
+   template < Type::RingBufferType B = type,
+              typename std::enable_if< B == Type::Heap && SIZE == 0, int >::type = 0 >
+   RingBuffer( const std::size_t n, 
+               FIFOArena &arena,
+               const Wait::Policy &policy = Wait::Policy() ) : 
+      RingBufferBase< T, type, layout, SIZE >()
+   {
+      (this)->attach_data( Buffer::Data< T, type, layout, SIZE >::make( n, 
+                                                                       L1D_CACHE_LINE_SIZE,
+                                                                       arena ) );
+      (this)->set_wait_policy( policy );
+   }
+
+   /**
+    * arena_bytes - what the buffer of a queue of n items
+    * takes from a FIFOArena, see FIFOArena::bytes_for().
+    * @param   n - const std::size_t
+    * @return  std::size_t
+    */
+   static std::size_t arena_bytes( const std::size_t n )
+   {
+      return( Buffer::Data< T, type, layout, SIZE >::arena_bytes( n, L1D_CACHE_LINE_SIZE ) );
+   }
+
+   /**
+    * RingBuffer - constructor for a fixed capacity, SIZE
+    * items.
+    * @param   policy - const Wait::Policy&, what to do when blocked
+    */
+   template < std::size_t S = SIZE,
+              typename std::enable_if< S != 0, int >::type = 0 >
+   RingBuffer( const Wait::Policy &policy = Wait::Policy() ) : 
+      RingBuffer( SIZE, L1D_CACHE_LINE_SIZE, policy )
    {
-      (this)->data = new Buffer::Data<T, type >( n, align );
    }
 
    virtual ~RingBuffer()
    {
-      delete( (this)->data );
+      (this)->release_data();
    }
 
    /**
@@ -67,18 +151,40 @@ public:
     * allocate FIFO's at the time of execution.  The
     * first two parameters are self explanatory.  The
     * data ptr is a data struct that is dependent on the
-    * type of FIFO being built.  In there really is no
-    * data necessary so it is expacted to be set to nullptr
+    * type of FIFO being built.  For a heap queue it may be a
+    * FIFOArena* to build the queue in, which then owns it (the
+    * alignment is a cache line there), otherwise there really
+    * is no data necessary so it is expected to be nullptr.
     * @param   n_items - std::size_t
     * @param   align   - memory alignment
+    * @param   data    - void*, FIFOArena* or nullptr
     * @return  FIFO*
     */
    static FIFO* make_new_fifo( std::size_t n_items,
                                std::size_t align,
                                void *data )
    {
-      assert( data == nullptr );
-      return( new RingBuffer< T, Type::Heap >( n_items, align ) ); 
+      if( data != nullptr )
+      {
+         return( make_in_arena( n_items, 
+                                reinterpret_cast< FIFOArena* >( data ),
+                                std::integral_constant< bool, 
+                                                        type == Type::Heap && SIZE == 0 >() ) );
+      }
+      return( new RingBuffer< T, type, layout, SIZE >( n_items, align ) ); 
+   }
+
+private:
+   static FIFO* make_in_arena( const std::size_t n_items, FIFOArena *arena, std::true_type )
+   {
+      return( arena->make< RingBuffer< T, type, layout, SIZE > >( n_items ) );
+   }
+
+   static FIFO* make_in_arena( const std::size_t n_items, FIFOArena *arena, std::false_type )
+   {
+      std::cerr << "only heap queues with a run time capacity can be built in a FIFOArena, exiting.\n";
+      exit( EXIT_FAILURE );
+      return( nullptr );
    }
 
 };
@@ -89,33 +195,88 @@ public:
 /** 
  * SharedMemory 
  */
-template< class T > class RingBuffer< T, 
-                                      Type::SharedMemory > :
-                            public RingBufferBase< T, Type::SharedMemory >
+template< class T, 
+          Layout::SlotLayout layout > class RingBuffer< T, 
+                                                        Type::SharedMemory,
+                                                        layout > :
+                            public RingBufferBase< T, Type::SharedMemory, layout >
 {
+   /** the other process sees the bytes, not the objects **/
+   static_assert( std::is_trivially_copyable< T >::value,
+                  "Type::SharedMemory only carries trivially copyable types" );
+   /** the signals have to be in the segment for the other process **/
+   static_assert( layout != Layout::Sparse,
+                  "Type::SharedMemory keeps its signals in the segment" );
 public:
+   /**
+    * RingBuffer - opens one end of a queue in shared memory,
+    * the producer creates the segment, the consumer attaches
+    * to it and may pass zero for nitems to take the capacity
+    * from the segment.
+    * @param   nitems     - const std::size_t, capacity in items
+    * @param   key        - const std::string, same for both ends
+    * @param   dir        - Direction, which end this is
+    * @param   alignment  - const std::size_t, store alignment
+    * @param   policy     - const Wait::Policy&, what to do when blocked
+    * @param   huge_pages - const bool, producer only, use huge pages
+    */
    RingBuffer( const std::size_t      nitems,
                const std::string key,
                Direction         dir,
-               const std::size_t      alignment = 16 ) : 
-               RingBufferBase< T, Type::SharedMemory >(),
+               const std::size_t      alignment = 16,
+               const Wait::Policy     &policy = Wait::Policy(),
+               const bool             huge_pages = false ) : 
+               RingBufferBase< T, Type::SharedMemory, layout >(),
                                               shm_key( key )
    {
-      (this)->data = 
+      (this)->attach_data( 
          new Buffer::Data< T, 
-                           Type::SharedMemory >( nitems, key, dir, alignment );
+                           Type::SharedMemory,
+                           layout >( nitems, key, dir, alignment, huge_pages ) );
       assert( (this)->data != nullptr );
+      (this)->wait_policy = policy;
    }
 
    virtual ~RingBuffer()
    {
       delete( (this)->data );      
    }
+
+   /**
+    * get_signal - asynchronous signals don't cross the
+    * process boundary, use the per element signals.
+    * @return  RBSignal, always NONE
+    */
+   virtual RBSignal get_signal()
+   {
+      return( RBSignal::NONE );
+   }
+
+   /**
+    * send_signal - see get_signal().
+    * @param   signal - const RBSignal reference
+    * @return  bool, always false
+    */
+   virtual bool send_signal( const RBSignal &signal )
+   {
+      return( false );
+   }
+
+   /**
+    * notifies - the other end is in another process, a 
+    * selector has to poll this one.
+    * @return  bool, always false
+    */
+   virtual bool notifies() const
+   {
+      return( false );
+   }
   
    struct Data
    {
       const std::string key;
       Direction   dir;
+      bool        huge_pages;
    };
 
    /**
@@ -134,14 +295,21 @@ public:
                                void *data )
    {
       auto *data_ptr( reinterpret_cast< Data* >( data ) );
-      return( new RingBuffer< T, Type::SharedMemory>( n_items, 
+      return( new RingBuffer< T, Type::SharedMemory, layout >( n_items, 
                                                               data_ptr->key,
                                                               data_ptr->dir,
-                                                              align ) ); 
+                                                              align,
+                                                              Wait::Policy(),
+                                                              data_ptr->huge_pages ) ); 
    }
 
 protected:
    const  std::string shm_key;
 };
 
+/** 
+ * TCP, producer and consumer endpoints
+ */
+#include "ringbuffertcp.tcc"
+
 #endif /* END _RINGBUFFER_TCC_ */
@@ -27,27 +27,64 @@
 #include <cstring>
 #include <iostream>
 #include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <string>
 
+#include "async.hpp"
 #include "pointer.hpp"
 #include "ringbuffertypes.hpp"
 #include "bufferdata.tcc"
+#include "bulkcopy.hpp"
 #include "signalvars.hpp"
 #include "blocked.hpp"
 #include "fifo.hpp"
 #include "fifoabstract.tcc"
+#include "waitstrategy.hpp"
+#include "instrument.hpp"
 /**
- * Note: there is a NICE define that can be uncommented
- * below if you want sched_yield called when waiting for
- * writes or blocking for space, otherwise blocking will
- * actively spin while waiting.
+ * Note: what a blocked producer or consumer does while 
+ * waiting is set per queue with a Wait::Policy, see 
+ * waitstrategy.hpp.  The default spins briefly and then
+ * calls sched_yield each time around.
  */
-#define NICE 1
 
 
+/**
+ * SIZE - a non-zero SIZE fixes the capacity of a heap queue
+ * at compile time, it must be a power of two, see 
+ * ringbufferheap.tcc.
+ */
+template < class T, 
+           Type::RingBufferType type,
+           Layout::SlotLayout layout = Layout::Split,
+           std::size_t SIZE = 0 > class RingBufferBase;
+
+/** typed handles on one end of a heap queue, see fifohandle.tcc **/
+namespace Typed
+{
+   template < class T,
+              Type::RingBufferType type = Type::Heap,
+              Layout::SlotLayout layout = Layout::default_for( type ),
+              std::size_t SIZE = 0 > class Producer;
+   template < class T,
+              Type::RingBufferType type = Type::Heap,
+              Layout::SlotLayout layout = Layout::default_for( type ),
+              std::size_t SIZE = 0 > class Consumer;
+}
+
 /** heap implementation, uses thread shared memory or SHM **/
 #include "ringbufferheap.tcc"
 
 /** infinite dummy implementation, can use shared memory or SHM **/
 #include "ringbufferinfinite.tcc"
 
+/** multi producer and/or multi consumer implementations **/
+#include "ringbuffermulti.tcc"
+
+/** Typed::Producer / Typed::Consumer **/
+#include "fifohandle.tcc"
+
 #endif /* END _RINGBUFFERBASE_TCC_ */
@@ -21,8 +21,12 @@
 #define _RINGBUFFERHEAP_TCC_  1
 
 template < class T, 
-           Type::RingBufferType type > class RingBufferBase : 
+           Type::RingBufferType type,
+           Layout::SlotLayout layout,
+           std::size_t SIZE > class RingBufferBase : 
             public FIFOAbstract< T, type > {
+   static_assert( SIZE == 0 || type == Type::Heap,
+                  "only heap queues can have a fixed capacity" );
 public:
    /**
     * RingBuffer - default constructor, initializes basic
@@ -30,7 +34,11 @@ public:
     */
    RingBufferBase() : FIFOAbstract< T, type >(),
                       data( nullptr ),
+                      read_data( nullptr ),
+                      resize_request( 0 ),
+                      cap( 0 ),
                       allocate_called( false ),
+                      allocate_count( 0 ),
                       write_finished( false )
    {
    }
@@ -42,98 +50,25 @@ public:
 
    /**
     * size - as you'd expect it returns the number of 
-    * items currently in the queue.
+    * items currently in the queue, counting those still
+    * waiting in buffers the producer left behind on a
+    * resize or spill.  Safe to call from any thread.
     * @return size_t
     */
    virtual std::size_t   size()
    {
-TOP:
-      const auto   wrap_write( Pointer::wrapIndicator( data->write_pt  ) ),
-                   wrap_read(  Pointer::wrapIndicator( data->read_pt   ) );
-
-      const auto   wpt( Pointer::val( data->write_pt ) ), 
-                   rpt( Pointer::val( data->read_pt  ) );
-      if( wpt == rpt )
-      {
-         if( wrap_read < wrap_write )
-         {
-            return( data->max_cap );
-         }
-         else if( wrap_read > wrap_write )
-         {
-            /**
-             * TODO, this condition is momentary, however there
-             * is a better way to fix this with atomic operations...
-             * its caused by the incorrect value of either wpt or rpt
-             * being read within the cache. Benchmarking shows the atomic
-             * operations slows the queue down drastically so, perhaps
-             * this is the best that can be done with this type of a 
-             * queue implementation.  Perhaps a more classic implementation
-             * might work better for this application?
-             */
-            goto TOP;
-         }
-         else
-         {
-            return( 0 );
-         }
-      }
-      else if( rpt < wpt )
-      {
-         return( wpt - rpt );
-      }
-      else if( rpt > wpt )
+      Sizing guard( *this );
+      std::size_t total( 0 );
+      for( auto *buff( read_head.load() ); buff != nullptr; 
+           buff = static_cast< Buffer::Data< T, type, layout, SIZE >* >( 
+              buff->next.load( std::memory_order_acquire ) ) )
       {
-         return( data->max_cap - rpt + wpt ); 
+         total += occupancy( buff );
       }
-      return( 0 );
+      return( total );
    }
 
    
-   /**
-    * get_signal - returns a reference to the signal mask for this
-    * queue. TODO this function won't necessarily work as advertised
-    * as it needs its own FIFO to deliver signals properly.
-    * @return volatile RBSignal&
-    */
-   virtual RBSignal get_signal()
-   {
-#if 0      
-      /** 
-       * there are two signalling paths, the one 
-       * we'll give the highest priority to is the 
-       * asynchronous one.
-       */
-      const auto head( Pointer::val( data->read_pt ) );
-      const auto signal_queue( data->store[ head ].signal );
-      const auto curr_size( (this)->size() );
-      if( curr_size > 0 ) 
-      {
-         return( signal_queue );
-      }
-      /** there must be something in the local signal **/
-      struct{
-         RBSignal a;
-         RBSignal b;
-      }copy;
-      do
-      {
-         copy.a = (this)->signal_a;
-         copy.b = (this)->signal_b;
-      }while( copy.a != copy.b );
-
-      //(this)->signal_a = RBSignal::NONE;
-      //(this)->signal_b = RBSignal::NONE;
-#endif
-      return( RBSignal::NONE );
-   }
-  
-   virtual bool  send_signal( const RBSignal &signal )
-   {
-      //TODO, fixme
-      return( true );
-   }
-
    /**
     * space_avail - returns the amount of space currently
     * available in the queue.  This is the amount a user
@@ -142,17 +77,20 @@ TOP:
     */
    virtual std::size_t   space_avail()
    {
-      return( data->max_cap - size() );
+      Sizing guard( *this );
+      Buffer::Data< T, type, layout, SIZE > *buff( data );
+      return( slots( buff ) - occupancy( buff ) );
    }
   
    /**
     * capacity - returns the capacity of this queue which is 
-    * set at compile time by the constructor.
+    * set by the constructor, or by the last resize the
+    * producer has switched to, or SIZE if that is fixed.
     * @return size_t
     */
    virtual std::size_t   capacity() const
    {
-      return( data->max_cap );
+      return( SIZE != 0 ? SIZE : cap.load( std::memory_order_relaxed ) );
    }
 
    /**
@@ -164,31 +102,71 @@ TOP:
    virtual void push( const RBSignal signal = RBSignal::NONE )
    {
       if( ! (this)->allocate_called ) return;
-      const size_t write_index( Pointer::val( data->write_pt ) );
-      data->signal[ write_index ].sig = signal;
-      Pointer::inc( data->write_pt );
-      write_stats.count++;
-      if( signal == RBSignal::RBEOF )
+      const size_t write_index( index( data->write_pt ) );
+      data->write_signal( write_index, signal );
+      publish_write( 1, signal );
+      write_stats.add( 1 );
+      (this)->allocate_called = false;
+   }
+   
+   /**
+    * push_range - releases the first count slots handed out by
+    * allocate_range() to the queue, the write pointer is 
+    * updated once for the whole range.  Function will simply
+    * return if allocate wasn't called prior to calling this 
+    * function.
+    * @param   count  - const std::size_t
+    * @param   signal - const RBSignal, default: NONE
+    */
+   virtual void push_range( const std::size_t count,
+                            const RBSignal signal = RBSignal::NONE )
+   {
+      if( ! (this)->allocate_called ) return;
+      assert( count <= (this)->allocate_count );
       {
-         /**
-          * TODO, this is a quick hack, rework when proper signalling
-          * is implemented.
-          */
-         (this)->write_finished = true;
+         /** slots handed out but not released were constructed by allocate_range **/
+         const size_t unused( (this)->allocate_count - count );
+         const size_t start ( ( index( data->write_pt ) + count ) % slots( data ) );
+         const size_t first ( std::min( unused, slots( data ) - start ) );
+         data->destroy( start, first );
+         data->destroy( 0, unused - first );
+      }
+      if( count > 0 )
+      {
+         const size_t write_index( index( data->write_pt ) );
+         const size_t first( std::min( count, slots( data ) - write_index ) );
+         data->clear_signals( write_index, first );
+         data->clear_signals( 0, count - first );
+         /** add signal to last el only **/
+         data->write_signal( ( write_index + count - 1 ) % slots( data ), signal );
+         publish_write( count, signal );
+         write_stats.add( count );
       }
       (this)->allocate_called = false;
+      (this)->allocate_count  = 0;
    }
    
    /**
-    :* recycle - To be used in conjunction with peek().  Simply
-    * removes the item at the head of the queue and discards them
+    * recycle - To be used in conjunction with peek() or 
+    * peek_range().  Simply removes the items at the head of 
+    * the queue and discards them
     * @param range - const size_t, default range is 1
     */
    virtual void recycle( const std::size_t range = 1 )
    {
-      assert( range <= data->max_cap );
-      Pointer::incBy( range, data->read_pt );
-      read_stats.count += range;
+      std::size_t remaining( range );
+      while( remaining > 0 )
+      {
+         /** only crosses into a resized buffer if this one ran out **/
+         const std::size_t count( std::min( remaining, wait_items( remaining ) ) );
+         const std::size_t read_index( index( read_data->read_pt ) );
+         const std::size_t first( std::min( count, slots( read_data ) - read_index ) );
+         read_data->destroy( read_index, first );
+         read_data->destroy( 0, count - first );
+         publish_read( count );
+         read_stats.add( count );
+         remaining -= count;
+      }
    }
    
    /**
@@ -199,36 +177,430 @@ TOP:
     */
    virtual void get_zero_read_stats( Blocked &copy )
    {
-      copy.all       = read_stats.all;
-      read_stats.all = 0;
+      copy = read_stats.take();
    }
 
    /**
     * get_zero_write_stats - sets the write variable
-    * to the current blocked stats and then sets the 
-    * current vars to zero.
+    * to the blocked stats since the last call, safe to
+    * call from a monitor thread while the producer runs,
+    * see BlockedCounter.
     * @param   copy - Blocked&
     */
    virtual void get_zero_write_stats( Blocked &copy )
    {
-      copy.all       = write_stats.all;
-      write_stats.all = 0;
+      copy = write_stats.take();
    }
 
    /**
-    * get_write_finished - does exactly what it says, 
-    * sets the param variable to true when all writes
-    * have been finished.  This particular funciton 
-    * might change in the future but for the moment
-    * its vital for instrumentation.
+    * get_write_finished - sets the param variable to true
+    * once the producer has released an element carrying 
+    * RBSignal::RBEOF to the queue (not when it is written
+    * into a slot, only when the consumer could see it).
+    * Safe to call from any thread.
     * @param   write_finished - bool&
     */
    virtual void get_write_finished( bool &write_finished )
    {
-      write_finished = (this)->write_finished;
+      write_finished = (this)->write_finished.load( std::memory_order_acquire );
+   }
+
+   /**
+    * readable - consumer's thread only, answers from the write
+    * position the consumer has cached unless that says empty.
+    * @return  bool
+    */
+   virtual bool readable()
+   {
+      return( Pointer::avail( read_data->read_pt, read_data->write_pt, 1 ) > 0 ||
+              read_data->next.load( std::memory_order_acquire ) != nullptr );
+   }
+
+   /**
+    * writable - producer's thread only, answers from the read
+    * position the producer has cached unless that says full.
+    * @return  bool
+    */
+   virtual bool writable()
+   {
+      return( resize_pending() || 
+              Pointer::space( data->write_pt, data->read_pt, 1 ) > 0 );
+   }
+
+   /**
+    * set_wait_policy - sets what the producer and consumer
+    * do while blocked.  Must be set before either end starts
+    * using the queue, and for SHM both ends must match.
+    * @param   policy - const Wait::Policy&
+    */
+   virtual void set_wait_policy( const Wait::Policy &policy )
+   {
+      wait_policy = policy;
+   }
+
+   /**
+    * set_label - names this queue in Stats::Registry 
+    * snapshots, does nothing unless FIFO_INSTRUMENT is set.
+    * @param   label - const std::string&
+    */
+   virtual void set_label( const std::string &label )
+   {
+      probe.label( label );
+   }
+
+   /**
+    * resize - asks the producer to move to a new buffer of
+    * new_cap items on its next write (or as soon as it is 
+    * blocked on a full buffer).  The old buffer isn't copied,
+    * the consumer drains it and then follows the producer so
+    * order and signals are kept and neither end stops.  The
+    * old buffer is freed by the consumer once drained.  Only
+    * heap queues can be resized, the other types share their
+    * buffer with another process or host, and not those with
+    * a capacity fixed at compile time.
+    * @param   new_cap - const std::size_t
+    * @return  bool, false if new_cap is zero or not a heap queue
+    */
+   virtual bool resize( const std::size_t new_cap )
+   {
+      if( ! resizable::value || new_cap == 0 )
+      {
+         return( false );
+      }
+      resize_request.store( new_cap, std::memory_order_release );
+      return( true );
+   }
+
+   /**
+    * spill_to - once the queue is full the producer carries on
+    * into an overflow buffer of up to max_items mapped from an
+    * unlinked file in directory instead of waiting, the consumer
+    * drains it in order after what was in memory, signals
+    * included.  The producer goes back to a buffer in memory of
+    * the old capacity as soon as the consumer has emptied the
+    * overflow, only a full overflow makes it wait.  There is one
+    * overflow buffer, so it can only be used again once the
+    * consumer is past it, the disk used is bounded by max_items.
+    * Call once, before the producer starts or from the producer.
+    * @param   directory - const std::string&, e.g. /var/tmp
+    * @param   max_items - const std::size_t, non-zero
+    * @return  bool, false if the capacity is fixed at compile 
+    *          time, max_items is zero or it was called before
+    */
+   bool spill_to( const std::string &directory, const std::size_t max_items )
+   {
+      static_assert( type == Type::Heap, "only heap queues can spill" );
+      if( ! resizable::value || max_items == 0 || spill )
+      {
+         return( false );
+      }
+      spill_cap = max_items;
+      spill.reset( new FIFOArena( Buffer::Data< T, type, layout, SIZE >::arena_bytes( 
+                                     max_items, L1D_CACHE_LINE_SIZE ),
+                                  directory ) );
+      return( true );
+   }
+
+   /** true while the producer is writing to the overflow buffer **/
+   bool spilling() const
+   {
+      const Buffer::Data< T, type, layout, SIZE > *buff( data );
+      return( spill && spill->owns( buff ) );
+   }
+
+   /**
+    * producer - typed handle for the thread that writes, its
+    * calls aren't virtual and inline, see fifohandle.tcc.
+    * @return  Typed::Producer< T, type, layout, SIZE >
+    */
+   Typed::Producer< T, type, layout, SIZE > producer()
+   {
+      return( Typed::Producer< T, type, layout, SIZE >( *this ) );
+   }
+
+   /**
+    * consumer - typed handle for the thread that reads.
+    * @return  Typed::Consumer< T, type, layout, SIZE >
+    */
+   Typed::Consumer< T, type, layout, SIZE > consumer()
+   {
+      return( Typed::Consumer< T, type, layout, SIZE >( *this ) );
+   }
+
+#if FIFO_COROUTINES
+   class PushAwaiter;
+   class PopAwaiter;
+   class PopRangeAwaiter;
+
+   /**
+    * async_push - co_await'able push(), suspends the calling
+    * coroutine while the queue is full and is resumed by the
+    * consumer once it has made room.  An rvalue is moved in, 
+    * an lvalue copied, either must live until the co_await is
+    * done.  Needs Wait::Park, the other end only looks for a
+    * suspended coroutine after publishing under that policy.
+    * @param   item   - U&&
+    * @param   signal - const RBSignal, default NONE
+    * @return  PushAwaiter, co_await yields nothing
+    */
+   template < class U > 
+   PushAwaiter async_push( U &&item, const RBSignal signal = RBSignal::NONE )
+   {
+      static_assert( type != Type::SharedMemory,
+                     "the other end of an SHM queue can't resume a coroutine" );
+      return( PushAwaiter( *this, 
+                           const_cast< T* >( &item ),
+                           signal,
+                           ! std::is_lvalue_reference< U >::value ) );
+   }
+
+   /**
+    * async_pop - co_await'able pop(), suspends the calling
+    * coroutine while the queue is empty and is resumed by the
+    * producer once it has published.  Same policy as above.
+    * @param   item   - T&, must live until the co_await is done
+    * @param   signal - RBSignal*, default nullptr
+    * @return  PopAwaiter, co_await yields nothing
+    */
+   PopAwaiter async_pop( T &item, RBSignal *signal = nullptr )
+   {
+      static_assert( type != Type::SharedMemory,
+                     "the other end of an SHM queue can't resume a coroutine" );
+      return( PopAwaiter( *this, item, signal ) );
    }
 
+   /**
+    * async_pop_range - like try_pop_range(), suspends while the
+    * queue is empty then pops whatever is there up to n_items,
+    * a coroutine after exactly n_items co_awaits in a loop.
+    * @param   items   - T*
+    * @param   n_items - const std::size_t, non-zero
+    * @param   signal  - RBSignal*, n_items of them or nullptr
+    * @return  PopRangeAwaiter, co_await yields the count popped
+    */
+   PopRangeAwaiter async_pop_range( T *items, 
+                                    const std::size_t n_items,
+                                    RBSignal *signal = nullptr )
+   {
+      static_assert( type != Type::SharedMemory,
+                     "the other end of an SHM queue can't resume a coroutine" );
+      assert( n_items > 0 );
+      return( PopRangeAwaiter( *this, items, n_items, signal ) );
+   }
+#endif
+
+#if FIFO_COROUTINES
+   /**
+    * PushAwaiter - see async_push(), first tries without 
+    * suspending so a queue with room costs no more than
+    * try_push().
+    */
+   class PushAwaiter : public Async::Awaiter
+   {
+   public:
+      PushAwaiter( RingBufferBase &queue, 
+                   T *item, 
+                   const RBSignal signal, 
+                   const bool move ) : queue( queue ),
+                                       item( item ),
+                                       signal( signal ),
+                                       move( move )
+      {
+      }
+
+      bool await_ready()
+      {
+         (this)->done = attempt();
+         return( (this)->done );
+      }
+
+      bool await_suspend( std::coroutine_handle<> h )
+      {
+         queue.check_async();
+         return( (this)->suspend( queue.write_waiter, h, [&](){ return( attempt() ); } ) );
+      }
+
+      void await_resume()
+      {
+         if( ! (this)->done )
+         {
+            /** the consumer made room before waking us, doesn't block **/
+            while( ! attempt() )
+            {
+               std::this_thread::yield();
+            }
+         }
+      }
+
+   private:
+      bool attempt()
+      {
+         return( move ? 
+            queue.RingBufferBase::local_try_push_move( item, signal, Wait::Deadline::min() ) :
+            queue.RingBufferBase::local_try_push( item, signal, Wait::Deadline::min() ) );
+      }
+
+      RingBufferBase &queue;
+      T              *item;
+      const RBSignal  signal;
+      const bool      move;
+   };
+
+   /** PopAwaiter - see async_pop() **/
+   class PopAwaiter : public Async::Awaiter
+   {
+   public:
+      PopAwaiter( RingBufferBase &queue, 
+                  T &item, 
+                  RBSignal *signal ) : queue( queue ),
+                                       item( item ),
+                                       signal( signal )
+      {
+      }
+
+      bool await_ready()
+      {
+         (this)->done = attempt();
+         return( (this)->done );
+      }
+
+      bool await_suspend( std::coroutine_handle<> h )
+      {
+         queue.check_async();
+         return( (this)->suspend( queue.read_waiter, h, [&](){ return( attempt() ); } ) );
+      }
+
+      void await_resume()
+      {
+         if( ! (this)->done )
+         {
+            /** the producer published before waking us, doesn't block **/
+            while( ! attempt() )
+            {
+               std::this_thread::yield();
+            }
+         }
+      }
+
+   private:
+      bool attempt()
+      {
+         return( queue.RingBufferBase::local_try_pop( &item, signal, Wait::Deadline::min() ) );
+      }
+
+      RingBufferBase &queue;
+      T              &item;
+      RBSignal       *signal;
+   };
+
+   /** PopRangeAwaiter - see async_pop_range() **/
+   class PopRangeAwaiter : public Async::Awaiter
+   {
+   public:
+      PopRangeAwaiter( RingBufferBase &queue,
+                       T *items,
+                       const std::size_t n_items,
+                       RBSignal *signal ) : queue( queue ),
+                                            items( items ),
+                                            n_items( n_items ),
+                                            signal( signal ),
+                                            popped( 0 )
+      {
+      }
+
+      bool await_ready()
+      {
+         (this)->done = attempt();
+         return( (this)->done );
+      }
+
+      bool await_suspend( std::coroutine_handle<> h )
+      {
+         queue.check_async();
+         return( (this)->suspend( queue.read_waiter, h, [&](){ return( attempt() ); } ) );
+      }
+
+      std::size_t await_resume()
+      {
+         if( ! (this)->done )
+         {
+            while( ! attempt() )
+            {
+               std::this_thread::yield();
+            }
+         }
+         return( popped );
+      }
+
+   private:
+      bool attempt()
+      {
+         popped = queue.RingBufferBase::local_try_pop_range( items, 
+                                                             signal, 
+                                                             n_items, 
+                                                             Wait::Deadline::min() );
+         return( popped > 0 );
+      }
+
+      RingBufferBase    &queue;
+      T                 *items;
+      const std::size_t  n_items;
+      RBSignal          *signal;
+      std::size_t        popped;
+   };
+#endif
+
 protected:
+   friend class Typed::Producer< T, type, layout, SIZE >;
+   friend class Typed::Consumer< T, type, layout, SIZE >;
+
+#if FIFO_COROUTINES
+   /** 
+    * check_async - a coroutine is about to suspend, only the
+    * Park policy has the fence that lets the other end see it.
+    */
+   void check_async() const
+   {
+      if( wait_policy.strategy != Wait::Park )
+      {
+         std::cerr << "async_push / async_pop need Wait::Park on the queue, exiting.\n";
+         exit( EXIT_FAILURE );
+      }
+   }
+#endif
+
+   /**
+    * attach_data - called once by the constructor with the
+    * buffer both ends start out on.
+    * @param   buff - Buffer::Data< T, type, layout, SIZE >*
+    */
+   void attach_data( Buffer::Data< T, type, layout, SIZE > *buff )
+   {
+      data      = buff;
+      read_data = buff;
+      read_head.store( buff );
+      cap.store( buff->max_cap, std::memory_order_relaxed );
+      probe.capacity( buff->max_cap );
+   }
+
+   /**
+    * release_data - called by the destructor, frees the 
+    * current buffer along with any the consumer hadn't 
+    * drained yet after a resize.
+    */
+   void release_data()
+   {
+      while( read_data != nullptr && read_data != data )
+      {
+         auto *next( read_data->next.load( std::memory_order_acquire ) );
+         Buffer::release( read_data );
+         read_data = static_cast< Buffer::Data< T, type, layout, SIZE >* >( next );
+      }
+      Buffer::release( static_cast< Buffer::Data< T, type, layout, SIZE >* >( data ) );
+      data      = nullptr;
+      read_data = nullptr;
+   }
+
    /**
     * local_allocate - get a reference to an object of type T at the 
     * end of the queue.  Should be released to the queue using
@@ -238,26 +610,55 @@ protected:
     */
    virtual void local_allocate( void **ptr )
    {
-      while( space_avail() == 0 )
+      RingBufferBase::local_try_allocate( ptr, Wait::Deadline::max() );
+   }
+
+   /**
+    * local_try_allocate - local_allocate() that gives up at 
+    * deadline.
+    * @param   ptr      - void**
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if the queue stayed full
+    */
+   virtual bool local_try_allocate( void **ptr, const Wait::Deadline &deadline )
+   {
+      if( wait_space( 1, 1, deadline ) == 0 )
       {
-#ifdef NICE      
-         std::this_thread::yield();
-#endif         
-         if( write_stats.blocked == 0 )
-         {   
-            write_stats.blocked = 1;
-         }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif           
+         return( false );
       }
       (this)->allocate_called = true;
-      const size_t write_index( Pointer::val( data->write_pt ) );
+      (this)->allocate_count  = 1;
+      const size_t write_index( index( data->write_pt ) );
       *ptr = (void*)&(data->store[ write_index ].item);
+      return( true );
+   }
+
+   /**
+    * local_allocate_range - hands out up to n slots at the 
+    * tail of the queue, blocks until at least one is free.
+    * The range is split at the end of the buffer, length[ 1 ]
+    * is zero if it doesn't wrap.
+    * @param   ptr    - void**, array of two
+    * @param   length - std::size_t*, array of two
+    * @param   stride - std::size_t&, bytes between slots
+    * @param   n      - const std::size_t
+    */
+   virtual void local_allocate_range( void **ptr,
+                                      std::size_t *length,
+                                      std::size_t &stride,
+                                      const std::size_t n )
+   {
+      assert( ptr != nullptr && length != nullptr );
+      stride = sizeof( typename Buffer::DataBase< T, layout >::element_t );
+      const size_t count( std::min( n, wait_space( n ) ) );
+      const size_t write_index( index( data->write_pt ) );
+      const size_t first( std::min( count, slots( data ) - write_index ) );
+      ptr   [ 0 ] = (void*)&(data->store[ write_index ].item);
+      length[ 0 ] = first;
+      ptr   [ 1 ] = (void*)&(data->store[ 0 ].item);
+      length[ 1 ] = count - first;
+      (this)->allocate_called = true;
+      (this)->allocate_count  = count;
    }
    
    /**
@@ -268,126 +669,206 @@ protected:
     * @param   signal, const RBSignal&
     */
    virtual void  local_push( void *ptr, const RBSignal &signal )
+   {
+      RingBufferBase::local_try_push( ptr, signal, Wait::Deadline::max() );
+   }
+
+   /**
+    * local_push_move - as local_push but the item is move
+    * constructed into the slot.
+    * @param   item, void ptr
+    * @param   signal, const RBSignal&
+    */
+   virtual void  local_push_move( void *ptr, const RBSignal &signal )
+   {
+      RingBufferBase::local_try_push_move( ptr, signal, Wait::Deadline::max() );
+   }
+
+   /**
+    * local_try_push - local_push() that gives up at deadline.
+    * @param   ptr      - void*
+    * @param   signal   - const RBSignal&
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if the queue stayed full
+    */
+   virtual bool local_try_push( void *ptr, 
+                                const RBSignal &signal,
+                                const Wait::Deadline &deadline )
    {
       assert( ptr != nullptr );
-      while( space_avail() == 0 )
+      if( wait_space( 1, 1, deadline ) == 0 )
       {
-#ifdef NICE      
-         std::this_thread::yield();
-#endif         
-         if( write_stats.blocked == 0 )
-         {   
-            write_stats.blocked = 1;
-         }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif           
+         return( false );
       }
-      
-	   const size_t write_index( Pointer::val( data->write_pt ) );
+	   const size_t write_index( index( data->write_pt ) );
       T *item( reinterpret_cast< T* >( ptr ) );
-	   data->store[ write_index ].item     = *item;
-	   data->signal[ write_index ].sig     = signal;
-	   Pointer::inc( data->write_pt );
-	   write_stats.count++;
-      if( signal == RBSignal::RBEOF )
+	   Buffer::copy_construct( &data->store[ write_index ].item, *item );
+	   data->write_signal( write_index, signal );
+	   publish_write( 1, signal );
+	   write_stats.add( 1 );
+      return( true );
+   }
+
+   /**
+    * local_try_push_move - local_push_move() that gives up 
+    * at deadline, the item isn't touched if it does.
+    * @param   ptr      - void*
+    * @param   signal   - const RBSignal&
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if the queue stayed full
+    */
+   virtual bool local_try_push_move( void *ptr, 
+                                     const RBSignal &signal,
+                                     const Wait::Deadline &deadline )
+   {
+      assert( ptr != nullptr );
+      if( wait_space( 1, 1, deadline ) == 0 )
       {
-         (this)->write_finished = true;
+         return( false );
       }
+      const size_t write_index( index( data->write_pt ) );
+      T *item( reinterpret_cast< T* >( ptr ) );
+      new ( &data->store[ write_index ].item ) T( std::move( *item ) );
+      data->write_signal( write_index, signal );
+      publish_write( 1, signal );
+      write_stats.add( 1 );
+      return( true );
    }
   
    template < class iterator_type > void local_insert_helper( iterator_type begin, 
                                                               iterator_type end,
                                                               const RBSignal &signal )
    {
-      auto dist( std::distance( begin, end ) );
-      while( --dist )
+      size_t remaining( std::distance( begin, end ) );
+      while( remaining > 0 )
       {
-         while( space_avail() == 0 )
-         {
-#ifdef NICE
-            std::this_thread::yield();
-#endif
-            if( write_stats.blocked == 0 )
-            {
-               write_stats.blocked = 1;
-            }
-         }
-         const size_t write_index( Pointer::val( data->write_pt ) );
-         data->store[ write_index ].item = (*begin);
+         const size_t count( std::min( remaining, wait_space( remaining ) ) );
+         const size_t write_index( index( data->write_pt ) );
+         const size_t first( std::min( count, slots( data ) - write_index ) );
          
+         copy_in( begin, write_index, first, 
+                  bulk_insert< iterator_type >() );
+         copy_in( begin, 0, count - first, 
+                  bulk_insert< iterator_type >() );
+         data->clear_signals( write_index, first );
+         data->clear_signals( 0, count - first );
+         remaining -= count;
          /** add signal to last el only **/
-         if( dist == 0 )
-         {
-            data->signal[ write_index ].sig = signal;
-         }
-         else
+         if( remaining == 0 )
          {
-            data->signal[ write_index ].sig = RBSignal::NONE;
+            data->write_signal( ( write_index + count - 1 ) % slots( data ), signal );
          }
-         Pointer::inc( data->write_pt );
-         write_stats.count++;
-         ++begin;
-      }
-      if( signal == RBSignal::RBEOF )
-      {
-         (this)->write_finished = true;
+         publish_write( count, ( remaining == 0 ? signal : RBSignal::NONE ) );
+         write_stats.add( count );
       }
       return;
    }
    
+   /**
+    * bulk_insert - selects the memcpy path for ranges of
+    * trivially copyable types held in contiguous memory,
+    * everything else is copied element by element.
+    */
+   template < class iterator_type > using bulk_insert = 
+      std::integral_constant< bool,
+         std::is_trivially_copyable< T >::value &&
+         Buffer::DataBase< T, layout >::contiguous &&
+         Buffer::is_contiguous_iterator< iterator_type >::value &&
+         std::is_same< T, typename std::decay< 
+            typename std::iterator_traits< iterator_type >::value_type >::type >::value >;
 
    /**
-    * insert - inserts the range from begin to end in the queue,
-    * blocks until space is available.  If the range is greater than
-    * available space on the queue then it'll simply add items as 
-    * space becomes available.  There is the implicit assumption that
-    * another thread is consuming the data, so eventually there will
-    * be room.
-    * @param   begin - iterator_type, iterator to begin of range
-    * @param   end   - iterator_type, iterator to end of range
+    * copy_in - copies n items from it into the store starting
+    * at index, it is advanced by n.  The caller guarantees the
+    * run doesn't cross the end of the buffer.
     */
-   virtual void local_insert(  void *begin_ptr,
-                               void *end_ptr,
-                               const RBSignal &signal, 
-                               const std::size_t iterator_type )
+   template < class iterator_type > 
+   void copy_in( iterator_type &it, 
+                 const size_t index, 
+                 const size_t n,
+                 std::true_type /** trivially copyable, contiguous **/ )
    {
-   typedef typename std::list< T >::iterator   it_list;
-   typedef typename std::vector< T >::iterator it_vec;
+      if( n == 0 )
+      {
+         return;
+      }
+      Buffer::bulk_copy( &( data->store[ index ].item ), 
+                         &( *it ), 
+                         n * sizeof( T ) );
+      std::advance( it, n );
+   }
    
+   template < class iterator_type > 
+   void copy_in( iterator_type &it, 
+                 const size_t index, 
+                 const size_t n,
+                 std::false_type )
+   {
+      for( size_t i( index ); i < index + n; i++ )
+      {
+         Buffer::copy_construct( &data->store[ i ].item, *it );
+         ++it;
+      }
+   }
 
-      
-   const std::map< std::size_t, 
-             std::function< void (void*,void*,const RBSignal&) > > func_map
-               = {{ typeid( it_list ).hash_code(), 
-                    [ & ]( void *b_ptr, void *e_ptr, const RBSignal &sig )
-                    {
-                        it_list *begin( reinterpret_cast< it_list* >( b_ptr ) );
-                        it_list *end  ( reinterpret_cast< it_list* >( e_ptr   ) );
-                        local_insert_helper( *begin, *end, signal );
-                    } },
-                  { typeid( it_vec ).hash_code(),
-                    [ & ]( void *b_ptr, void *e_ptr, const RBSignal &sig )
-                    {
-                        it_vec *begin( reinterpret_cast< it_vec* >( b_ptr ) );
-                        it_vec *end  ( reinterpret_cast< it_vec* >( e_ptr   ) );
-                        local_insert_helper( *begin, *end, signal );
-
-                    } } };
-      auto f( func_map.find( iterator_type ) );
-      if( f != func_map.end() )
-      {
-         (*f).second( begin_ptr, end_ptr, signal );
-      }
-      else
-      {
-         /** TODO, throw exception **/
-         assert( false );
+   /**
+    * copy_out - moves n items starting at index out of the store
+    * along with their signals if signal isn't null, the slots are
+    * destroyed.  The caller guarantees the run doesn't cross the
+    * end of the buffer.
+    */
+   void copy_out( T *items,
+                  RBSignal *signal,
+                  const size_t index,
+                  const size_t n,
+                  std::true_type /** trivially copyable, packed **/ )
+   {
+      if( n == 0 )
+      {
+         return;
+      }
+      Buffer::bulk_copy( items, &( read_data->store[ index ].item ), n * sizeof( T ) );
+      if( signal != nullptr )
+      {
+         read_data->copy_signals( signal, index, n );
       }
+   }
+   
+   void copy_out( T *items,
+                  RBSignal *signal,
+                  const size_t index,
+                  const size_t n,
+                  std::false_type )
+   {
+      if( signal != nullptr )
+      {
+         read_data->copy_signals( signal, index, n );
+      }
+      for( size_t i( 0 ); i < n; i++ )
+      {
+         items[ i ] = std::move( read_data->store[ index + i ].item );
+      }
+      read_data->destroy( index, n );
+   }
+
+   /**
+    * local_insert - inserts the contiguous range of n_items 
+    * at ptr in the queue, blocks until space is available.  If
+    * the range is greater than available space on the queue then
+    * it'll simply add items as space becomes available.  There is
+    * the implicit assumption that another thread is consuming the
+    * data, so eventually there will be room.
+    * @param   ptr     - const void*, array of T
+    * @param   n_items - const std::size_t
+    * @param   signal  - const RBSignal&
+    */
+   virtual void local_insert( const void *ptr,
+                              const std::size_t n_items,
+                              const RBSignal &signal )
+   {
+      assert( ptr != nullptr );
+      const T *begin( reinterpret_cast< const T* >( ptr ) );
+      local_insert_helper( begin, begin + n_items, signal );
       return;
    }
    
@@ -399,43 +880,47 @@ protected:
     */
    virtual void 
    local_pop( void *ptr, RBSignal *signal )
+   {
+      RingBufferBase::local_try_pop( ptr, signal, Wait::Deadline::max() );
+   }
+
+   /**
+    * local_try_pop - local_pop() that gives up at deadline.
+    * @param   ptr      - void*
+    * @param   signal   - RBSignal*
+    * @param   deadline - const Wait::Deadline&
+    * @return  bool, false if the queue stayed empty
+    */
+   virtual bool local_try_pop( void *ptr, 
+                               RBSignal *signal,
+                               const Wait::Deadline &deadline )
    {
       assert( ptr != nullptr );
-      while( size() == 0 )
+      if( wait_items( 1, 1, deadline ) == 0 )
       {
-#ifdef NICE      
-         std::this_thread::yield();
-#endif        
-         if( read_stats.blocked == 0 )
-         {   
-            read_stats.blocked  = 1;
-         }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif           
-      }
-      const std::size_t read_index( Pointer::val( data->read_pt ) );
+         return( false );
+      }
+      const std::size_t read_index( index( read_data->read_pt ) );
       if( signal != nullptr )
       {
-         *signal = data->signal[ read_index ].sig;
+         *signal = read_data->read_signal( read_index );
       }
-      /** gotta dereference pointer and copy **/
+      /** move out, the slot is raw storage again once read **/
       T *item( reinterpret_cast< T* >( ptr ) );
-      *item = data->store[ read_index ].item;
-      Pointer::inc( data->read_pt );
-      read_stats.count++;
+      *item = std::move( read_data->store[ read_index ].item );
+      read_data->destroy( read_index, 1 );
+      publish_read( 1 );
+      read_stats.add( 1 );
+      return( true );
    }
    
    /**
-    * pop_range - pops a range and returns it as a std::array.  The
-    * exact range to be popped is specified as a template parameter.
-    * the static std::array was chosen as its a bit faster, however 
-    * this might change in future implementations to a std::vector
-    * or some other structure.
+    * pop_range - pops n_items into the array at ptr_data, and 
+    * their signals into signal if it isn't null.  Trivially 
+    * copyable types are moved with at most two bulk copies per
+    * chunk (one on each side of the wrap point), everything 
+    * else is copied one element at a time.  Either way the
+    * read pointer moves once per chunk.
     */
    virtual void  local_pop_range( void     *ptr_data,
                                   RBSignal *signal,
@@ -449,45 +934,124 @@ protected:
       }
 
       auto *items( reinterpret_cast< T* >( ptr_data ) );
-      
-      while( size() < n_items )
+
+      /**
+       * anything bigger than the buffer is moved in chunks,
+       * each chunk moves the read pointer exactly once.
+       */
+      while( n_items > 0 )
       {
-#ifdef NICE
-         std::this_thread::yield();
-#endif
-         if( read_stats.blocked == 0 )
-         {
-            read_stats.blocked = 1;
-         }
+         const size_t chunk( std::min( n_items, slots( read_data ) ) );
+         /** 
+          * comes back short only when the tail end of a 
+          * buffer that has been resized away is left
+          */
+         const size_t count( std::min( chunk, wait_items( chunk, chunk ) ) );
+         read_out( items, signal, count );
+         items   += count;
+         signal   = ( signal != nullptr ? signal + count : nullptr );
+         n_items -= count;
       }
-     
-      size_t read_index;
-      
+      return;
+   }
 
-      if( signal != nullptr )
+   /**
+    * local_try_pop_range - waits until deadline for something 
+    * to read, then pops whatever is there up to n_items.
+    * @param   ptr_data - void*
+    * @param   signal   - RBSignal*
+    * @param   n_items  - std::size_t
+    * @param   deadline - const Wait::Deadline&
+    * @return  std::size_t, items popped
+    */
+   virtual std::size_t local_try_pop_range( void *ptr_data,
+                                            RBSignal *signal,
+                                            std::size_t n_items,
+                                            const Wait::Deadline &deadline )
+   {
+      assert( ptr_data != nullptr );
+      auto *items( reinterpret_cast< T* >( ptr_data ) );
+      std::size_t popped( 0 );
+      auto until( deadline );
+      while( popped < n_items )
       {
-         for( size_t i( 0 ); i < n_items ; i++ )
+         const size_t count( std::min( n_items - popped, 
+                                       wait_items( n_items - popped, 1, until ) ) );
+         if( count == 0 )
          {
-            read_index = Pointer::val( data->read_pt );
-            items[ i ] = data->store [ read_index ].item;
-            signal  [ i ] = data->signal[ read_index ].sig;
-            Pointer::inc( data->read_pt );
-            read_stats.count++;
+            break;
          }
+         read_out( items + popped, 
+                   ( signal != nullptr ? signal + popped : nullptr ), 
+                   count );
+         popped += count;
+         /** more only if it is already there, e.g. after a resize **/
+         until = Wait::Deadline::min();
       }
-      else /** ignore signal **/
-      {
-         /** TODO, incorporate streaming copy here **/
-         for( size_t i( 0 ); i < n_items; i++ )
-         {
-            read_index = Pointer::val( data->read_pt );
-            items[ i ]    = data->store[ read_index ].item;
-            Pointer::inc( data->read_pt );
-            read_stats.count++;
-         }
+      return( popped );
+   }
 
+   /**
+    * local_pop_until_signal - blocks for one item, then pops
+    * what the buffer the consumer is on holds, up to n_items,
+    * through the first one that carries a signal.  The signal
+    * runs on each side of the wrap point are scanned with
+    * find_signal(), nothing is copied out until the end is known.
+    * @param   ptr_data - void*
+    * @param   signal   - RBSignal*, gets that signal or NONE
+    * @param   n_items  - const std::size_t
+    * @return  std::size_t, items popped
+    */
+   virtual std::size_t local_pop_until_signal( void *ptr_data,
+                                               RBSignal *signal,
+                                               const std::size_t n_items )
+   {
+      assert( ptr_data != nullptr && signal != nullptr );
+      const size_t count( std::min( n_items, wait_items( n_items ) ) );
+      const size_t read_index( index( read_data->read_pt ) );
+      const size_t first( std::min( count, slots( read_data ) - read_index ) );
+      size_t found( read_data->find_signal( read_index, first ) );
+      if( found == first )
+      {
+         found += read_data->find_signal( 0, count - first );
       }
-      return;
+      if( found < count )
+      {
+         /** before read_out(), the Sparse layout retires it there **/
+         *signal = read_data->read_signal( ( read_index + found ) % slots( read_data ) );
+         read_out( reinterpret_cast< T* >( ptr_data ), nullptr, found + 1 );
+         return( found + 1 );
+      }
+      *signal = RBSignal::NONE;
+      read_out( reinterpret_cast< T* >( ptr_data ), nullptr, count );
+      return( count );
+   }
+
+   /**
+    * read_out - moves count items, all readable, from the head
+    * of the queue to items and their signals to signal if it
+    * isn't null.  Trivially copyable types are moved with at 
+    * most two bulk copies (one on each side of the wrap point),
+    * the read pointer moves once.
+    * @param   items  - T*
+    * @param   signal - RBSignal*
+    * @param   count  - const size_t
+    */
+   void read_out( T *items, RBSignal *signal, const size_t count )
+   {
+      const size_t read_index( index( read_data->read_pt ) );
+      const size_t first( std::min( count, slots( read_data ) - read_index ) );
+      using trivial = std::integral_constant< bool, 
+                                              std::is_trivially_copyable< T >::value &&
+                                              Buffer::DataBase< T, layout >::contiguous >;
+      copy_out( items, signal, read_index, first, trivial() );
+      copy_out( items + first, 
+                ( signal != nullptr ? signal + first : nullptr ), 
+                0, 
+                count - first, 
+                trivial() );
+      publish_read( count );
+      read_stats.add( count );
    }
    
    /**
@@ -499,39 +1063,494 @@ protected:
     */
    virtual void local_peek(  void **ptr, RBSignal *signal )
    {
-      while( size() < 1 )
+      wait_items( 1 );
+      const size_t read_index( index( read_data->read_pt ) );
+      if( signal != nullptr )
       {
-#ifdef NICE      
-         std::this_thread::yield();
-#endif     
-#if  __x86_64   
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
+         *signal = read_data->read_signal( read_index );
       }
-      const size_t read_index( Pointer::val( data->read_pt ) );
+      *ptr = (void*) &( read_data->store[ read_index ].item );
+      return;
+   }
+
+   /**
+    * local_peek_range - views of up to n readable items at the
+    * head of the buffer the consumer is on, blocks until there
+    * is at least one.
+    * @param   ptr    - void**, array of two
+    * @param   length - std::size_t*, array of two
+    * @param   stride - std::size_t&, bytes between items
+    * @param   signal - RBSignal*, may be null
+    * @param   n      - const std::size_t
+    */
+   virtual void local_peek_range( void **ptr,
+                                  std::size_t *length,
+                                  std::size_t &stride,
+                                  RBSignal *signal,
+                                  const std::size_t n )
+   {
+      assert( ptr != nullptr && length != nullptr );
+      stride = sizeof( typename Buffer::DataBase< T, layout >::element_t );
+      /** never past the end of a buffer that has been resized away **/
+      const size_t count( std::min( n, wait_items( n ) ) );
+      const size_t read_index( index( read_data->read_pt ) );
+      const size_t first( std::min( count, slots( read_data ) - read_index ) );
+      ptr   [ 0 ] = (void*)&( read_data->store[ read_index ].item );
+      length[ 0 ] = first;
+      ptr   [ 1 ] = (void*)&( read_data->store[ 0 ].item );
+      length[ 1 ] = count - first;
       if( signal != nullptr )
       {
-         *signal = data->signal[ read_index ].sig;
+         for( size_t i( 0 ); i < count; i++ )
+         {
+            signal[ i ] = read_data->read_signal( ( read_index + i ) % slots( read_data ) );
+         }
       }
-      *ptr = (void*) &( data->store[ read_index ].item );
-      return;
+   }
+
+   /**
+    * wait_space - blocks according to the wait policy until
+    * at least minimum slots are free.  The cached read pointer
+    * is refreshed whenever fewer than wanted appear free.  A
+    * pending resize is picked up here, before any slots are
+    * handed out.
+    * @param   wanted   - const std::size_t
+    * @param   minimum  - const std::size_t, default 1
+    * @param   deadline - const Wait::Deadline&, default none
+    * @return  std::size_t, free slots seen, >= minimum unless
+    *          the deadline passed
+    */
+   std::size_t wait_space( const std::size_t wanted,
+                           const std::size_t minimum = 1,
+                           const Wait::Deadline &deadline = Wait::Deadline::max() )
+   {
+      std::size_t space( 0 );
+      auto ready( [&]() -> bool
+      {
+         space = Pointer::space( data->write_pt, data->read_pt, wanted );
+         return( space >= minimum );
+      } );
+      if( resize_pending() )
+      {
+         adopt( resizable() );
+      }
+      if( spilling() && overflow_drained() )
+      {
+         unspill( resizable() );
+      }
+      if( ready() )
+      {
+         return( space );
+      }
+      if( can_spill( minimum ) )
+      {
+         /** full, carry on in the overflow rather than wait **/
+         spill_over( resizable() );
+         if( ready() )
+         {
+            return( space );
+         }
+      }
+      const auto start( probe.start() );
+      Wait::Backoff backoff( wait_policy, deadline );
+      do
+      {
+         write_stats.mark_blocked();
+         if( ! backoff.wait( data->read_pt, ready ) )
+         {
+            break;
+         }
+         /** a writer stuck on a full buffer can grow it right away **/
+         if( resize_pending() )
+         {
+            adopt( resizable() );
+         }
+      }while( ! ready() );
+      probe.write_blocked( start );
+      return( space );
+   }
+   
+   /**
+    * wait_items - consumer side version of wait_space,
+    * blocks until at least minimum items can be read.  If
+    * the producer has moved to a resized buffer whatever is
+    * left in this one is returned even if it is less than
+    * minimum, once it is empty the consumer follows the 
+    * producer.
+    * @param   wanted   - const std::size_t
+    * @param   minimum  - const std::size_t, default 1
+    * @param   deadline - const Wait::Deadline&, default none
+    * @return  std::size_t, items seen, >= 1 unless the 
+    *          deadline passed
+    */
+   std::size_t wait_items( const std::size_t wanted,
+                           const std::size_t minimum = 1,
+                           const Wait::Deadline &deadline = Wait::Deadline::max() )
+   {
+      std::size_t items( 0 );
+      auto avail( [&]() -> bool
+      {
+         items = Pointer::avail( read_data->read_pt, read_data->write_pt, wanted );
+         return( items >= std::min( minimum, slots( read_data ) ) );
+      } );
+      if( avail() )
+      {
+         return( items );
+      }
+      auto ready( [&]() -> bool
+      {
+         return( avail() || 
+                 read_data->next.load( std::memory_order_acquire ) != nullptr );
+      } );
+      const auto start( probe.start() );
+      Wait::Backoff backoff( wait_policy, deadline );
+      while( true )
+      {
+         if( read_data->next.load( std::memory_order_acquire ) != nullptr )
+         {
+            /** the producer is done with this buffer, drain then follow **/
+            avail();
+            if( items > 0 )
+            {
+               break;
+            }
+            follow();
+            if( avail() )
+            {
+               break;
+            }
+            continue;
+         }
+         read_stats.mark_blocked();
+         if( ! backoff.wait( read_data->write_pt, ready ) )
+         {
+            break;
+         }
+         if( avail() )
+         {
+            break;
+         }
+      }
+      probe.read_blocked( start );
+      return( items );
+   }
+
+   /**
+    * index - slot the pointer owned by the caller is at, a 
+    * mask rather than a division when SIZE is fixed.
+    * @param   ptr - Pointer*
+    * @return  std::size_t
+    */
+   static std::size_t index( Pointer *ptr )
+   {
+      return( SIZE != 0 ? Pointer::masked( ptr, SIZE - 1 ) : Pointer::val( ptr ) );
+   }
+
+   /**
+    * slots - capacity of buff, a constant when SIZE is fixed
+    * so that wrap arithmetic on it folds away.
+    * @param   buff - const Buffer::DataBase< T, layout >*
+    * @return  std::size_t
+    */
+   static std::size_t slots( const Buffer::DataBase< T, layout > *buff )
+   {
+      return( SIZE != 0 ? SIZE : buff->max_cap );
+   }
+
+   /** true if somebody has called resize() since the last switch **/
+   bool resize_pending() const
+   {
+      return( resizable::value &&
+              resize_request.load( std::memory_order_relaxed ) != 0 );
+   }
+
+   using resizable = std::integral_constant< bool, type == Type::Heap && SIZE == 0 >;
+
+   /**
+    * adopt - producer side, moves to a new buffer of the 
+    * requested size and links it behind the current one so
+    * the consumer can follow.  Called only between writes.
+    */
+   void adopt( std::true_type )
+   {
+      if( (this)->allocate_called )
+      {
+         /** slots are out, try again on the next write **/
+         return;
+      }
+      const auto new_cap( resize_request.exchange( 0, std::memory_order_acquire ) );
+      Buffer::Data< T, type, layout, SIZE > *old( data );
+      if( new_cap == 0 || new_cap == old->max_cap )
+      {
+         return;
+      }
+      if( spill && spill->owns( old ) )
+      {
+         /** the overflow isn't the size to come back to **/
+         link( new Buffer::Data< T, type, layout, SIZE >( new_cap, 
+                                                         ring_align,
+                                                         ring_placement ) );
+         return;
+      }
+      link( new Buffer::Data< T, type, layout, SIZE >( new_cap, 
+                                                      old->alignment,
+                                                      old->placement ) );
+   }
+
+   void adopt( std::false_type )
+   {
+   }
+
+   /**
+    * link - producer side, switches to buff and links it 
+    * behind the current buffer so the consumer follows once
+    * it has drained that one.
+    * @param   buff - Buffer::Data< T, type, layout, SIZE >*
+    */
+   void link( Buffer::Data< T, type, layout, SIZE > *buff )
+   {
+      Buffer::Data< T, type, layout, SIZE > *old( data );
+      data = buff;
+      cap.store( buff->max_cap, std::memory_order_relaxed );
+      probe.capacity( buff->max_cap );
+      old->next.store( buff, std::memory_order_release );
+      if( wait_policy.strategy == Wait::Park )
+      {
+         /** consumer may be parked on an empty old buffer **/
+         Pointer::wake( old->write_pt );
+      }
+      /** last touch of old by the producer **/
+      old->released.store( true, std::memory_order_release );
+      /** a consumer selecting on the old buffer has to move on **/
+      (this)->read_hook.fire();
+   }
+
+   /**
+    * can_spill - true if the producer may move to the overflow
+    * buffer now, it has one, it isn't on it already, the
+    * consumer is done with the last one and it is big enough.
+    * @param   minimum - const std::size_t, slots the write needs
+    * @return  bool
+    */
+   bool can_spill( const std::size_t minimum ) const
+   {
+      return( spill &&
+              ! (this)->allocate_called &&
+              minimum <= spill_cap &&
+              ! spill_busy.load( std::memory_order_acquire ) );
+   }
+
+   /**
+    * overflow_drained - producer side, true once the consumer
+    * has read everything written to the overflow buffer.
+    * @return  bool
+    */
+   bool overflow_drained()
+   {
+      return( ! (this)->allocate_called &&
+              Pointer::space( data->write_pt, data->read_pt, data->max_cap ) == data->max_cap );
+   }
+
+   /**
+    * spill_over - producer side, the buffer in memory is full,
+    * remembers what it was and moves to the overflow buffer.
+    */
+   void spill_over( std::true_type )
+   {
+      Buffer::Data< T, type, layout, SIZE > *old( data );
+      ring_cap       = old->max_cap;
+      ring_align     = old->alignment;
+      ring_placement = old->placement;
+      spill_busy.store( true, std::memory_order_relaxed );
+      link( Buffer::Data< T, type, layout, SIZE >::make( spill_cap, 
+                                                        L1D_CACHE_LINE_SIZE, 
+                                                        *spill ) );
+   }
+
+   void spill_over( std::false_type )
+   {
+   }
+
+   /**
+    * unspill - producer side, the consumer has caught up with
+    * the overflow, back to a buffer in memory of the capacity
+    * the queue had before it spilled.
+    */
+   void unspill( std::true_type )
+   {
+      link( new Buffer::Data< T, type, layout, SIZE >( ring_cap,
+                                                      ring_align,
+                                                      ring_placement ) );
+   }
+
+   void unspill( std::false_type )
+   {
+   }
+
+   /**
+    * follow - consumer side, frees the drained buffer and 
+    * moves on to the one the producer switched to.
+    */
+   void follow()
+   {
+      Buffer::Data< T, type, layout, SIZE > *old( read_data );
+      while( ! old->released.load( std::memory_order_acquire ) )
+      {
+         std::this_thread::yield();
+      }
+      read_data = static_cast< Buffer::Data< T, type, layout, SIZE >* >( 
+         old->next.load( std::memory_order_acquire ) );
+      /** 
+       * new callers of size() start past old, wait out the
+       * ones that may still be looking at it, all seq_cst
+       * so one side always sees the other
+       */
+      read_head.store( read_data );
+      const auto previous( epoch.fetch_add( 1 ) );
+      while( sizing[ previous & 1 ].load() != 0 )
+      {
+         std::this_thread::yield();
+      }
+      const bool spilled( spill && spill->owns( old ) );
+      Buffer::release( old );
+      if( spilled )
+      {
+         /** the producer may spill again **/
+         spill->clear();
+         spill_busy.store( false, std::memory_order_release );
+      }
+   }
+
+   /**
+    * occupancy - items in buff, the read pointer is loaded
+    * first, the write pointer can only be ahead of it so the
+    * difference is never negative.  If both sides moved
+    * between the loads the difference can momentarily 
+    * overshoot, clamp it to the buffer's capacity.
+    * @param   buff - Buffer::Data< T, type, layout, SIZE >*
+    * @return  std::size_t
+    */
+   static std::size_t occupancy( Buffer::Data< T, type, layout, SIZE > *buff )
+   {
+      const auto   rpt( Pointer::position( buff->read_pt  ) );
+      const auto   wpt( Pointer::position( buff->write_pt ) );
+      const std::size_t   diff( wpt - rpt );
+      return( diff > slots( buff ) ? slots( buff ) : diff );
+   }
+
+   /**
+    * Sizing - held while a thread other than the consumer
+    * may be looking at a buffer.  Callers count themselves
+    * in under the current epoch, follow() moves the epoch
+    * on and only waits for those counted under the old one,
+    * so a thread calling size() in a loop can't hold up 
+    * the consumer for longer than a single call.
+    */
+   struct Sizing
+   {
+      Sizing( RingBufferBase &queue ) : queue( queue )
+      {
+         for( ;; )
+         {
+            const auto current( queue.epoch.load() );
+            in = &queue.sizing[ current & 1 ];
+            in->fetch_add( 1 );
+            if( queue.epoch.load() == current )
+            {
+               break;
+            }
+            /** follow() moved on in between, may not have waited for us **/
+            in->fetch_sub( 1, std::memory_order_release );
+         }
+      }
+
+      ~Sizing()
+      {
+         in->fetch_sub( 1, std::memory_order_release );
+      }
+
+      RingBufferBase              &queue;
+      std::atomic< std::size_t >  *in = nullptr;
+   };
+
+   /**
+    * publish_write - moves the write pointer forward by n
+    * and wakes a parked consumer if there might be one.
+    * @param   n      - const std::size_t
+    * @param   signal - const RBSignal, carried by the last
+    *                   of the n, default NONE
+    */
+   void publish_write( const std::size_t n, 
+                       const RBSignal signal = RBSignal::NONE )
+   {
+      Pointer::incBy( n, data->write_pt );
+      if( signal == RBSignal::RBEOF )
+      {
+         /** the end of the stream is in the queue now, not before **/
+         write_finished.store( true, std::memory_order_release );
+      }
+      if( wait_policy.strategy == Wait::Park )
+      {
+         Pointer::wake( data->write_pt );
+         /** after the fence in wake(), see Async::Slot **/
+         read_waiter.fire();
+      }
+      (this)->read_hook.fire();
+      probe.wrote( n, [&]() -> std::uint64_t
+      {
+         return( Pointer::position( data->write_pt ) - 
+                 Pointer::position( data->read_pt ) );
+      } );
+   }
+
+   /**
+    * publish_read - moves the read pointer forward by n 
+    * and wakes a parked producer if there might be one.
+    * @param   n - const std::size_t
+    */
+   void publish_read( const std::size_t n )
+   {
+      if( read_data->retire_signals( n ) )
+      {
+         /** the consumer end of an SHM or TCP queue learns of it here **/
+         write_finished.store( true, std::memory_order_release );
+      }
+      Pointer::incBy( n, read_data->read_pt );
+      if( wait_policy.strategy == Wait::Park )
+      {
+         Pointer::wake( read_data->read_pt );
+         /** after the fence in wake(), see Async::Slot **/
+         write_waiter.fire();
+      }
+      (this)->write_hook.fire();
+      probe.read( n );
    }
 
    /**
     * Buffer structure that is the core of the ring
-    * buffer.
+    * buffer, this is the one the producer writes to.
     */
-   Buffer::Data< T, type>      *data;
+   Buffer::Handle< Buffer::Data< T, type, layout, SIZE > > data;
+   /** 
+    * buffer the consumer reads from, only differs from 
+    * data while the consumer drains a resized buffer.
+    */
+   Buffer::Data< T, type, layout, SIZE >  *read_data;
+   /** read_data as seen by size() from other threads **/
+   std::atomic< Buffer::Data< T, type, layout, SIZE >* > read_head{ nullptr };
+   /** callers of size() / space_avail() in flight by epoch, see Sizing **/
+   std::atomic< std::size_t >       epoch{ 0 };
+   std::atomic< std::size_t >       sizing[ 2 ] = { { 0 }, { 0 } };
+   /** capacity asked for by resize(), zero if none **/
+   std::atomic< std::size_t >       resize_request;
+   /** capacity of data, readable from any thread **/
+   std::atomic< std::size_t >       cap;
    /**
     * these two should go inside the buffer, they'll
     * be accessed via the monitoring system.
     */
-   volatile Blocked             read_stats;
-   volatile Blocked             write_stats;
+   BlockedCounter               read_stats;
+   BlockedCounter               write_stats;
    /** 
     * This should be okay outside of the buffer, its local 
     * to the writing thread.  Variable gets set "true" in
@@ -539,7 +1558,28 @@ protected:
     * only the signal argument is called.
     */
    volatile bool                allocate_called;
-   /** TODO, this needs to get moved into the buffer for SHM **/
-   volatile bool                write_finished;
+   /** number of slots handed out by the last allocate call **/
+   std::size_t                  allocate_count;
+   /** 
+    * set once an RBEOF has been published by the producer, 
+    * or read by the consumer for the Sparse layout
+    */
+   std::atomic< bool >          write_finished;
+   /** what to do when blocked, see waitstrategy.hpp **/
+   Wait::Policy                 wait_policy;
+   /** counters for the stats registry, empty unless FIFO_INSTRUMENT **/
+   Stats::FIFOProbe             probe;
+   /** coroutines suspended in async_pop / async_push, see async.hpp **/
+   Async::Slot                  read_waiter;
+   Async::Slot                  write_waiter;
+   /** overflow buffer's file mapping, see spill_to() **/
+   std::unique_ptr< FIFOArena > spill;
+   std::size_t                  spill_cap       = 0;
+   /** set by the producer as it spills, cleared by the consumer **/
+   std::atomic< bool >          spill_busy{ false };
+   /** what the buffer in memory was before the producer spilled **/
+   std::size_t                  ring_cap        = 0;
+   std::size_t                  ring_align      = 16;
+   Placement::Options           ring_placement;
 };
 #endif /* END _RINGBUFFERHEAP_TCC_ */
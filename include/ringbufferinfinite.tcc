@@ -20,9 +20,15 @@
 #ifndef _RINGBUFFERINFINITE_TCC_
 #define _RINGBUFFERINFINITE_TCC_  1
 
-template < class T > class RingBufferBase< T, Type::Infinite > : 
+template < class T, 
+           Layout::SlotLayout layout > class RingBufferBase< T, Type::Infinite, layout > : 
    public FIFOAbstract< T, Type::Infinite >
 {
+   static_assert( layout != Layout::Sparse,
+                  "Type::Infinite has no use for Layout::Sparse" );
+   /** every pop copies the one item out, it never leaves **/
+   static_assert( std::is_copy_constructible< T >::value,
+                  "Type::Infinite pops copies, T has to be copy constructible" );
 public:
    /**
     * RingBuffer - default constructor, initializes basic
@@ -31,6 +37,7 @@ public:
    RingBufferBase() : FIFOAbstract< T, Type::Infinite >(),
                       data( nullptr ),
                       allocate_called( false ),
+                      allocate_count( 0 ),
                       write_finished( false )
    {
    }
@@ -50,35 +57,6 @@ public:
       return( 1 );
    }
 
-   virtual RBSignal get_signal() 
-   {
-#if 0   
-      /** 
-       * there are two signalling paths, the one 
-       * we'll give the highest priority to is the 
-       * asynchronous one.
-       */
-      const auto signal_queue( data->store[ 0 ].signal );
-      /**
-       * TODO, fix this
-       */
-      const auto signal_local( (this)->signal_a );
-      if( signal_local == RBSignal::NONE )
-      {
-         return( signal_queue );
-      }
-      /** there must be something in the local signal **/
-      //(this)->signal = RBSignal::NONE;
-#endif      
-      return( RBSignal::NONE );
-   }
-
-   virtual bool send_signal( const RBSignal &signal )
-   {
-      //(this)->signal = signal;
-      return( true );
-   }
-
    /**
     * space_avail - returns the amount of space currently
     * available in the queue.  This is the amount a user
@@ -112,12 +90,37 @@ public:
    virtual void push( const RBSignal signal = RBSignal::NONE )
    {
       if( ! (this)->allocate_called ) return;
-      data->signal[ 0 ].sig = signal;
-      write_stats.count++;
+      data->write_signal( 0, signal );
+      write_stats.add( 1 );
       (this)->allocate_called = false;
    }
 
    
+   /**
+    * push_range - releases the range handed out by
+    * allocate_range(), like everything else on this 
+    * queue only the count matters.
+    * @param   count  - const std::size_t
+    * @param   signal - const RBSignal, default: NONE
+    */
+   virtual void push_range( const std::size_t count,
+                            const RBSignal signal = RBSignal::NONE )
+   {
+      if( ! (this)->allocate_called ) return;
+      /** only the first slot stays live **/
+      if( (this)->allocate_count == 0 )
+      {
+         new ( &data->store[ 0 ].item ) T();
+      }
+      else
+      {
+         data->destroy( 1, (this)->allocate_count - 1 );
+      }
+      data->write_signal( 0, signal );
+      write_stats.add( count );
+      (this)->allocate_called = false;
+   }
+   
    /**
     * recycle - remove ``range'' items from the head of the
     * queue and discard them.  Can be used in conjunction with
@@ -126,19 +129,17 @@ public:
     */
    virtual void recycle( const std::size_t range = 1 )
    {
-      read_stats.count += range;
+      read_stats.add( range );
    }
 
    virtual void get_zero_read_stats( Blocked &copy )
    {
-      copy.all       = read_stats.all;
-      read_stats.all = 0;
+      copy = read_stats.take();
    }
 
    virtual void get_zero_write_stats( Blocked &copy )
    {
-      copy.all       = write_stats.all;
-      write_stats.all = 0;
+      copy = write_stats.take();
    }
 
    virtual void get_write_finished( bool &write_finished )
@@ -150,17 +151,38 @@ protected:
    
    virtual void  local_allocate( void **ptr )
    {
-      (this)->allocate_called = true;
+      hand_out( 1 );
       *ptr = (void*)&(data->store[ 0 ].item);
    }
    
+   virtual void  local_allocate_range( void **ptr,
+                                       std::size_t *length,
+                                       std::size_t &stride,
+                                       const std::size_t n )
+   {
+      stride      = sizeof( typename Buffer::DataBase< T, layout >::element_t );
+      length[ 0 ] = std::min( n, data->max_cap );
+      hand_out( length[ 0 ] );
+      ptr   [ 0 ] = (void*)&(data->store[ 0 ].item);
+      ptr   [ 1 ] = (void*)&(data->store[ 0 ].item);
+      length[ 1 ] = 0;
+   }
+   
    virtual void  local_push( void *ptr, const RBSignal &signal )
    {
       T *item (reinterpret_cast< T* >( ptr ) );
-      data->store [ 0 ].item  = *item;
+      Buffer::copy_assign( data->store[ 0 ].item, *item );
       /** a bit awkward since it gives the same behavior as the actual queue **/
-      data->signal[ 0 ].sig  = signal;
-      write_stats.count++;
+      data->write_signal( 0, signal );
+      write_stats.add( 1 );
+   }
+
+   virtual void  local_push_move( void *ptr, const RBSignal &signal )
+   {
+      T *item (reinterpret_cast< T* >( ptr ) );
+      data->store [ 0 ].item  = std::move( *item );
+      data->write_signal( 0, signal );
+      write_stats.add( 1 );
    }
 
    template< class iterator_type >
@@ -170,61 +192,33 @@ protected:
    {
       while( begin != end )
       {
-         data->store[ 0 ].item = (*begin);
+         Buffer::copy_assign( data->store[ 0 ].item, *begin );
          begin++;
-         write_stats.count++;
+         write_stats.add( 1 );
       }
-      data->signal[ 0 ].sig = signal;
+      data->write_signal( 0, signal );
       return;
    }
    
 
-   virtual void local_insert( void *begin_ptr,
-                              void *end_ptr,
-                              const RBSignal &signal,
-                              const std::size_t iterator_type )
+   virtual void local_insert( const void *ptr,
+                              const std::size_t n_items,
+                              const RBSignal &signal )
    {
-      typedef typename std::list< T >::iterator   it_list;
-      typedef typename std::vector< T >::iterator it_vec;
-         
-      const std::map< std::size_t, 
-                std::function< void (void*,void*,const RBSignal&) > > func_map
-                  = {{ typeid( it_list ).hash_code(), 
-                       [ & ]( void *b_ptr, void *e_ptr, const RBSignal &sig )
-                       {
-                           it_list *begin( reinterpret_cast< it_list* >( b_ptr ) );
-                           it_list *end  ( reinterpret_cast< it_list* >( e_ptr   ) );
-                           local_insert_helper( *begin, *end, signal );
-                       } },
-                     { typeid( it_vec ).hash_code(),
-                       [ & ]( void *b_ptr, void *e_ptr, const RBSignal &sig )
-                       {
-                           it_vec *begin( reinterpret_cast< it_vec* >( b_ptr ) );
-                           it_vec *end  ( reinterpret_cast< it_vec* >( e_ptr   ) );
-                           local_insert_helper( *begin, *end, signal );
-
-                       } } };
-      auto f( func_map.find( iterator_type ) );
-      if( f != func_map.end() )
-      {
-         (*f).second( begin_ptr, end_ptr, signal );
-      }
-      else
-      {
-         /** TODO, throw exception **/
-      }
+      const T *begin( reinterpret_cast< const T* >( ptr ) );
+      local_insert_helper( begin, begin + n_items, signal );
       return;
    }
 
    virtual void local_pop( void *ptr, RBSignal *signal )
    {
       T *item( reinterpret_cast< T* >( ptr ) );
-      *item  = data->store[ 0 ].item;
+      Buffer::copy_assign( *item, data->store[ 0 ].item );
       if( signal != nullptr )
       {
-         *signal = data->signal[ 0 ].sig;
+         *signal = data->read_signal( 0 );
       }
-      read_stats.count++;
+      read_stats.add( 1 );
    }
   
    virtual void local_pop_range( void *ptr_data,
@@ -238,15 +232,15 @@ protected:
       {
          for( size_t i( 0 ); i < n_items; i++ )
          {
-            items [ i ]  = data->store [ 0 ].item;
-            signal[ i ]  = data->signal[ 0 ].sig;
+            Buffer::copy_assign( items[ i ], data->store[ 0 ].item );
+            signal[ i ]  = data->read_signal( 0 );
          }
       }
       else
       {
          for( size_t i( 0 ); i < n_items; i++ )
          {
-            items [ i ]  = data->store [ 0 ].item;
+            Buffer::copy_assign( items[ i ], data->store[ 0 ].item );
          }
       }
    }
@@ -257,17 +251,125 @@ protected:
       *ptr = (void*)&( data->store[ 0 ].item );
       if( signal != nullptr )
       {
-         *signal = data->signal[  0  ].sig;
+         *signal = data->read_signal( 0 );
+      }
+   }
+
+   /** there is only ever the one item to look at **/
+   virtual void local_peek_range( void **ptr,
+                                  std::size_t *length,
+                                  std::size_t &stride,
+                                  RBSignal *signal,
+                                  const std::size_t n )
+   {
+      stride      = sizeof( typename Buffer::DataBase< T, layout >::element_t );
+      RingBufferBase::local_peek( &ptr[ 0 ], signal );
+      length[ 0 ] = std::min( n, std::size_t( 1 ) );
+      ptr   [ 1 ] = ptr[ 0 ];
+      length[ 1 ] = 0;
+   }
+
+   /** 
+    * the try versions, this queue is never full or empty so 
+    * they never have to wait and always succeed 
+    */
+   virtual bool local_try_allocate( void **ptr, const Wait::Deadline &deadline )
+   {
+      RingBufferBase::local_allocate( ptr );
+      return( true );
+   }
+
+   virtual bool local_try_push( void *ptr, 
+                                const RBSignal &signal,
+                                const Wait::Deadline &deadline )
+   {
+      RingBufferBase::local_push( ptr, signal );
+      return( true );
+   }
+
+   virtual bool local_try_push_move( void *ptr, 
+                                     const RBSignal &signal,
+                                     const Wait::Deadline &deadline )
+   {
+      RingBufferBase::local_push_move( ptr, signal );
+      return( true );
+   }
+
+   virtual bool local_try_pop( void *ptr, 
+                               RBSignal *signal,
+                               const Wait::Deadline &deadline )
+   {
+      RingBufferBase::local_pop( ptr, signal );
+      return( true );
+   }
+
+   virtual std::size_t local_try_pop_range( void *ptr_data,
+                                            RBSignal *signal,
+                                            std::size_t n_items,
+                                            const Wait::Deadline &deadline )
+   {
+      RingBufferBase::local_pop_range( ptr_data, signal, n_items );
+      return( n_items );
+   }
+
+   /** the one item over and over, just once if it has a signal **/
+   virtual std::size_t local_pop_until_signal( void *ptr_data,
+                                               RBSignal *signal,
+                                               const std::size_t n_items )
+   {
+      *signal = data->read_signal( 0 );
+      const std::size_t count( *signal == RBSignal::NONE ? n_items : 1 );
+      RingBufferBase::local_pop_range( ptr_data, nullptr, count );
+      return( count );
+   }
+
+   /** 
+    * hand_out - allocate() constructs the slots it gets, so
+    * the first slot, normally always live, is destroyed 
+    * before being handed out.
+    * @param   count - const std::size_t, slots handed out
+    */
+   void hand_out( const std::size_t count )
+   {
+      if( ! (this)->allocate_called )
+      {
+         data->destroy( 0, 1 );
       }
+      (this)->allocate_called = true;
+      (this)->allocate_count  = count;
+   }
+
+   /** 
+    * called by the constructor with the buffer to use, the
+    * first slot is kept live from here on as it is read and
+    * written in place.
+    */
+   void attach_data( Buffer::Data< T, Type::Infinite, layout > *buff )
+   {
+      data = buff;
+      new ( &data->store[ 0 ].item ) T();
    }
 
-   /** go ahead and allocate a buffer as a heap, doesn't really matter **/
-   Buffer::Data< T, Type::Heap >      *data;
+   /** called by the destructor **/
+   void release_data()
+   {
+      data->destroy( 0, 1 );
+      delete( data );
+      data = nullptr;
+   }
+
+   /** 
+    * same layout as a heap buffer (the primary Data template),
+    * only the first slot is ever used
+    */
+   Buffer::Data< T, Type::Infinite, layout > *data;
    /** note, these need to get moved into the data struct **/
-   volatile Blocked                             read_stats;
-   volatile Blocked                             write_stats;
+   BlockedCounter                               read_stats;
+   BlockedCounter                               write_stats;
    
    volatile bool                                allocate_called;
+   /** slots handed out by the last allocate call **/
+   std::size_t                                  allocate_count;
    volatile bool                                write_finished;
 };
 #endif /* END _RINGBUFFERINFINITE_TCC_ */
@@ -0,0 +1,820 @@
+/**
+ * ringbuffermulti.tcc -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 14:02:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RINGBUFFERMULTI_TCC_
+#define _RINGBUFFERMULTI_TCC_  1
+#include <atomic>
+#include <vector>
+
+/**
+ * RingBufferMulti - common implementation of the MPSC, SPMC and
+ * MPMC buffers.  Every slot carries a sequence number (see
+ * Buffer::Slot), a thread claims one or more slots by moving the
+ * enqueue or dequeue position with a CAS, fills or reads them
+ * and then hands each one over by bumping its sequence number.
+ * The side that only has a single thread skips the CAS.
+ *
+ * Slots handed out by allocate(), allocate_range() and peek()
+ * are remembered per thread so that any number of threads can
+ * hold a reservation at the same time and allocate() stays
+ * zero-copy.  Reserved slots that aren't released by push_range()
+ * are marked skip and passed over by consumers.  Items are read
+ * in position order per claim, with more than one consumer a
+ * pop_range() may be interleaved with other consumers.
+ */
+template < class T,
+           Type::RingBufferType type,
+           Layout::SlotLayout layout > class RingBufferMulti :
+            public FIFOAbstract< T, type > {
+   /** the side queue of Layout::Sparse assumes one thread on each end **/
+   static_assert( layout != Layout::Sparse,
+                  "Layout::Sparse is for single producer, single consumer queues" );
+public:
+   RingBufferMulti() : FIFOAbstract< T, type >(),
+                       data( nullptr ),
+                       read_count( 0 ),
+                       write_count( 0 ),
+                       read_blocked( false ),
+                       write_blocked( false ),
+                       write_finished( false ),
+                       id( next_id() )
+   {
+   }
+
+   virtual ~RingBufferMulti()
+   {
+      /** 
+       * drop any reservations this thread still holds on us,
+       * other threads' go stale, id keeps a later queue at
+       * the same address from picking them up
+       */
+      take( write_reservations() );
+      take( read_reservations() );
+   }
+
+   /**
+    * size - returns the number of slots claimed by producers
+    * but not yet claimed by consumers, this includes slots
+    * that are still being written.
+    * @return size_t
+    */
+   virtual std::size_t   size()
+   {
+      const auto   rpt( data->dequeue_pos->load( std::memory_order_acquire ) );
+      const auto   wpt( data->enqueue_pos->load( std::memory_order_acquire ) );
+      const std::size_t   diff( wpt - rpt );
+      return( diff > data->max_cap ? data->max_cap : diff );
+   }
+
+   /**
+    * space_avail - returns the amount of space currently
+    * available in the queue, with several producers this
+    * is only a hint.
+    * @return  size_t
+    */
+   virtual std::size_t   space_avail()
+   {
+      return( data->max_cap - size() );
+   }
+
+   virtual std::size_t   capacity() const
+   {
+      return( data->max_cap );
+   }
+
+   /**
+    * push - releases the slot handed to this thread by the
+    * last allocate().  If it came from allocate_range() the
+    * first slot is released and the rest are skipped.
+    * Function will simply return if this thread hasn't
+    * called allocate.
+    * @param signal - const RBSignal signal, default: NONE
+    */
+   virtual void push( const RBSignal signal = RBSignal::NONE )
+   {
+      push_range( 1, signal );
+   }
+
+   /**
+    * push_range - releases the first count slots handed to
+    * this thread by allocate_range(), the rest of the range
+    * is skipped.  Function will simply return if this thread
+    * hasn't called allocate.
+    * @param   count  - const std::size_t
+    * @param   signal - const RBSignal, default: NONE
+    */
+   virtual void push_range( const std::size_t count,
+                            const RBSignal signal = RBSignal::NONE )
+   {
+      Reservation res;
+      if( ! take( write_reservations(), &res ) )
+      {
+         return;
+      }
+      assert( count <= res.count );
+      for( std::size_t i( 0 ); i < res.count; i++ )
+      {
+         auto &slot( data->slot( res.pos + i ) );
+         slot.skip   = ( i >= count );
+         if( slot.skip && i < res.built )
+         {
+            slot.item.~T();
+         }
+         slot.signal = ( i + 1 == count ? signal : RBSignal::NONE );
+         slot.seq.store( res.pos + i + 1, std::memory_order_release );
+      }
+      wake( data->write_pt );
+      write_count.fetch_add( count, std::memory_order_relaxed );
+      if( count > 0 && signal == RBSignal::RBEOF )
+      {
+         write_finished.store( true, std::memory_order_relaxed );
+      }
+   }
+
+   /**
+    * recycle - discards range items from the head of the
+    * queue, if this thread peek()'d an item that item is
+    * the first one discarded.
+    * @param range - const size_t, default range is 1
+    */
+   virtual void recycle( const std::size_t range = 1 )
+   {
+      if( range == 0 )
+      {
+         return;
+      }
+      std::size_t left( range );
+      Reservation res;
+      if( take( read_reservations(), &res ) )
+      {
+         /** peeked items are never skipped ones **/
+         data->slot( res.pos ).item.~T();
+         release( res.pos );
+         read_count.fetch_add( 1, std::memory_order_relaxed );
+         left--;
+      }
+      consume( nullptr, nullptr, left );
+   }
+
+   virtual void get_zero_read_stats( Blocked &copy )
+   {
+      copy.count   = read_count.exchange( 0, std::memory_order_relaxed );
+      copy.blocked = read_blocked.exchange( false, std::memory_order_relaxed );
+   }
+
+   virtual void get_zero_write_stats( Blocked &copy )
+   {
+      copy.count   = write_count.exchange( 0, std::memory_order_relaxed );
+      copy.blocked = write_blocked.exchange( false, std::memory_order_relaxed );
+   }
+
+   /**
+    * get_write_finished - true once any producer has sent
+    * RBSignal::RBEOF.
+    * @param   write_finished - bool&
+    */
+   virtual void get_write_finished( bool &write_finished )
+   {
+      write_finished = (this)->write_finished.load( std::memory_order_relaxed );
+   }
+
+   virtual void set_wait_policy( const Wait::Policy &policy )
+   {
+      wait_policy = policy;
+   }
+
+protected:
+   /** called by the constructor with the buffer to use **/
+   void attach_data( Buffer::Data< T, type, layout > *buff )
+   {
+      data = buff;
+   }
+
+   /** called by the destructor **/
+   void release_data()
+   {
+      delete( data );
+      data = nullptr;
+   }
+
+   static constexpr bool multi_producer = ( type != Type::SPMC );
+   static constexpr bool multi_consumer = ( type != Type::MPSC );
+
+   /**
+    * Reservation - slots [ pos, pos + count ) held by the
+    * calling thread for the queue with id owner.
+    */
+   struct Reservation
+   {
+      std::uint64_t   owner;
+      std::uint64_t   pos;
+      std::size_t     count;
+      /** slots from pos handed out so far, allocate constructs them **/
+      std::size_t     built;
+   };
+
+   /** per thread reservation lists, usually a single entry **/
+   static std::vector< Reservation >& write_reservations()
+   {
+      static thread_local std::vector< Reservation > list;
+      return( list );
+   }
+
+   static std::vector< Reservation >& read_reservations()
+   {
+      static thread_local std::vector< Reservation > list;
+      return( list );
+   }
+
+   /** 
+    * next_id - ids are never reused, unlike addresses
+    * @return  std::uint64_t
+    */
+   static std::uint64_t next_id()
+   {
+      static std::atomic< std::uint64_t > count( 0 );
+      return( count.fetch_add( 1, std::memory_order_relaxed ) );
+   }
+
+   /**
+    * find - returns this queue's reservation in list or
+    * nullptr if there isn't one.
+    */
+   Reservation* find( std::vector< Reservation > &list )
+   {
+      for( auto &res : list )
+      {
+         if( res.owner == id )
+         {
+            return( &res );
+         }
+      }
+      return( nullptr );
+   }
+
+   /**
+    * take - removes this queue's reservation from list and
+    * copies it to out if out isn't null.
+    * @return  bool, false if there wasn't one
+    */
+   bool take( std::vector< Reservation > &list, Reservation *out = nullptr )
+   {
+      auto *res( find( list ) );
+      if( res == nullptr )
+      {
+         return( false );
+      }
+      if( out != nullptr )
+      {
+         *out = *res;
+      }
+      *res = list.back();
+      list.pop_back();
+      return( true );
+   }
+
+   virtual void local_allocate( void **ptr )
+   {
+      RingBufferMulti::local_try_allocate( ptr, Wait::Deadline::max() );
+   }
+
+   /**
+    * local_try_allocate - local_allocate() that gives up at
+    * deadline.
+    * @return  bool, false if no slot could be claimed by then
+    */
+   virtual bool local_try_allocate( void **ptr, const Wait::Deadline &deadline )
+   {
+      std::size_t length[ 2 ];
+      void       *range [ 2 ];
+      std::size_t stride;
+      if( ! reserve_write( range, length, stride, 1, deadline ) )
+      {
+         return( false );
+      }
+      *ptr = range[ 0 ];
+      return( true );
+   }
+
+   /**
+    * local_allocate_range - reserves up to n consecutive free
+    * slots for the calling thread, blocks until there is at
+    * least one.  Calling it again before push returns the
+    * slots already held.
+    */
+   virtual void local_allocate_range( void **ptr,
+                                      std::size_t *length,
+                                      std::size_t &stride,
+                                      const std::size_t n )
+   {
+      reserve_write( ptr, length, stride, n, Wait::Deadline::max() );
+   }
+
+   /**
+    * reserve_write - local_allocate_range() that gives up at
+    * deadline.
+    * @return  bool, false if no slot could be claimed by then
+    */
+   bool reserve_write( void **ptr,
+                       std::size_t *length,
+                       std::size_t &stride,
+                       const std::size_t n,
+                       const Wait::Deadline &deadline )
+   {
+      assert( ptr != nullptr && length != nullptr );
+      stride = sizeof( typename Buffer::MultiData< T >::slot_t );
+      auto *res( find( write_reservations() ) );
+      if( res == nullptr )
+      {
+         std::uint64_t pos( 0 );
+         const auto count( claim_write( pos, n, deadline ) );
+         if( count == 0 )
+         {
+            return( false );
+         }
+         write_reservations().push_back( { id, pos, count, 0 } );
+         res = &write_reservations().back();
+      }
+      const std::size_t count( std::min( std::max< std::size_t >( n, 1 ),
+                                         res->count ) );
+      res->built = std::max( res->built, count );
+      const std::size_t index( res->pos % data->max_cap );
+      const std::size_t first( std::min( count, data->max_cap - index ) );
+      ptr   [ 0 ] = (void*)&( data->slots[ index ].item );
+      length[ 0 ] = first;
+      ptr   [ 1 ] = (void*)&( data->slots[ 0 ].item );
+      length[ 1 ] = count - first;
+      return( true );
+   }
+
+   virtual void  local_push( void *ptr, const RBSignal &signal )
+   {
+      assert( ptr != nullptr );
+      local_insert( ptr, 1, signal );
+   }
+
+   virtual void  local_push_move( void *ptr, const RBSignal &signal )
+   {
+      RingBufferMulti::local_try_push_move( ptr, signal, Wait::Deadline::max() );
+   }
+
+   virtual bool  local_try_push( void *ptr, 
+                                 const RBSignal &signal,
+                                 const Wait::Deadline &deadline )
+   {
+      assert( ptr != nullptr );
+      std::uint64_t pos( 0 );
+      if( claim_write( pos, 1, deadline ) == 0 )
+      {
+         return( false );
+      }
+      Buffer::copy_construct( &data->slot( pos ).item, *reinterpret_cast< const T* >( ptr ) );
+      publish( pos, signal );
+      return( true );
+   }
+
+   virtual bool  local_try_push_move( void *ptr, 
+                                      const RBSignal &signal,
+                                      const Wait::Deadline &deadline )
+   {
+      assert( ptr != nullptr );
+      std::uint64_t pos( 0 );
+      if( claim_write( pos, 1, deadline ) == 0 )
+      {
+         return( false );
+      }
+      new ( &data->slot( pos ).item ) T( std::move( *reinterpret_cast< T* >( ptr ) ) );
+      publish( pos, signal );
+      return( true );
+   }
+
+   /**
+    * publish - hands the single slot at pos, already built,
+    * to the consumers.
+    */
+   void publish( const std::uint64_t pos, const RBSignal signal )
+   {
+      auto &slot( data->slot( pos ) );
+      slot.skip   = false;
+      slot.signal = signal;
+      slot.seq.store( pos + 1, std::memory_order_release );
+      wake( data->write_pt );
+      write_count.fetch_add( 1, std::memory_order_relaxed );
+      if( signal == RBSignal::RBEOF )
+      {
+         write_finished.store( true, std::memory_order_relaxed );
+      }
+   }
+
+   /**
+    * local_insert - copies n_items from ptr into the queue
+    * claiming as many slots at a time as are free, the signal
+    * goes with the last item.
+    */
+   virtual void local_insert( const void *ptr,
+                              const std::size_t n_items,
+                              const RBSignal &signal )
+   {
+      assert( ptr != nullptr );
+      const T *items( reinterpret_cast< const T* >( ptr ) );
+      std::size_t remaining( n_items );
+      while( remaining > 0 )
+      {
+         std::uint64_t pos( 0 );
+         const auto count( claim_write( pos, remaining ) );
+         remaining -= count;
+         for( std::size_t i( 0 ); i < count; i++ )
+         {
+            auto &slot( data->slot( pos + i ) );
+            Buffer::copy_construct( &slot.item, *items++ );
+            slot.skip   = false;
+            slot.signal = ( remaining == 0 && i + 1 == count ?
+                            signal : RBSignal::NONE );
+            slot.seq.store( pos + i + 1, std::memory_order_release );
+         }
+         wake( data->write_pt );
+         write_count.fetch_add( count, std::memory_order_relaxed );
+      }
+      if( signal == RBSignal::RBEOF )
+      {
+         write_finished.store( true, std::memory_order_relaxed );
+      }
+   }
+
+   virtual void local_pop( void *ptr, RBSignal *signal )
+   {
+      assert( ptr != nullptr );
+      consume( reinterpret_cast< T* >( ptr ), signal, 1 );
+   }
+
+   virtual bool local_try_pop( void *ptr, 
+                               RBSignal *signal,
+                               const Wait::Deadline &deadline )
+   {
+      assert( ptr != nullptr );
+      return( consume( reinterpret_cast< T* >( ptr ), signal, 1, deadline ) == 1 );
+   }
+
+   virtual std::size_t local_try_pop_range( void *ptr_data,
+                                            RBSignal *signal,
+                                            std::size_t n_items,
+                                            const Wait::Deadline &deadline )
+   {
+      assert( ptr_data != nullptr );
+      return( consume( reinterpret_cast< T* >( ptr_data ), signal, n_items, deadline ) );
+   }
+
+   virtual void  local_pop_range( void     *ptr_data,
+                                  RBSignal *signal,
+                                  std::size_t n_items )
+   {
+      assert( ptr_data != nullptr );
+      consume( reinterpret_cast< T* >( ptr_data ), signal, n_items );
+   }
+
+   /**
+    * local_pop_until_signal - one item per claim, a claimed
+    * range can't be handed back part way through if one of its
+    * items carries a signal.  Only waits for the first.
+    */
+   virtual std::size_t local_pop_until_signal( void *ptr_data,
+                                               RBSignal *signal,
+                                               const std::size_t n_items )
+   {
+      assert( ptr_data != nullptr && signal != nullptr );
+      auto *items( reinterpret_cast< T* >( ptr_data ) );
+      std::size_t popped( 0 );
+      auto until( Wait::Deadline::max() );
+      *signal = RBSignal::NONE;
+      while( popped < n_items && 
+             *signal == RBSignal::NONE && 
+             consume( items + popped, signal, 1, until ) == 1 )
+      {
+         popped++;
+         until = Wait::Deadline::min();
+      }
+      return( popped );
+   }
+
+   /**
+    * local_peek - claims the head of the queue for the calling
+    * thread without removing it, other consumers move on to the
+    * next item.  It stays claimed until this thread calls
+    * recycle(), peeking again returns the same item.
+    */
+   virtual void local_peek(  void **ptr, RBSignal *signal )
+   {
+      auto *res( find( read_reservations() ) );
+      if( res == nullptr )
+      {
+         std::uint64_t pos( 0 );
+         do
+         {
+            claim_read( pos, 1 );
+            if( ! data->slot( pos ).skip )
+            {
+               break;
+            }
+            release( pos );
+         }while( true );
+         read_reservations().push_back( { id, pos, 1, 0 } );
+         res = &read_reservations().back();
+      }
+      auto &slot( data->slot( res->pos ) );
+      if( signal != nullptr )
+      {
+         *signal = slot.signal;
+      }
+      *ptr = (void*) &( slot.item );
+   }
+
+   /**
+    * local_peek_range - one item, the one local_peek() claims,
+    * other consumers may be taking the items behind it.
+    */
+   virtual void local_peek_range( void **ptr,
+                                  std::size_t *length,
+                                  std::size_t &stride,
+                                  RBSignal *signal,
+                                  const std::size_t n )
+   {
+      assert( ptr != nullptr && length != nullptr && n > 0 );
+      stride = sizeof( typename Buffer::MultiData< T >::slot_t );
+      RingBufferMulti::local_peek( &ptr[ 0 ], signal );
+      length[ 0 ] = 1;
+      ptr   [ 1 ] = ptr[ 0 ];
+      length[ 1 ] = 0;
+   }
+
+   /**
+    * consume - reads n items into items (discards them if
+    * items is null) along with their signals, skipped slots
+    * don't count.  Blocks until all n have been read, or
+    * with a deadline until the first have been read and then
+    * takes only what is already there.
+    * @return  std::size_t, items read
+    */
+   std::size_t consume( T *items, 
+                        RBSignal *signal, 
+                        std::size_t n,
+                        const Wait::Deadline &deadline = Wait::Deadline::max() )
+   {
+      std::size_t total( 0 );
+      auto until( deadline );
+      while( n > 0 )
+      {
+         std::uint64_t pos( 0 );
+         const auto count( claim_read( pos, n, until ) );
+         if( count == 0 )
+         {
+            break;
+         }
+         std::size_t read( 0 );
+         for( std::size_t i( 0 ); i < count; i++ )
+         {
+            auto &slot( data->slot( pos + i ) );
+            if( ! slot.skip )
+            {
+               if( items != nullptr )
+               {
+                  items[ read ] = std::move( slot.item );
+               }
+               slot.item.~T();
+               if( signal != nullptr )
+               {
+                  signal[ read ] = slot.signal;
+               }
+               read++;
+            }
+            slot.seq.store( pos + i + data->max_cap, std::memory_order_release );
+         }
+         wake( data->read_pt );
+         read_count.fetch_add( read, std::memory_order_relaxed );
+         n     -= read;
+         total += read;
+         items  = ( items  != nullptr ? items  + read : nullptr );
+         signal = ( signal != nullptr ? signal + read : nullptr );
+         if( total > 0 && deadline != Wait::Deadline::max() )
+         {
+            until = Wait::Deadline::min();
+         }
+      }
+      return( total );
+   }
+
+   /**
+    * release - hands a single claimed slot at pos back to the
+    * producers.
+    */
+   void release( const std::uint64_t pos )
+   {
+      data->slot( pos ).seq.store( pos + data->max_cap, std::memory_order_release );
+      wake( data->read_pt );
+   }
+
+   /**
+    * try_claim - tries to move counter from its current value
+    * over up to n consecutive slots whose sequence number is
+    * position + offset, offset is 0 for producers (free slots)
+    * and 1 for consumers (full slots).
+    * @param   counter - std::atomic< std::uint64_t >&
+    * @param   pos     - std::uint64_t&, first position claimed
+    * @param   n       - const std::size_t
+    * @param   offset  - const std::uint64_t
+    * @param   multi   - const bool, false if only one thread claims
+    * @return  std::size_t, number of slots claimed, zero if none ready
+    */
+   std::size_t try_claim( std::atomic< std::uint64_t > &counter,
+                          std::uint64_t &pos,
+                          const std::size_t n,
+                          const std::uint64_t offset,
+                          const bool multi )
+   {
+      pos = counter.load( std::memory_order_relaxed );
+      while( true )
+      {
+         std::size_t count( 0 );
+         while( count < n &&
+                data->slot( pos + count ).seq.load( std::memory_order_acquire ) ==
+                   pos + count + offset )
+         {
+            count++;
+         }
+         if( count == 0 )
+         {
+            const std::int64_t diff(
+               data->slot( pos ).seq.load( std::memory_order_acquire ) -
+               ( pos + offset ) );
+            if( diff < 0 )
+            {
+               /** not our turn yet, full or empty **/
+               return( 0 );
+            }
+            /** somebody else got here first **/
+            pos = counter.load( std::memory_order_relaxed );
+         }
+         else if( ! multi )
+         {
+            counter.store( pos + count, std::memory_order_relaxed );
+            return( count );
+         }
+         else if( counter.compare_exchange_weak( pos,
+                                                 pos + count,
+                                                 std::memory_order_relaxed ) )
+         {
+            return( count );
+         }
+      }
+   }
+
+   /**
+    * ready - true if the slot at the current value of counter
+    * looks ready, doesn't claim anything.
+    */
+   bool ready( std::atomic< std::uint64_t > &counter,
+               const std::uint64_t offset )
+   {
+      const auto pos( counter.load( std::memory_order_relaxed ) );
+      const std::int64_t diff(
+         data->slot( pos ).seq.load( std::memory_order_acquire ) - ( pos + offset ) );
+      return( diff >= 0 );
+   }
+
+   /**
+    * claim_write - claims between one and n free slots, blocks
+    * according to the wait policy until there is at least one
+    * or the deadline passes.
+    * @return  std::size_t, slots claimed starting at pos, zero
+    *          if the deadline passed
+    */
+   std::size_t claim_write( std::uint64_t &pos, 
+                            const std::size_t n,
+                            const Wait::Deadline &deadline = Wait::Deadline::max() )
+   {
+      const std::size_t wanted( std::max< std::size_t >( n, 1 ) );
+      auto count( try_claim( *data->enqueue_pos, pos, wanted, 0, multi_producer ) );
+      if( count > 0 )
+      {
+         return( count );
+      }
+      write_blocked.store( true, std::memory_order_relaxed );
+      Wait::Backoff backoff( wait_policy, deadline );
+      while( ( count = try_claim( *data->enqueue_pos,
+                                  pos,
+                                  wanted,
+                                  0,
+                                  multi_producer ) ) == 0 )
+      {
+         if( ! backoff.wait( data->read_pt, [&]() -> bool
+               {
+                  return( ready( *data->enqueue_pos, 0 ) );
+               } ) )
+         {
+            break;
+         }
+      }
+      return( count );
+   }
+
+   /**
+    * claim_read - consumer side version of claim_write.
+    * @return  std::size_t, slots claimed starting at pos
+    */
+   std::size_t claim_read( std::uint64_t &pos, 
+                           const std::size_t n,
+                           const Wait::Deadline &deadline = Wait::Deadline::max() )
+   {
+      const std::size_t wanted( std::max< std::size_t >( n, 1 ) );
+      auto count( try_claim( *data->dequeue_pos, pos, wanted, 1, multi_consumer ) );
+      if( count > 0 )
+      {
+         return( count );
+      }
+      read_blocked.store( true, std::memory_order_relaxed );
+      Wait::Backoff backoff( wait_policy, deadline );
+      while( ( count = try_claim( *data->dequeue_pos,
+                                  pos,
+                                  wanted,
+                                  1,
+                                  multi_consumer ) ) == 0 )
+      {
+         if( ! backoff.wait( data->write_pt, [&]() -> bool
+               {
+                  return( ready( *data->dequeue_pos, 1 ) );
+               } ) )
+         {
+            break;
+         }
+      }
+      return( count );
+   }
+
+   /**
+    * wake - wakes anybody parked on ptr, only needed with
+    * the Park strategy, and fires the selector hook for the
+    * other side.
+    */
+   void wake( Pointer *ptr )
+   {
+      if( wait_policy.strategy == Wait::Park )
+      {
+         Pointer::wake( ptr );
+      }
+      /** producers move the write pointer, consumers the read one **/
+      if( ptr == data->write_pt )
+      {
+         (this)->read_hook.fire();
+      }
+      else
+      {
+         (this)->write_hook.fire();
+      }
+   }
+
+   Buffer::Data< T, type, layout > *data;
+   /** shared by all producers / consumers, hence atomic **/
+   std::atomic< std::uint32_t >     read_count;
+   std::atomic< std::uint32_t >     write_count;
+   std::atomic< bool >              read_blocked;
+   std::atomic< bool >              write_blocked;
+   std::atomic< bool >              write_finished;
+   /** what to do when blocked, see waitstrategy.hpp **/
+   Wait::Policy                     wait_policy;
+   /** tags this queue's reservations, see Reservation **/
+   const std::uint64_t              id;
+};
+
+template < class T, Layout::SlotLayout layout >
+   class RingBufferBase< T, Type::MPSC, layout > :
+      public RingBufferMulti< T, Type::MPSC, layout >
+{
+};
+
+template < class T, Layout::SlotLayout layout >
+   class RingBufferBase< T, Type::SPMC, layout > :
+      public RingBufferMulti< T, Type::SPMC, layout >
+{
+};
+
+template < class T, Layout::SlotLayout layout >
+   class RingBufferBase< T, Type::MPMC, layout > :
+      public RingBufferMulti< T, Type::MPMC, layout >
+{
+};
+#endif /* END _RINGBUFFERMULTI_TCC_ */
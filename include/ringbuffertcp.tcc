@@ -0,0 +1,521 @@
+/**
+ * ringbuffertcp.tcc -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 18:30:02 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _RINGBUFFERTCP_TCC_
+#define _RINGBUFFERTCP_TCC_  1
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "tcp.hpp"
+
+/**
+ * TCP - one end of a queue that spans two hosts (or two
+ * processes on one).  Each end keeps an ordinary local ring, the
+ * user pushes into the producer's ring and pops from the
+ * consumer's.  A background thread on the producer end ships
+ * everything in its ring as one frame per writev, up to the
+ * credit it holds, straight out of the ring.  A thread on the
+ * consumer end reads each frame straight into its own ring with
+ * readv, a second one hands slots back as credit once the user
+ * has popped them.  Since the producer never has more in flight
+ * than the consumer has room for, space_avail() on the producer
+ * counts the remote room as well.  Signals go along inside the
+ * frames.
+ *
+ * The consumer listens, the producer connects, either may be
+ * created first (the producer retries for a while).  Both ends
+ * must agree on T and the layout, T must be trivially copyable
+ * and is sent in host byte order.  The wait strategy is always
+ * Park so that the I/O threads sleep while there's nothing to do,
+ * the spin and yield counts from the policy are honored.
+ */
+template < class T,
+           Layout::SlotLayout layout > class RingBuffer< T, Type::TCP, layout > :
+               public RingBufferBase< T, Type::TCP, layout >
+{
+   static_assert( std::is_trivially_copyable< T >::value,
+                  "Type::TCP only carries trivially copyable types" );
+   /** the frames are built from the signal array **/
+   static_assert( layout != Layout::Sparse,
+                  "Type::TCP carries its signals in the frames" );
+   using element_t = typename Buffer::DataBase< T, layout >::element_t;
+
+public:
+   /**
+    * RingBuffer - opens one end of a TCP queue.
+    * @param   nitems    - const std::size_t, capacity of the local ring
+    * @param   host      - const std::string, address to listen on or connect to
+    * @param   port      - const std::uint16_t, consumer may pass 0, see port()
+    * @param   dir       - Direction, which end this is
+    * @param   alignment - const std::size_t, store alignment
+    * @param   policy    - const Wait::Policy&, spin / yield counts
+    */
+   RingBuffer( const std::size_t    nitems,
+               const std::string    host,
+               const std::uint16_t  port,
+               Direction            dir,
+               const std::size_t    alignment = 16,
+               const Wait::Policy  &policy = Wait::Policy() ) :
+      RingBufferBase< T, Type::TCP, layout >(),
+      dir( dir ),
+      listen_fd( -1 ),
+      conn_fd( -1 ),
+      bound_port( port ),
+      stop( false ),
+      done( false ),
+      granted( 0 ),
+      sent( 0 ),
+      credit_have( 0 )
+   {
+      (this)->attach_data( new Buffer::Data< T, Type::TCP, layout >( nitems, alignment ) );
+      set_wait_policy( policy );
+      try
+      {
+         if( dir == Direction::Producer )
+         {
+            const int fd( Net::connect( host, port ) );
+            conn_fd = fd;
+            auto hello( Net::make_hello( layout, sizeof( element_t ), nitems ) );
+            struct iovec out{ &hello, sizeof( hello ) };
+            struct iovec in { &hello, sizeof( hello ) };
+            if( ! Net::send_all( fd, &out, 1 ) || ! Net::recv_all( fd, &in, 1 ) )
+            {
+               throw bad_tcp_connection( "consumer at " + host + ":" +
+                                         std::to_string( port ) +
+                                         " refused this queue" );
+            }
+            Net::check_hello( hello );
+            granted = hello.capacity;
+            io = std::thread( [ this ](){ send_loop(); } );
+         }
+         else
+         {
+            std::uint16_t bound( 0 );
+            listen_fd  = Net::listen( host, port, bound );
+            bound_port = bound;
+            io = std::thread( [ this ](){ receive_loop(); } );
+         }
+      }
+      catch( bad_tcp_connection &ex )
+      {
+         std::cerr << "Failed to open TCP queue: " << ex.what() << ", exiting.\n";
+         exit( EXIT_FAILURE );
+      }
+   }
+
+   /**
+    * ~RingBuffer - the producer end blocks until everything
+    * pushed so far has been sent (or the connection dropped),
+    * the consumer end drops whatever hasn't been popped.
+    */
+   virtual ~RingBuffer()
+   {
+      if( dir == Direction::Producer )
+      {
+         auto flushed( [ & ]() -> bool
+         {
+            return( done.load() ||
+                    Pointer::position( (this)->data->read_pt ) ==
+                    Pointer::position( (this)->data->write_pt ) );
+         } );
+         Wait::Backoff backoff( (this)->wait_policy );
+         while( ! flushed() )
+         {
+            backoff.wait( (this)->data->read_pt, flushed );
+         }
+         stop = true;
+         Pointer::wake( (this)->data->write_pt );
+         io.join();
+         Net::shutdown( conn_fd );
+      }
+      else
+      {
+         stop = true;
+         Net::shutdown( listen_fd );
+         Net::shutdown( conn_fd.load() );
+         Pointer::wake( (this)->data->read_pt );
+         io.join();
+         if( credit_io.joinable() )
+         {
+            credit_io.join();
+         }
+      }
+      Net::close( conn_fd );
+      Net::close( listen_fd );
+      delete( (this)->data );
+   }
+
+   /**
+    * get_signal - asynchronous signals aren't sent over the
+    * connection, use the per element signals.
+    * @return  RBSignal, always NONE
+    */
+   virtual RBSignal get_signal()
+   {
+      return( RBSignal::NONE );
+   }
+
+   /**
+    * send_signal - see get_signal().
+    * @param   signal - const RBSignal reference
+    * @return  bool, always false
+    */
+   virtual bool send_signal( const RBSignal &signal )
+   {
+      return( false );
+   }
+
+   /**
+    * space_avail - on the producer end this is the room in the
+    * local ring plus the credit held for the remote one, i.e.
+    * what can be pushed before a push has to wait on the consumer.
+    * @return  std::size_t
+    */
+   virtual std::size_t space_avail()
+   {
+      const auto local( RingBufferBase< T, Type::TCP, layout >::space_avail() );
+      if( dir == Direction::Consumer )
+      {
+         return( local );
+      }
+      return( local + ( granted.load() - sent.load() ) );
+   }
+
+   /**
+    * set_wait_policy - keeps the spin and yield counts, the
+    * strategy is always Park, see above.
+    * @param   policy - const Wait::Policy&
+    */
+   virtual void set_wait_policy( const Wait::Policy &policy )
+   {
+      RingBufferBase< T, Type::TCP, layout >::set_wait_policy(
+         Wait::Policy( Wait::Park, policy.spin, policy.yield ) );
+   }
+
+   /**
+    * port - port the consumer end is listening on, useful if
+    * it was opened with port 0.
+    * @return  std::uint16_t
+    */
+   std::uint16_t port() const
+   {
+      return( bound_port );
+   }
+
+   struct Data
+   {
+      const std::string    host;
+      std::uint16_t        port;
+      Direction            dir;
+   };
+
+   /**
+    * make_new_fifo - builder function to dynamically
+    * allocate FIFO's at the time of execution.  data
+    * must point to a Data struct with the address.
+    * @param   n_items - std::size_t
+    * @param   align   - memory alignment
+    * @return  FIFO*
+    */
+   static FIFO* make_new_fifo( std::size_t n_items,
+                               std::size_t align,
+                               void *data )
+   {
+      auto *data_ptr( reinterpret_cast< Data* >( data ) );
+      return( new RingBuffer< T, Type::TCP, layout >( n_items,
+                                                      data_ptr->host,
+                                                      data_ptr->port,
+                                                      data_ptr->dir,
+                                                      align ) );
+   }
+
+private:
+   /**
+    * send_loop - producer I/O thread, ships whatever is in the
+    * local ring, as much as the credit allows, one frame and
+    * one writev at a time.
+    */
+   void send_loop()
+   {
+      Buffer::Data< T, Type::TCP, layout > *data( (this)->data );
+      std::vector< Net::SignalEntry > signals;
+      while( drain_credits( false ) )
+      {
+         std::size_t items( 0 );
+         auto ready( [ & ]() -> bool
+         {
+            items = Pointer::avail( data->read_pt, data->write_pt, data->max_cap );
+            return( items > 0 || stop.load() );
+         } );
+         Wait::Backoff backoff( (this)->wait_policy );
+         while( ! ready() )
+         {
+            backoff.wait( data->write_pt, ready );
+         }
+         if( items == 0 )
+         {
+            /** stopped and flushed **/
+            break;
+         }
+         while( granted.load() == sent.load() )
+         {
+            if( ! drain_credits( true ) )
+            {
+               goto END;
+            }
+         }
+         const std::size_t count( std::min< std::size_t >( items, granted.load() - sent.load() ) );
+         const std::size_t index( Pointer::val( data->read_pt ) );
+         const std::size_t first( std::min( count, data->max_cap - index ) );
+         signals.clear();
+         if( layout == Layout::Split )
+         {
+            for( std::size_t i( 0 ); i < count; i++ )
+            {
+               const auto signal( data->read_signal( ( index + i ) % data->max_cap ) );
+               if( signal != RBSignal::NONE )
+               {
+                  signals.push_back( { static_cast< std::uint32_t >( i ),
+                                       static_cast< std::uint32_t >( signal ) } );
+               }
+            }
+         }
+         Net::Frame frame{ Net::Data,
+                           static_cast< std::uint32_t >( count ),
+                           static_cast< std::uint32_t >( signals.size() ),
+                           0 };
+         struct iovec iov[ 4 ] = {
+            { &frame,                     sizeof( frame ) },
+            { &data->store[ index ],      first * sizeof( element_t ) },
+            { &data->store[ 0 ],          ( count - first ) * sizeof( element_t ) },
+            { signals.data(),             signals.size() * sizeof( Net::SignalEntry ) } };
+         if( ! Net::send_all( conn_fd, iov, 4 ) )
+         {
+            break;
+         }
+         sent += count;
+         (this)->publish_read( count );
+      }
+   END:
+      done = true;
+      Pointer::wake( data->read_pt );
+   }
+
+   /**
+    * drain_credits - reads credit frames from the consumer, if
+    * block is true waits for at least one, otherwise only takes
+    * what is already there.
+    * @return  bool, false once the connection is gone
+    */
+   bool drain_credits( const bool block )
+   {
+      while( true )
+      {
+         auto *dst( reinterpret_cast< char* >( &credit ) + credit_have );
+         const std::size_t want( sizeof( credit ) - credit_have );
+         if( block )
+         {
+            struct iovec iov{ dst, want };
+            if( ! Net::recv_all( conn_fd, &iov, 1 ) )
+            {
+               return( false );
+            }
+            credit_have += want;
+         }
+         else
+         {
+            const auto got( Net::recv_some( conn_fd, dst, want ) );
+            if( got < 0 )
+            {
+               return( false );
+            }
+            if( got == 0 )
+            {
+               return( true );
+            }
+            credit_have += got;
+         }
+         if( credit_have == sizeof( credit ) )
+         {
+            credit_have = 0;
+            if( credit.type != Net::Credit )
+            {
+               return( false );
+            }
+            granted += credit.count;
+            if( block )
+            {
+               return( true );
+            }
+         }
+      }
+   }
+
+   /**
+    * receive_loop - consumer I/O thread, accepts the producer and
+    * reads each frame straight into the local ring.
+    */
+   void receive_loop()
+   {
+      Buffer::Data< T, Type::TCP, layout > *data( (this)->data );
+      const int fd( Net::accept( listen_fd ) );
+      if( fd < 0 )
+      {
+         return;
+      }
+      conn_fd = fd;
+      if( stop.load() )
+      {
+         return;
+      }
+      Net::Hello hello;
+      struct iovec in{ &hello, sizeof( hello ) };
+      if( ! Net::recv_all( fd, &in, 1 ) )
+      {
+         return;
+      }
+      try
+      {
+         Net::check_hello( hello );
+         if( hello.element_size != sizeof( element_t ) || hello.layout != layout )
+         {
+            throw bad_tcp_connection( "producer element size (" +
+                                      std::to_string( hello.element_size ) +
+                                      ") or layout doesn't match" );
+         }
+      }
+      catch( bad_tcp_connection &ex )
+      {
+         std::cerr << "Rejected TCP producer: " << ex.what() << "\n";
+         Net::shutdown( fd );
+         return;
+      }
+      hello = Net::make_hello( layout, sizeof( element_t ), data->max_cap );
+      struct iovec out{ &hello, sizeof( hello ) };
+      if( ! Net::send_all( fd, &out, 1 ) )
+      {
+         return;
+      }
+      credit_io = std::thread( [ this ](){ credit_loop(); } );
+
+      std::vector< Net::SignalEntry > signals;
+      while( ! stop.load() )
+      {
+         Net::Frame frame;
+         struct iovec head{ &frame, sizeof( frame ) };
+         if( ! Net::recv_all( fd, &head, 1 ) ||
+             frame.type != Net::Data ||
+             frame.count > data->max_cap )
+         {
+            break;
+         }
+         const std::size_t count( frame.count );
+         /** credit says this never waits **/
+         (this)->wait_space( count, count );
+         const std::size_t index( Pointer::val( data->write_pt ) );
+         const std::size_t first( std::min( count, data->max_cap - index ) );
+         signals.resize( frame.signals );
+         struct iovec iov[ 3 ] = {
+            { &data->store[ index ],      first * sizeof( element_t ) },
+            { &data->store[ 0 ],          ( count - first ) * sizeof( element_t ) },
+            { signals.data(),             signals.size() * sizeof( Net::SignalEntry ) } };
+         if( ! Net::recv_all( fd, iov, 3 ) )
+         {
+            break;
+         }
+         if( layout == Layout::Split )
+         {
+            data->clear_signals( index, first );
+            data->clear_signals( 0, count - first );
+         }
+         for( const auto &entry : signals )
+         {
+            const auto signal( static_cast< RBSignal >( entry.signal ) );
+            data->write_signal( ( index + entry.offset ) % data->max_cap, signal );
+            if( signal == RBSignal::RBEOF )
+            {
+               (this)->write_finished.store( true, std::memory_order_release );
+            }
+         }
+         (this)->publish_write( count );
+         (this)->write_stats.add( count );
+      }
+   }
+
+   /**
+    * credit_loop - consumer side, sleeps until the user pops
+    * something and then hands the freed slots back.  Whatever
+    * was popped while the last credit was being sent goes out
+    * in one frame.
+    */
+   void credit_loop()
+   {
+      Buffer::Data< T, Type::TCP, layout > *data( (this)->data );
+      std::uint64_t credited( Pointer::position( data->read_pt ) );
+      while( true )
+      {
+         std::uint64_t position( credited );
+         auto ready( [ & ]() -> bool
+         {
+            position = Pointer::position( data->read_pt );
+            return( position != credited || stop.load() );
+         } );
+         Wait::Backoff backoff( (this)->wait_policy );
+         while( ! ready() )
+         {
+            backoff.wait( data->read_pt, ready );
+         }
+         if( position == credited )
+         {
+            break;
+         }
+         Net::Frame frame{ Net::Credit,
+                           static_cast< std::uint32_t >( position - credited ),
+                           0,
+                           0 };
+         struct iovec iov{ &frame, sizeof( frame ) };
+         if( ! Net::send_all( conn_fd, &iov, 1 ) )
+         {
+            break;
+         }
+         credited = position;
+      }
+   }
+
+   const Direction               dir;
+   int                           listen_fd;
+   std::atomic< int >            conn_fd;
+   std::uint16_t                 bound_port;
+   std::atomic< bool >           stop;
+   /** producer, set once the send thread has quit **/
+   std::atomic< bool >           done;
+   /** producer, total credit received and items sent **/
+   std::atomic< std::uint64_t >  granted;
+   std::atomic< std::uint64_t >  sent;
+   /** producer, partially received credit frame **/
+   Net::Frame                    credit;
+   std::size_t                   credit_have;
+   std::thread                   io;
+   std::thread                   credit_io;
+};
+#endif /* END _RINGBUFFERTCP_TCC_ */
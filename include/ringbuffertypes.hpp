@@ -1,8 +1,47 @@
 #ifndef __RINGBUFFERTYPES__ 
 #define __RINGBUFFERTYPES__ 1
 namespace Type{
-   enum RingBufferType { Heap, SharedMemory, TCP, Infinite, N};
+   /**
+    * MPSC, SPMC and MPMC are heap buffers that allow more
+    * than one producer and/or consumer thread, see 
+    * ringbuffermulti.tcc.
+    */
+   enum RingBufferType { Heap, 
+                         SharedMemory, 
+                         TCP, 
+                         Infinite, 
+                         MPSC, 
+                         SPMC, 
+                         MPMC, 
+                         N };
 }
    
    enum Direction { Producer, Consumer };
+
+/**
+ * SlotLayout - how each element and its signal are laid out 
+ * in the buffer.
+ * Split       - items and signals in two separate arrays
+ * Interleaved - signal stored right behind each item, one 
+ *               slot touched per push or pop
+ * SignalFree  - no per element signals at all, for queues
+ *               that never signal, pushing one is fatal
+ * Sparse      - only elements that carry a signal get an
+ *               entry in a side queue, the element path 
+ *               writes nothing else (heap queues only)
+ */
+namespace Layout{
+   enum SlotLayout { Split, Interleaved, SignalFree, Sparse };
+
+   /** 
+    * default_for - the layout a queue of type gets unless
+    * asked for another, Sparse where it is supported.  Heap
+    * queues were Split before Sparse existed, name Split to
+    * keep a signal write on every element, see README.
+    */
+   constexpr SlotLayout default_for( const Type::RingBufferType type )
+   {
+      return( type == Type::Heap ? Sparse : Split );
+   }
+}
 #endif
@@ -0,0 +1,191 @@
+/**
+ * shm.hpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 15:41:09 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _SHM_HPP_
+#define _SHM_HPP_  1
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * bad_shm_alloc - thrown when a segment can't be created,
+ * attached or doesn't match what the caller expected.
+ */
+class bad_shm_alloc : public std::runtime_error
+{
+public:
+   bad_shm_alloc( const std::string &message ) : std::runtime_error( message )
+   {
+   }
+};
+
+namespace SHM
+{
+   /** bump whenever the layout of a segment changes **/
+   constexpr std::uint32_t version = 1;
+
+   /** Geometry::layout of a RecordBuffer segment, not a Layout::SlotLayout **/
+   constexpr std::uint32_t record_layout = 0x7265636f;
+
+   /**
+    * State - lifecycle of a segment, kept in the header and
+    * used as a futex word so the consumer can sleep until the
+    * producer has finished setting the segment up.  Each step
+    * is taken with a compare and swap so only one producer
+    * gets to create and only one consumer gets to attach.
+    * Creating sits at the end to keep the older values.
+    */
+   enum State : std::uint32_t { Empty = 0, Ready, Attached, Creating };
+
+   /**
+    * Geometry - where everything sits in a segment, all of the
+    * offsets are from the start of the mapping and cache line
+    * aligned, the store is aligned to at least the requested
+    * alignment.
+    */
+   struct Geometry
+   {
+      std::uint64_t  capacity;
+      std::uint64_t  element_size;
+      std::uint64_t  signal_size;
+      std::uint32_t  layout;
+      std::uint32_t  huge_pages;
+      std::uint64_t  read_offset;
+      std::uint64_t  write_offset;
+      std::uint64_t  signal_offset;
+      std::uint64_t  signal_length;
+      std::uint64_t  store_offset;
+      std::uint64_t  store_length;
+      /** total length of the segment **/
+      std::uint64_t  length;
+   };
+
+   /**
+    * Header - first thing in every segment, the consumer
+    * reads the geometry from here so it doesn't need to know
+    * the capacity ahead of time.
+    */
+   struct Header
+   {
+      std::uint64_t                 magic;
+      std::uint32_t                 version;
+      std::atomic< std::uint32_t >  state;
+      Geometry                      geometry;
+   };
+
+   /**
+    * make_geometry - lays out a segment for capacity elements
+    * of element_size bytes plus a separate signal array if
+    * signal_size is non-zero.
+    * @param   capacity     - const std::size_t, in elements
+    * @param   element_size - const std::size_t, bytes per element
+    * @param   signal_size  - const std::size_t, bytes per signal, 0 for none
+    * @param   layout       - const std::uint32_t, Layout::SlotLayout
+    * @param   alignment    - const std::size_t, store alignment
+    * @param   huge_pages   - const bool, round up to huge pages
+    * @return  Geometry
+    */
+   Geometry make_geometry( const std::size_t   capacity,
+                           const std::size_t   element_size,
+                           const std::size_t   signal_size,
+                           const std::uint32_t layout,
+                           const std::size_t   alignment,
+                           const bool          huge_pages );
+
+   /**
+    * GenKey - writes a key that is unique to this process
+    * into buffer, suitable for handing to both ends of a queue.
+    * @param   buffer - char*
+    * @param   length - const std::size_t, size of buffer
+    */
+   void GenKey( char *buffer, const std::size_t length );
+
+   /**
+    * Segment - a single shm_open mapping holding a complete
+    * queue.  Either end may show up first, the file is created
+    * by whoever gets there first and only the producer sizes
+    * and fills it in.  The consumer sleeps on the header state
+    * until the producer marks it Ready, then maps it and
+    * removes the name so nothing is left behind in /dev/shm.
+    */
+   class Segment
+   {
+   public:
+      Segment( const std::string &key );
+
+      ~Segment();
+
+      /**
+       * create - producer side, maps a segment laid out as per
+       * geometry and fills in the header.  The segment isn't
+       * visible to the consumer until ready() is called.
+       * @param   geometry - const Geometry&
+       * @throws  bad_shm_alloc
+       */
+      void create( const Geometry &geometry );
+
+      /**
+       * ready - producer side, called once the pointers have
+       * been built in the segment, wakes a waiting consumer.
+       */
+      void ready();
+
+      /**
+       * attach - consumer side, blocks until the producer has
+       * called ready() then maps the whole segment.
+       * @throws  bad_shm_alloc
+       */
+      void attach();
+
+      /**
+       * header - returns the header of the mapped segment.
+       * @return  Header&
+       */
+      Header& header();
+
+      /**
+       * at - returns the address of offset within the segment.
+       * @param   offset - const std::uint64_t
+       * @return  void*
+       */
+      void* at( const std::uint64_t offset );
+
+      /**
+       * huge - true if the mapping is backed by huge pages,
+       * either hugetlb or transparent ones.
+       * @return  bool
+       */
+      bool huge() const;
+
+   private:
+      /** opens or creates the file and makes sure it is at least min_length **/
+      int  open_file( const std::size_t min_length );
+      /** maps length bytes of fd, with huge pages if requested **/
+      void map( const int fd, const std::size_t length, const bool huge_pages );
+
+      const std::string name;
+      void             *base;
+      std::size_t       length;
+      bool              producer;
+      bool              huge_mapped;
+   };
+}
+#endif /* END _SHM_HPP_ */
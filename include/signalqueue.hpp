@@ -0,0 +1,408 @@
+/**
+ * signalqueue.hpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:40 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _SIGNALQUEUE_HPP_
+#define _SIGNALQUEUE_HPP_  1
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#if __x86_64
+#include <emmintrin.h>
+#endif
+
+#include "pointer.hpp"
+#include "signalvars.hpp"
+
+namespace Signals
+{
+   /**
+    * find - index of the first of n signals that isn't
+    * RBSignal::NONE, n if they all are.  On x86_64 sixteen are
+    * tested per step with SSE2 so a long run without a signal,
+    * the usual case, costs a few instructions per cache line.
+    * @param   signals - const RBSignal*
+    * @param   n       - const std::size_t
+    * @return  std::size_t
+    */
+   inline std::size_t find( const RBSignal *signals, const std::size_t n )
+   {
+      static_assert( RBSignal::NONE == 0, "find assumes NONE is zero" );
+      std::size_t i( 0 );
+#if __x86_64
+      if( sizeof( RBSignal ) == sizeof( std::int32_t ) )
+      {
+         const auto *v( reinterpret_cast< const __m128i* >( signals ) );
+         const __m128i zero( _mm_setzero_si128() );
+         for( ; i + 16 <= n; i += 16, v += 4 )
+         {
+            const __m128i any( _mm_or_si128( _mm_or_si128( _mm_loadu_si128( v     ),
+                                                           _mm_loadu_si128( v + 1 ) ),
+                                             _mm_or_si128( _mm_loadu_si128( v + 2 ),
+                                                           _mm_loadu_si128( v + 3 ) ) ) );
+            if( _mm_movemask_epi8( _mm_cmpeq_epi32( any, zero ) ) != 0xffff )
+            {
+               break;
+            }
+         }
+         /** narrows a hit down to four, the loop below to one **/
+         for( ; i + 4 <= n; i += 4, v++ )
+         {
+            if( _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_loadu_si128( v ), zero ) ) != 0xffff )
+            {
+               break;
+            }
+         }
+      }
+#endif
+      for( ; i < n; i++ )
+      {
+         if( signals[ i ] != RBSignal::NONE )
+         {
+            return( i );
+         }
+      }
+      return( n );
+   }
+
+   /**
+    * Channel - asynchronous signals, sent with send_signal() and
+    * received with get_signal() outside of the element stream.  A
+    * small bounded queue, each cell carries a sequence number that
+    * says whose turn it is so any number of threads may send and
+    * receive without a lock.  Signals are expected to be rare so
+    * nothing here is padded apart.
+    */
+   template < std::size_t N = 16 > class Channel
+   {
+      static_assert( N > 0 && ( N & ( N - 1 ) ) == 0,
+                     "Channel size must be a power of two" );
+   public:
+      Channel() : tail( 0 ), head( 0 )
+      {
+         for( std::size_t i( 0 ); i < N; i++ )
+         {
+            cells[ i ].seq.store( i, std::memory_order_relaxed );
+            cells[ i ].signal = RBSignal::NONE;
+         }
+      }
+
+      /**
+       * send - queues signal.
+       * @param   signal - const RBSignal
+       * @return  bool, false if the channel is full
+       */
+      bool send( const RBSignal signal )
+      {
+         auto pos( tail.load( std::memory_order_relaxed ) );
+         while( true )
+         {
+            auto &cell( cells[ pos & ( N - 1 ) ] );
+            const auto seq( cell.seq.load( std::memory_order_acquire ) );
+            if( seq == pos )
+            {
+               if( tail.compare_exchange_weak( pos, pos + 1,
+                                               std::memory_order_relaxed ) )
+               {
+                  cell.signal = signal;
+                  cell.seq.store( pos + 1, std::memory_order_release );
+                  return( true );
+               }
+            }
+            else if( seq < pos )
+            {
+               return( false );
+            }
+            else
+            {
+               pos = tail.load( std::memory_order_relaxed );
+            }
+         }
+      }
+
+      /**
+       * receive - takes the oldest signal queued.
+       * @return  RBSignal, NONE if there isn't one
+       */
+      RBSignal receive()
+      {
+         auto pos( head.load( std::memory_order_relaxed ) );
+         while( true )
+         {
+            auto &cell( cells[ pos & ( N - 1 ) ] );
+            const auto seq( cell.seq.load( std::memory_order_acquire ) );
+            if( seq == pos + 1 )
+            {
+               if( head.compare_exchange_weak( pos, pos + 1,
+                                               std::memory_order_relaxed ) )
+               {
+                  const RBSignal signal( cell.signal );
+                  cell.seq.store( pos + N, std::memory_order_release );
+                  return( signal );
+               }
+            }
+            else if( seq < pos + 1 )
+            {
+               return( RBSignal::NONE );
+            }
+            else
+            {
+               pos = head.load( std::memory_order_relaxed );
+            }
+         }
+      }
+
+   private:
+      struct Cell
+      {
+         std::atomic< std::uint64_t >  seq;
+         RBSignal                      signal;
+      };
+
+      std::atomic< std::uint64_t >     tail;
+      std::atomic< std::uint64_t >     head;
+      Cell                             cells[ N ];
+   };
+
+   /**
+    * Sparse - synchronous per element signals for the
+    * Layout::Sparse buffers.  Only elements whose signal isn't
+    * NONE get an entry, ( position, signal ), in position order,
+    * so pushing or popping an element without one writes nothing
+    * extra.  Single producer and single consumer, the producer
+    * adds an entry before it publishes the element and the
+    * consumer drops entries as the elements are read.  There is
+    * never more than one entry per element in the buffer, so cap
+    * entries is always enough.
+    *
+    * The consumer never loads the producer's write pointer, the
+    * write position it last saw (Pointer::remote()) tells it
+    * which entries must already be visible.
+    */
+   class Sparse
+   {
+   public:
+      /**
+       * Sparse -
+       * @param   cap     - const std::size_t, slots in the buffer
+       * @param   storage - void*, storage_bytes( cap ) for the
+       *                    entries if they live elsewhere (e.g.
+       *                    a FIFOArena), default allocates them
+       */
+      Sparse( const std::size_t cap, void *storage = nullptr ) : 
+         entries( storage != nullptr ? reinterpret_cast< Entry* >( storage ) : new Entry[ cap ] ),
+         owned( storage == nullptr ),
+         cap( cap ),
+         tail( 0 ),
+         cached_head( 0 ),
+         head( 0 ),
+         cached_tail( 0 ),
+         covered( 0 )
+      {
+      }
+
+      ~Sparse()
+      {
+         if( owned )
+         {
+            delete[]( entries );
+         }
+      }
+
+      /** bytes of entry storage for a buffer of cap slots **/
+      static std::size_t storage_bytes( const std::size_t cap )
+      {
+         return( sizeof( Entry ) * cap );
+      }
+
+      Sparse( const Sparse& ) = delete;
+      Sparse& operator = ( const Sparse& ) = delete;
+
+      /**
+       * write - producer, signal for the element at pos, must
+       * be called before the element is published and with
+       * pos greater than any before it.
+       * @param   pos    - const std::uint64_t
+       * @param   signal - const RBSignal
+       */
+      void write( const std::uint64_t pos, const RBSignal signal )
+      {
+         if( signal == RBSignal::NONE )
+         {
+            return;
+         }
+         const auto t( tail.load( std::memory_order_relaxed ) );
+         if( t - cached_head == cap )
+         {
+            cached_head = head.load( std::memory_order_acquire );
+         }
+         /**
+          * can't happen while the buffer holds the invariant, the
+          * producer only gets the slot for pos once the consumer
+          * has moved its read pointer past pos - cap, and retire()
+          * drops the entries before that move, so at most cap - 1
+          * entries are queued for the elements still in the buffer.
+          * Only checked here, on the signalled path, where it is
+          * cheap, an overrun would silently corrupt queued signals.
+          */
+         if( t - cached_head >= cap )
+         {
+            std::cerr << "Sparse signal queue overrun at position " << pos << 
+                         ", exiting.\n";
+            exit( EXIT_FAILURE );
+         }
+         entries[ t % cap ] = Entry{ pos, signal };
+         tail.store( t + 1, std::memory_order_release );
+      }
+
+      /**
+       * read - consumer, signal for the element at pos.
+       * @param   pos     - const std::uint64_t
+       * @param   read_pt - Pointer*, owned by the caller
+       * @return  RBSignal
+       */
+      RBSignal read( const std::uint64_t pos, Pointer *read_pt )
+      {
+         refresh( read_pt );
+         for( auto i( head.load( std::memory_order_relaxed ) ); i != cached_tail; i++ )
+         {
+            const auto &entry( entries[ i % cap ] );
+            if( entry.pos >= pos )
+            {
+               return( entry.pos == pos ? entry.signal : RBSignal::NONE );
+            }
+         }
+         return( RBSignal::NONE );
+      }
+
+      /**
+       * copy - consumer, signals for the n elements from pos.
+       * @param   dst     - RBSignal*, n of them
+       * @param   pos     - const std::uint64_t
+       * @param   n       - const std::size_t
+       * @param   read_pt - Pointer*, owned by the caller
+       */
+      void copy( RBSignal *dst,
+                 const std::uint64_t pos,
+                 const std::size_t n,
+                 Pointer *read_pt )
+      {
+         std::fill( dst, dst + n, RBSignal::NONE );
+         refresh( read_pt );
+         for( auto i( head.load( std::memory_order_relaxed ) ); i != cached_tail; i++ )
+         {
+            const auto &entry( entries[ i % cap ] );
+            if( entry.pos >= pos + n )
+            {
+               break;
+            }
+            if( entry.pos >= pos )
+            {
+               dst[ entry.pos - pos ] = entry.signal;
+            }
+         }
+      }
+
+      /**
+       * find - consumer, offset from pos of the first of the n
+       * elements from pos that carries a signal, n if none do.
+       * @param   pos     - const std::uint64_t
+       * @param   n       - const std::size_t
+       * @param   read_pt - Pointer*, owned by the caller
+       * @return  std::size_t
+       */
+      std::size_t find( const std::uint64_t pos,
+                        const std::size_t n,
+                        Pointer *read_pt )
+      {
+         refresh( read_pt );
+         for( auto i( head.load( std::memory_order_relaxed ) ); i != cached_tail; i++ )
+         {
+            const auto &entry( entries[ i % cap ] );
+            if( entry.pos >= pos + n )
+            {
+               break;
+            }
+            if( entry.pos >= pos )
+            {
+               return( entry.pos - pos );
+            }
+         }
+         return( n );
+      }
+
+      /**
+       * retire - consumer, drops the entries of the elements
+       * before pos, called before the read pointer moves to pos.
+       * @param   pos     - const std::uint64_t
+       * @param   read_pt - Pointer*, owned by the caller
+       * @return  bool, true if an RBEOF was among them
+       */
+      bool retire( const std::uint64_t pos, Pointer *read_pt )
+      {
+         refresh( read_pt );
+         const auto start( head.load( std::memory_order_relaxed ) );
+         auto i( start );
+         bool eof( false );
+         while( i != cached_tail && entries[ i % cap ].pos < pos )
+         {
+            eof = ( eof || entries[ i % cap ].signal == RBSignal::RBEOF );
+            i++;
+         }
+         if( i != start )
+         {
+            head.store( i, std::memory_order_release );
+         }
+         return( eof );
+      }
+
+   private:
+      /** picks up entries for everything the consumer can see **/
+      void refresh( Pointer *read_pt )
+      {
+         const auto seen( Pointer::remote( read_pt ) );
+         if( seen != covered )
+         {
+            covered     = seen;
+            cached_tail = tail.load( std::memory_order_acquire );
+         }
+      }
+
+      struct Entry
+      {
+         std::uint64_t  pos;
+         RBSignal       signal;
+      };
+
+      Entry *const                  entries;
+      const bool                    owned;
+      const std::size_t             cap;
+      /** written by the producer **/
+      std::atomic< std::uint64_t >  tail;
+      std::uint64_t                 cached_head;
+      /** written by the consumer **/
+      std::atomic< std::uint64_t >  head;
+      std::uint64_t                 cached_tail;
+      std::uint64_t                 covered;
+   };
+}
+#endif /* END _SIGNALQUEUE_HPP_ */
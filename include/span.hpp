@@ -0,0 +1,193 @@
+/**
+ * span.hpp - 
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 09:12:31 2026
+ * 
+ * Copyright 2014 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _SPAN_HPP_
+#define _SPAN_HPP_  1
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * Span - a view over a run of slots that live directly 
+ * within the ring buffer, nothing is copied or owned.  
+ * Depending on the slot layout the items might not be 
+ * packed back to back, stride is the distance in bytes
+ * between consecutive items.
+ */
+template < class T > struct Span
+{
+   using byte_t = typename std::conditional< std::is_const< T >::value,
+                                             const char,
+                                             char >::type;
+
+   /**
+    * iterator - steps through the span by stride
+    */
+   class iterator
+   {
+   public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = typename std::remove_const< T >::type;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = T*;
+      using reference         = T&;
+
+      iterator( byte_t *pos, const std::size_t stride ) : pos( pos ),
+                                                          stride( stride )
+      {
+      }
+
+      T& operator *() const
+      {
+         return( *reinterpret_cast< T* >( pos ) );
+      }
+
+      T* operator ->() const
+      {
+         return( reinterpret_cast< T* >( pos ) );
+      }
+
+      iterator& operator ++()
+      {
+         pos += stride;
+         return( *this );
+      }
+
+      iterator operator ++( int )
+      {
+         iterator copy( *this );
+         pos += stride;
+         return( copy );
+      }
+
+      bool operator ==( const iterator &other ) const
+      {
+         return( pos == other.pos );
+      }
+
+      bool operator !=( const iterator &other ) const
+      {
+         return( pos != other.pos );
+      }
+
+   private:
+      byte_t      *pos;
+      std::size_t  stride;
+   };
+
+   Span() : ptr( nullptr ),
+            length( 0 ),
+            stride( sizeof( T ) )
+   {
+   }
+
+   Span( T *ptr, 
+         const std::size_t length,
+         const std::size_t stride = sizeof( T ) ) : ptr( ptr ),
+                                                    length( length ),
+                                                    stride( stride )
+   {
+   }
+
+   iterator begin() const
+   {
+      return( iterator( reinterpret_cast< byte_t* >( ptr ), stride ) );
+   }
+
+   iterator end() const
+   {
+      return( iterator( reinterpret_cast< byte_t* >( ptr ) + ( length * stride ), 
+                        stride ) );
+   }
+
+   std::size_t size() const
+   {
+      return( length );
+   }
+
+   /**
+    * contiguous - true if the items are packed, in which 
+    * case ptr can be used as a plain array of length items.
+    * @return  bool
+    */
+   bool contiguous() const
+   {
+      return( stride == sizeof( T ) );
+   }
+
+   T& operator []( const std::size_t index ) const
+   {
+      assert( index < length );
+      return( *reinterpret_cast< T* >( 
+         reinterpret_cast< byte_t* >( ptr ) + ( index * stride ) ) );
+   }
+
+   T           *ptr;
+   std::size_t  length;
+   std::size_t  stride;
+};
+
+/**
+ * SplitRange - a range of slots in the ring buffer which 
+ * might cross the end of the buffer, in which case the 
+ * first span runs to the end of the buffer and the second
+ * starts at the beginning.  If the range doesn't wrap then
+ * second is empty.
+ */
+template < class T > struct SplitRange
+{
+   SplitRange() = default;
+
+   SplitRange( const Span< T > &first, 
+               const Span< T > &second ) : first( first ),
+                                           second( second )
+   {
+   }
+
+   /**
+    * size - total number of slots across both spans
+    * @return  std::size_t
+    */
+   std::size_t size() const
+   {
+      return( first.length + second.length );
+   }
+
+   bool empty() const
+   {
+      return( size() == 0 );
+   }
+
+   /**
+    * operator[] - index across both spans as if they
+    * were a single contiguous run.
+    * @param   index - const std::size_t
+    * @return  T&
+    */
+   T& operator []( const std::size_t index ) const
+   {
+      return( index < first.length ? first[ index ] : 
+                                     second[ index - first.length ] );
+   }
+
+   Span< T >   first;
+   Span< T >   second;
+};
+#endif /* END _SPAN_HPP_ */
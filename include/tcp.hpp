@@ -0,0 +1,166 @@
+/**
+ * tcp.hpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 18:30:02 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _TCP_HPP_
+#define _TCP_HPP_  1
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <sys/uio.h>
+
+/**
+ * bad_tcp_connection - thrown when an endpoint can't be
+ * set up or the other end doesn't match.
+ */
+class bad_tcp_connection : public std::runtime_error
+{
+public:
+   bad_tcp_connection( const std::string &message ) : std::runtime_error( message )
+   {
+   }
+};
+
+/**
+ * Net - socket plumbing for the TCP ring buffer, everything
+ * here is blocking, the I/O threads in RingBuffer< T, Type::TCP >
+ * are the only callers.
+ */
+namespace Net
+{
+   /** bump whenever the wire format changes **/
+   constexpr std::uint32_t version = 1;
+
+   /**
+    * Hello - exchanged once when the producer connects, the
+    * producer sends its element size and layout, the consumer
+    * answers with its capacity which is the initial credit.
+    */
+   struct Hello
+   {
+      std::uint64_t  magic;
+      std::uint32_t  version;
+      std::uint32_t  layout;
+      std::uint64_t  element_size;
+      std::uint64_t  capacity;
+   };
+
+   /**
+    * Frame - precedes every message after the hello.  Data
+    * frames are followed by count elements and then signals
+    * SignalEntry records, Credit frames hand count slots back
+    * to the producer.
+    */
+   enum FrameType : std::uint32_t { Data = 1, Credit };
+
+   struct Frame
+   {
+      std::uint32_t  type;
+      std::uint32_t  count;
+      std::uint32_t  signals;
+      std::uint32_t  reserved;
+   };
+
+   /** a non-NONE signal at offset within a data frame **/
+   struct SignalEntry
+   {
+      std::uint32_t  offset;
+      std::uint32_t  signal;
+   };
+
+   /**
+    * make_hello - fills in a hello with the magic and version.
+    * @param   layout       - const std::uint32_t
+    * @param   element_size - const std::uint64_t
+    * @param   capacity     - const std::uint64_t
+    * @return  Hello
+    */
+   Hello make_hello( const std::uint32_t layout,
+                     const std::uint64_t element_size,
+                     const std::uint64_t capacity );
+
+   /**
+    * check_hello - throws if hello wasn't made by make_hello
+    * with the same wire version.
+    * @throws  bad_tcp_connection
+    */
+   void check_hello( const Hello &hello );
+
+   /**
+    * listen - binds and listens on host:port, port 0 picks a
+    * free one.
+    * @param   host  - const std::string&
+    * @param   port  - const std::uint16_t
+    * @param   bound - std::uint16_t&, port actually bound
+    * @return  int, listening socket
+    * @throws  bad_tcp_connection
+    */
+   int listen( const std::string &host,
+               const std::uint16_t port,
+               std::uint16_t &bound );
+
+   /**
+    * accept - waits for a single connection on fd.
+    * @return  int, connected socket or -1 if fd was shut down
+    */
+   int accept( const int fd );
+
+   /**
+    * connect - connects to host:port, retrying while nothing
+    * is listening yet for up to timeout_ms milliseconds.
+    * @return  int, connected socket
+    * @throws  bad_tcp_connection
+    */
+   int connect( const std::string &host,
+                const std::uint16_t port,
+                const std::uint32_t timeout_ms = 10000 );
+
+   /**
+    * send_all - writes every byte described by iov, one writev
+    * in the common case.  iov is modified.
+    * @return  bool, false if the connection is gone
+    */
+   bool send_all( const int fd, struct iovec *iov, int count );
+
+   /**
+    * recv_all - reads exactly the bytes described by iov,
+    * iov is modified.
+    * @return  bool, false if the connection is gone
+    */
+   bool recv_all( const int fd, struct iovec *iov, int count );
+
+   /**
+    * recv_some - reads whatever is already there into buffer
+    * without blocking, up to length bytes.
+    * @return  long, bytes read, 0 if none, -1 if the connection is gone
+    */
+   long recv_some( const int fd, void *buffer, const std::size_t length );
+
+   /**
+    * shutdown - shuts down both directions of fd, wakes any
+    * thread blocked in accept or recv on it.
+    */
+   void shutdown( const int fd );
+
+   /**
+    * close - closes fd, ignores -1.
+    */
+   void close( const int fd );
+}
+#endif /* END _TCP_HPP_ */
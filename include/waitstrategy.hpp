@@ -0,0 +1,169 @@
+/**
+ * waitstrategy.hpp - 
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 11:20:47 2026
+ * 
+ * Copyright 2014 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _WAITSTRATEGY_HPP_
+#define _WAITSTRATEGY_HPP_  1
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "pointer.hpp"
+
+namespace Wait
+{
+   /**
+    * Strategy - what a producer does when the queue is full
+    * and a consumer does when it is empty.
+    * Spin  - pause in a tight loop, lowest latency, burns a core
+    * Yield - spin for a bounded number of iterations then 
+    *         yield the processor each time around
+    * Park  - spin, then yield, then sleep on a futex until the
+    *         other side moves its pointer.  The other side only
+    *         issues a wake if somebody is actually parked.
+    */
+   enum Strategy { Spin, Yield, Park };
+
+   /**
+    * Deadline - when a timed call (try_push_until() etc.) gives
+    * up.  Deadline::max() waits as long as it takes, 
+    * Deadline::min() doesn't wait at all.
+    */
+   typedef std::chrono::steady_clock::time_point Deadline;
+
+   /**
+    * Policy - runtime wait configuration for a queue, both ends
+    * of a queue must use the same strategy (for SHM that means
+    * both processes must pass the same one).
+    */
+   struct Policy
+   {
+      Policy( const Strategy strategy = Yield,
+              const std::uint32_t spin  = 64,
+              const std::uint32_t yield = 16 ) : strategy( strategy ),
+                                                 spin( spin ),
+                                                 yield( yield )
+      {
+      }
+
+      Strategy       strategy;
+      /** iterations to pause before yielding **/
+      std::uint32_t  spin;
+      /** yields before parking, only used by Park **/
+      std::uint32_t  yield;
+   };
+
+   /**
+    * pause - spin loop hint
+    */
+   inline void pause()
+   {
+#if __x86_64
+      __asm__ volatile("\
+        pause"
+        :
+        :
+        : );
+#endif
+   }
+
+   /**
+    * Backoff - wait state for a single blocking call, wait()
+    * is called each time around the loop and escalates from
+    * pause to yield to park according to the policy.  With a
+    * deadline wait() returns false once it has passed.
+    */
+   class Backoff
+   {
+   public:
+      Backoff( const Policy &policy, 
+               const Deadline &deadline = Deadline::max() ) : policy( policy ),
+                                                              deadline( deadline ),
+                                                              iteration( 0 )
+      {
+      }
+
+      /**
+       * wait - waits a bit, how long depends on the policy
+       * and how many times we've been called.
+       * @param   remote - Pointer*, the pointer we need to move
+       * @param   ready  - F, re-checked before parking
+       * @return  bool, false if the deadline passed, nothing
+       *          was waited for
+       */
+      template < class F > bool wait( Pointer *remote, F &&ready )
+      {
+         auto timeout( std::chrono::nanoseconds::max() );
+         if( deadline != Deadline::max() )
+         {
+            const auto now( std::chrono::steady_clock::now() );
+            if( now >= deadline )
+            {
+               return( false );
+            }
+            timeout = std::chrono::duration_cast< std::chrono::nanoseconds >( deadline - now );
+         }
+         switch( policy.strategy )
+         {
+            case( Spin ):
+            {
+               pause();
+            }
+            break;
+            case( Yield ):
+            {
+               if( iteration < policy.spin )
+               {
+                  iteration++;
+                  pause();
+               }
+               else
+               {
+                  std::this_thread::yield();
+               }
+            }
+            break;
+            case( Park ):
+            {
+               if( iteration < policy.spin )
+               {
+                  iteration++;
+                  pause();
+               }
+               else if( iteration < policy.spin + policy.yield )
+               {
+                  iteration++;
+                  std::this_thread::yield();
+               }
+               else
+               {
+                  Pointer::park( remote, ready, timeout );
+               }
+            }
+            break;
+         }
+         return( true );
+      }
+
+   private:
+      const Policy   &policy;
+      const Deadline  deadline;
+      std::uint32_t   iteration;
+   };
+}
+#endif /* END _WAITSTRATEGY_HPP_ */
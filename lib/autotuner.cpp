@@ -0,0 +1,133 @@
+/**
+ * autotuner.cpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 20:12:44 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "autotuner.hpp"
+
+#include <algorithm>
+
+AutoTuner::AutoTuner( const Policy &policy ) : policy( policy ),
+                                               running( false )
+{
+}
+
+AutoTuner::~AutoTuner()
+{
+   stop();
+}
+
+void
+AutoTuner::add( FIFO *fifo )
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   entries.push_back( Entry{ fifo, 0 } );
+}
+
+void
+AutoTuner::remove( FIFO *fifo )
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                  [&]( const Entry &entry ){ return( entry.fifo == fifo ); } ),
+                  entries.end() );
+}
+
+void
+AutoTuner::tune()
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   for( auto &entry : entries )
+   {
+      tune( entry );
+   }
+}
+
+void
+AutoTuner::tune( Entry &entry )
+{
+   Blocked stats;
+   entry.fifo->get_zero_write_stats( stats );
+   const std::size_t cap( entry.fifo->capacity() );
+   if( stats.blocked != 0 )
+   {
+      /** writer had to wait, give it more room **/
+      entry.idle = 0;
+      const std::size_t grown( std::min( cap * 2, policy.max_cap ) );
+      if( grown > cap )
+      {
+         entry.fifo->resize( grown );
+      }
+      return;
+   }
+   if( stats.count >= cap / 4 )
+   {
+      entry.idle = 0;
+      return;
+   }
+   if( ++entry.idle < policy.idle_periods )
+   {
+      return;
+   }
+   entry.idle = 0;
+   const std::size_t shrunk( std::max( cap / 2, policy.min_cap ) );
+   if( shrunk < cap )
+   {
+      entry.fifo->resize( shrunk );
+   }
+}
+
+void
+AutoTuner::start()
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   if( running )
+   {
+      return;
+   }
+   running = true;
+   thread  = std::thread( [this]()
+   {
+      std::unique_lock< std::mutex > lock( mutex );
+      while( running )
+      {
+         cond.wait_for( lock, policy.period );
+         if( running )
+         {
+            for( auto &entry : entries )
+            {
+               tune( entry );
+            }
+         }
+      }
+   } );
+}
+
+void
+AutoTuner::stop()
+{
+   {
+      std::lock_guard< std::mutex > lock( mutex );
+      if( ! running )
+      {
+         return;
+      }
+      running = false;
+   }
+   cond.notify_all();
+   thread.join();
+}
@@ -37,3 +37,68 @@ FIFO::get_zero_write_stats( Blocked &copy )
    /** default version does nothing at all **/
    return;
 }
+
+void
+FIFO::set_wait_policy( const Wait::Policy &policy )
+{
+   /** default version does nothing at all **/
+   return;
+}
+
+bool
+FIFO::resize( const std::size_t new_cap )
+{
+   /** default version can't resize **/
+   return( false );
+}
+
+void
+FIFO::set_label( const std::string &label )
+{
+   /** default version does nothing at all **/
+   return;
+}
+
+bool
+FIFO::readable()
+{
+   return( size() > 0 );
+}
+
+bool
+FIFO::writable()
+{
+   return( space_avail() > 0 );
+}
+
+bool
+FIFO::notifies() const
+{
+   return( true );
+}
+
+void
+FIFO::watch_read( Select::Notifier *notifier )
+{
+   if( notifier == nullptr )
+   {
+      read_hook.detach();
+   }
+   else
+   {
+      read_hook.attach( notifier );
+   }
+}
+
+void
+FIFO::watch_write( Select::Notifier *notifier )
+{
+   if( notifier == nullptr )
+   {
+      write_hook.detach();
+   }
+   else
+   {
+      write_hook.attach( notifier );
+   }
+}
@@ -0,0 +1,162 @@
+/**
+ * fifoarena.cpp -
+ * @author: Jonathan Beard
+ * @version: Mon Oct 19 13:37:02 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fifoarena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/** huge pages are 2MiB on the platforms we care about **/
+static const std::size_t huge_page( 1 << 21 );
+
+FIFOArena::FIFOArena( const std::size_t bytes, const bool huge_pages ) : region( nullptr ),
+                                                                         length( bytes ),
+                                                                         offset( 0 ),
+                                                                         huge_backed( false ),
+                                                                         file_backed( false ),
+                                                                         head( nullptr ),
+                                                                         count( 0 )
+{
+   assert( bytes > 0 );
+   void *mem( MAP_FAILED );
+#ifdef MAP_HUGETLB
+   if( huge_pages )
+   {
+      const std::size_t rounded( ( ( bytes + huge_page - 1 ) / huge_page ) * huge_page );
+      mem = mmap( nullptr,
+                  rounded,
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                  -1,
+                  0 );
+      if( mem != MAP_FAILED )
+      {
+         length      = rounded;
+         huge_backed = true;
+      }
+   }
+#endif
+   if( mem == MAP_FAILED )
+   {
+      /** none reserved, plain pages and a hint **/
+      mem = mmap( nullptr,
+                  length,
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS,
+                  -1,
+                  0 );
+      if( mem == MAP_FAILED )
+      {
+         perror( "Failed to map FIFO arena" );
+         exit( EXIT_FAILURE );
+      }
+#ifdef MADV_HUGEPAGE
+      if( huge_pages )
+      {
+         madvise( mem, length, MADV_HUGEPAGE );
+      }
+#endif
+   }
+   region = reinterpret_cast< char* >( mem );
+}
+
+FIFOArena::FIFOArena( const std::size_t bytes, const std::string &directory ) : region( nullptr ),
+                                                                                length( bytes ),
+                                                                                offset( 0 ),
+                                                                                huge_backed( false ),
+                                                                                file_backed( true ),
+                                                                                head( nullptr ),
+                                                                                count( 0 )
+{
+   assert( bytes > 0 );
+   const std::string name( directory + "/fifospill.XXXXXX" );
+   std::vector< char > path( name.begin(), name.end() );
+   path.push_back( '\0' );
+   const int fd( mkstemp( path.data() ) );
+   if( fd == -1 )
+   {
+      perror( "Failed to create FIFO spill file" );
+      exit( EXIT_FAILURE );
+   }
+   /** nothing else can open it, the blocks go with the mapping **/
+   unlink( path.data() );
+   if( ftruncate( fd, static_cast< off_t >( length ) ) != 0 )
+   {
+      perror( "Failed to size FIFO spill file" );
+      exit( EXIT_FAILURE );
+   }
+   void *mem( mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) );
+   close( fd );
+   if( mem == MAP_FAILED )
+   {
+      perror( "Failed to map FIFO spill file" );
+      exit( EXIT_FAILURE );
+   }
+   region = reinterpret_cast< char* >( mem );
+}
+
+FIFOArena::~FIFOArena()
+{
+   clear();
+   munmap( region, length );
+}
+
+void*
+FIFOArena::allocate( const std::size_t bytes, const std::size_t align )
+{
+   assert( align != 0 && ( align & ( align - 1 ) ) == 0 );
+   const auto base( reinterpret_cast< std::uintptr_t >( region ) );
+   const std::size_t start( ( ( base + offset + align - 1 ) & ~( align - 1 ) ) - base );
+   if( start + bytes > length )
+   {
+      std::cerr << "FIFO arena of " << length << " bytes is full, asked for "
+                << bytes << " more with " << offset << " used, exiting.\n";
+      exit( EXIT_FAILURE );
+   }
+   /** next allocation starts on a fresh line **/
+   offset = round( start + bytes );
+   return( region + start );
+}
+
+void
+FIFOArena::clear()
+{
+   while( head != nullptr )
+   {
+      Entry *entry( head );
+      head = entry->next;
+      entry->fifo->~FIFO();
+   }
+#ifdef MADV_REMOVE
+   if( file_backed && offset > 0 )
+   {
+      /** frees the blocks, nothing left in them is read again **/
+      madvise( region, length, MADV_REMOVE );
+   }
+#endif
+   count  = 0;
+   offset = 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * fifoselector.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 14:05:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fifoselector.hpp"
+
+#include <algorithm>
+
+FIFOSelector::FIFOSelector( const std::chrono::microseconds poll ) : poll( poll ),
+                                                                     polled( 0 )
+{
+}
+
+FIFOSelector::~FIFOSelector()
+{
+   while( ! entries.empty() )
+   {
+      remove( entries.back().fifo );
+   }
+}
+
+void
+FIFOSelector::add( FIFO *fifo, const std::uint32_t interest )
+{
+   remove( fifo );
+   entries.push_back( Entry{ fifo, interest } );
+   if( ! fifo->notifies() )
+   {
+      polled++;
+   }
+   if( ( interest & Read ) != 0 )
+   {
+      fifo->watch_read( &notifier );
+   }
+   if( ( interest & Write ) != 0 )
+   {
+      fifo->watch_write( &notifier );
+   }
+}
+
+void
+FIFOSelector::remove( FIFO *fifo )
+{
+   auto it( std::find_if( entries.begin(), entries.end(),
+                          [&]( const Entry &entry ){ return( entry.fifo == fifo ); } ) );
+   if( it == entries.end() )
+   {
+      return;
+   }
+   if( ( it->interest & Read ) != 0 )
+   {
+      fifo->watch_read( nullptr );
+   }
+   if( ( it->interest & Write ) != 0 )
+   {
+      fifo->watch_write( nullptr );
+   }
+   if( ! fifo->notifies() )
+   {
+      polled--;
+   }
+   entries.erase( it );
+}
+
+std::size_t
+FIFOSelector::select( std::vector< Event > &events, const Wait::Deadline &deadline )
+{
+   events.clear();
+   while( true )
+   {
+      notifier.drain();
+      scan( events );
+      if( ! events.empty() )
+      {
+         break;
+      }
+      /** anything published from here on fires the notifier **/
+      const auto seen( notifier.arm() );
+      scan( events );
+      if( ! events.empty() )
+      {
+         break;
+      }
+      auto timeout( std::chrono::nanoseconds::max() );
+      if( deadline != Wait::Deadline::max() )
+      {
+         const auto now( std::chrono::steady_clock::now() );
+         if( now >= deadline )
+         {
+            break;
+         }
+         timeout = std::chrono::duration_cast< std::chrono::nanoseconds >( deadline - now );
+      }
+      if( polled > 0 )
+      {
+         timeout = std::min< std::chrono::nanoseconds >( timeout, poll );
+      }
+      notifier.wait( seen, timeout );
+   }
+   return( events.size() );
+}
+
+int
+FIFOSelector::fd() const
+{
+   return( notifier.fd() );
+}
+
+void
+FIFOSelector::scan( std::vector< Event > &events )
+{
+   for( const auto &entry : entries )
+   {
+      std::uint32_t ready( 0 );
+      if( ( entry.interest & Read ) != 0 && entry.fifo->readable() )
+      {
+         ready |= Read;
+      }
+      if( ( entry.interest & Write ) != 0 && entry.fifo->writable() )
+      {
+         ready |= Write;
+      }
+      if( ready != 0 )
+      {
+         events.push_back( Event{ entry.fifo, ready } );
+      }
+   }
+}
@@ -0,0 +1,95 @@
+/**
+ * futex.cpp - 
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 11:20:47 2026
+ * 
+ * Copyright 2014 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "futex.hpp"
+#include <thread>
+#include <climits>
+
+#if __linux__
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static_assert( sizeof( std::atomic< std::uint32_t > ) == sizeof( std::uint32_t ),
+               "futex word must be a plain 32-bit int" );
+
+void
+Futex::wait( std::atomic< std::uint32_t > *addr, const std::uint32_t expected )
+{
+#if __linux__
+   /** EINTR, EAGAIN are both fine, caller re-checks **/
+   syscall( SYS_futex, 
+            reinterpret_cast< std::uint32_t* >( addr ), 
+            FUTEX_WAIT, 
+            expected, 
+            nullptr, 
+            nullptr, 
+            0 );
+#else
+   (void) addr;
+   (void) expected;
+   std::this_thread::yield();
+#endif
+}
+
+void
+Futex::wait_for( std::atomic< std::uint32_t > *addr, 
+                 const std::uint32_t expected,
+                 const std::chrono::nanoseconds timeout )
+{
+   if( timeout.count() <= 0 )
+   {
+      return;
+   }
+#if __linux__
+   /** relative for FUTEX_WAIT, ETIMEDOUT is fine as well **/
+   struct timespec ts;
+   ts.tv_sec  = timeout.count() / 1000000000;
+   ts.tv_nsec = timeout.count() % 1000000000;
+   syscall( SYS_futex, 
+            reinterpret_cast< std::uint32_t* >( addr ), 
+            FUTEX_WAIT, 
+            expected, 
+            &ts, 
+            nullptr, 
+            0 );
+#else
+   (void) addr;
+   (void) expected;
+   std::this_thread::yield();
+#endif
+}
+
+void
+Futex::wake( std::atomic< std::uint32_t > *addr )
+{
+#if __linux__
+   syscall( SYS_futex, 
+            reinterpret_cast< std::uint32_t* >( addr ), 
+            FUTEX_WAKE, 
+            INT_MAX, 
+            nullptr, 
+            nullptr, 
+            0 );
+#else
+   (void) addr;
+#endif
+}
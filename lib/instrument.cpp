@@ -0,0 +1,187 @@
+/**
+ * instrument.cpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 21:03:17 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "instrument.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+Stats::Counters*
+Stats::Counters::create()
+{
+   void *mem( nullptr );
+   const int ret_val( posix_memalign( &mem,
+                                      alignof( Counters ),
+                                      sizeof( Counters ) ) );
+   if( ret_val != 0 )
+   {
+      std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+      std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+      exit( EXIT_FAILURE );
+   }
+   return( new ( mem ) Counters() );
+}
+
+void
+Stats::Counters::destroy( Counters *counters )
+{
+   if( counters == nullptr )
+   {
+      return;
+   }
+   counters->~Counters();
+   free( counters );
+}
+
+Stats::Registry::Registry() : next_id( 0 )
+{
+}
+
+Stats::Registry&
+Stats::Registry::instance()
+{
+   static Registry registry;
+   return( registry );
+}
+
+std::uint64_t
+Stats::Registry::add( const Counters *counters )
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   const auto id( next_id++ );
+   entries.push_back( Entry{ id, counters, "fifo" + std::to_string( id ) } );
+   return( id );
+}
+
+void
+Stats::Registry::remove( const Counters *counters )
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                  [&]( const Entry &entry ){ return( entry.counters == counters ); } ),
+                  entries.end() );
+}
+
+void
+Stats::Registry::label( const Counters *counters, const std::string &label )
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   for( auto &entry : entries )
+   {
+      if( entry.counters == counters )
+      {
+         entry.label = label;
+      }
+   }
+}
+
+static void
+copy_histogram( std::array< std::uint64_t, Stats::bins > &dst,
+                const Stats::Histogram &src )
+{
+   for( std::size_t i( 0 ); i < Stats::bins; i++ )
+   {
+      dst[ i ] = src.bin[ i ].load( std::memory_order_relaxed );
+   }
+}
+
+static void
+copy_side( Stats::Snapshot::Side &dst, const Stats::Side &src )
+{
+   dst.items          = src.items.load( std::memory_order_relaxed );
+   dst.blocked_cycles = src.blocked_cycles.load( std::memory_order_relaxed );
+   dst.episodes       = src.episodes.load( std::memory_order_relaxed );
+   copy_histogram( dst.episode_cycles, src.episode_cycles );
+}
+
+std::vector< Stats::Snapshot >
+Stats::Registry::snapshot()
+{
+   std::lock_guard< std::mutex > lock( mutex );
+   std::vector< Snapshot > out( entries.size() );
+   for( std::size_t i( 0 ); i < entries.size(); i++ )
+   {
+      const auto &entry( entries[ i ] );
+      auto       &snap ( out[ i ] );
+      snap.id       = entry.id;
+      snap.label    = entry.label;
+      snap.capacity = entry.counters->capacity.load( std::memory_order_relaxed );
+      copy_side( snap.write, entry.counters->write );
+      copy_side( snap.read,  entry.counters->read  );
+      copy_histogram( snap.occupancy, entry.counters->occupancy );
+   }
+   return( out );
+}
+
+/** prints the non-empty bins as [ low, high ): count **/
+static void
+print_histogram( std::ostream &stream,
+                 const std::array< std::uint64_t, Stats::bins > &histogram )
+{
+   for( std::size_t i( 0 ); i < Stats::bins; i++ )
+   {
+      if( histogram[ i ] == 0 )
+      {
+         continue;
+      }
+      const std::uint64_t low ( i == 0 ? 0 : 1ULL << ( i - 1 ) );
+      stream << " [" << low << ",";
+      if( i < 64 )
+      {
+         stream << ( 1ULL << i );
+      }
+      else
+      {
+         stream << "inf";
+      }
+      stream << "):" << histogram[ i ];
+   }
+}
+
+static void
+print_side( std::ostream &stream,
+            const char *name,
+            const Stats::Snapshot::Side &side )
+{
+   stream << "  " << name << " items=" << side.items
+          << " blocked_cycles=" << side.blocked_cycles
+          << " episodes=" << side.episodes << "\n";
+   if( side.episodes > 0 )
+   {
+      stream << "  " << name << " episode cycles:";
+      print_histogram( stream, side.episode_cycles );
+      stream << "\n";
+   }
+}
+
+std::ostream&
+Stats::operator << ( std::ostream &stream, const Snapshot &snapshot )
+{
+   stream << snapshot.label << " (" << snapshot.id << ") capacity="
+          << snapshot.capacity << "\n";
+   print_side( stream, "write", snapshot.write );
+   print_side( stream, "read ", snapshot.read );
+   stream << "  occupancy:";
+   print_histogram( stream, snapshot.occupancy );
+   stream << "\n";
+   return( stream );
+}
@@ -0,0 +1,88 @@
+/**
+ * notifier.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 14:05:31 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "notifier.hpp"
+#include "futex.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+#if __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+Select::Notifier::Notifier() : armed( 0 ),
+                               epoch( 0 ),
+                               event_fd( -1 )
+{
+#if __linux__
+   event_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+   if( event_fd < 0 )
+   {
+      std::cerr << "Failed to create eventfd, exiting: " << std::strerror( errno ) << "\n";
+      exit( EXIT_FAILURE );
+   }
+#endif
+}
+
+Select::Notifier::~Notifier()
+{
+#if __linux__
+   if( event_fd >= 0 )
+   {
+      close( event_fd );
+   }
+#endif
+}
+
+void
+Select::Notifier::wait( const std::uint32_t seen, const std::chrono::nanoseconds timeout )
+{
+   if( timeout == std::chrono::nanoseconds::max() )
+   {
+      Futex::wait( &epoch, seen );
+   }
+   else
+   {
+      Futex::wait_for( &epoch, seen, timeout );
+   }
+}
+
+void
+Select::Notifier::drain()
+{
+#if __linux__
+   eventfd_t value( 0 );
+   /** EAGAIN if it wasn't set, that's fine **/
+   (void) eventfd_read( event_fd, &value );
+#endif
+}
+
+void
+Select::Notifier::wake()
+{
+   epoch.fetch_add( 1, std::memory_order_relaxed );
+   Futex::wake( &epoch );
+#if __linux__
+   (void) eventfd_write( event_fd, 1 );
+#endif
+}
@@ -0,0 +1,200 @@
+/**
+ * placement.cpp -
+ * @author: Jonathan Beard
+ * @version: Mon Oct 19 09:12:44 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "placement.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#if __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+   /**
+    * cpus_of - CPUs listed for node in sysfs, "0-3,8-11"
+    * style, empty if there is no such node.
+    */
+   std::vector< int > cpus_of( const int node )
+   {
+      std::vector< int > cpus;
+      std::ifstream in( "/sys/devices/system/node/node" + std::to_string( node ) + "/cpulist" );
+      std::string list;
+      if( ! std::getline( in, list ) )
+      {
+         return( cpus );
+      }
+      std::stringstream ss( list );
+      std::string range;
+      while( std::getline( ss, range, ',' ) )
+      {
+         int first( 0 ), last( 0 );
+         const int found( std::sscanf( range.c_str(), "%d-%d", &first, &last ) );
+         if( found < 1 )
+         {
+            continue;
+         }
+         if( found == 1 )
+         {
+            last = first;
+         }
+         for( int cpu( first ); cpu <= last; cpu++ )
+         {
+            cpus.push_back( cpu );
+         }
+      }
+      return( cpus );
+   }
+}
+
+Placement::Options
+Placement::Options::resolved() const
+{
+   auto node( [&]( const int n )
+   {
+      return( n == Local ? current_node() : n );
+   } );
+   Options out( node( store ), node( read ), node( write ), prefault );
+   if( store == Consumer )
+   {
+      out.store = out.read;
+   }
+   return( out );
+}
+
+int
+Placement::nodes()
+{
+   int count( 0 );
+   while( std::ifstream( "/sys/devices/system/node/node" +
+                         std::to_string( count ) + "/cpulist" ).good() )
+   {
+      count++;
+   }
+   return( count > 0 ? count : 1 );
+}
+
+int
+Placement::current_node()
+{
+#if __linux__ && defined( SYS_getcpu )
+   unsigned cpu( 0 ), node( 0 );
+   if( syscall( SYS_getcpu, &cpu, &node, nullptr ) == 0 )
+   {
+      return( static_cast< int >( node ) );
+   }
+#endif
+   return( 0 );
+}
+
+std::size_t
+Placement::page_size()
+{
+   const long size( sysconf( _SC_PAGESIZE ) );
+   return( size > 0 ? static_cast< std::size_t >( size ) : 4096 );
+}
+
+bool
+Placement::bind( void *ptr, const std::size_t length, const int node )
+{
+   if( node < 0 || length == 0 )
+   {
+      return( false );
+   }
+#if __linux__ && defined( SYS_mbind )
+   const std::size_t bits( 8 * sizeof( unsigned long ) );
+   std::vector< unsigned long > mask( node / bits + 1, 0 );
+   mask[ node / bits ] |= 1UL << ( node % bits );
+   /** maxnode counts one past the last bit the kernel looks at **/
+   return( syscall( SYS_mbind,
+                    ptr,
+                    length,
+                    MPOL_PREFERRED,
+                    mask.data(),
+                    mask.size() * bits + 1,
+                    0 ) == 0 );
+#else
+   (void) ptr;
+   return( false );
+#endif
+}
+
+void
+Placement::prefault( void *ptr, const std::size_t length )
+{
+   volatile char *bytes( reinterpret_cast< volatile char* >( ptr ) );
+   const auto page( page_size() );
+   for( std::size_t offset( 0 ); offset < length; offset += page )
+   {
+      bytes[ offset ] = 0;
+   }
+   if( length > 0 )
+   {
+      bytes[ length - 1 ] = 0;
+   }
+}
+
+bool
+Placement::pin( const int node )
+{
+#if __linux__
+   const auto cpus( cpus_of( node ) );
+   if( cpus.empty() )
+   {
+      return( false );
+   }
+   cpu_set_t set;
+   CPU_ZERO( &set );
+   for( const auto cpu : cpus )
+   {
+      CPU_SET( cpu, &set );
+   }
+   return( pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0 );
+#else
+   (void) node;
+   return( false );
+#endif
+}
+
+bool
+Placement::pin_cpu( const int cpu )
+{
+#if __linux__
+   if( cpu < 0 || cpu >= CPU_SETSIZE )
+   {
+      return( false );
+   }
+   cpu_set_t set;
+   CPU_ZERO( &set );
+   CPU_SET( cpu, &set );
+   return( pthread_setaffinity_np( pthread_self(), sizeof( set ), &set ) == 0 );
+#else
+   (void) cpu;
+   return( false );
+#endif
+}
@@ -18,66 +18,11 @@
  * limitations under the License.
  */
 #include "pointer.hpp"
-#include <thread>
 
-Pointer::Pointer(const size_t cap ) : a( 0 ),
-                                      b( 0 ),
-                                      wrap_a( 0 ),
-                                      wrap_b( 0 ),
-                                      max_cap( cap )
+Pointer::Pointer( const size_t cap ) : pos( 0 ),
+                                       max_cap( cap ),
+                                       waiters( 0 ),
+                                       epoch( 0 ),
+                                       cached_remote( 0 )
 {
 }
-
-size_t 
-Pointer::val( Pointer *ptr )
-{
-   struct{
-      size_t a;
-      size_t b;
-   }copy;
-   do{
-      copy.a = ptr->a;
-      copy.b = ptr->b;
-   }while( copy.a ^ copy.b );
-   return( copy.b );
-}
-
-size_t 
-Pointer::inc( Pointer *ptr )
-{
-   ptr->a = ( ptr->a + 1 ) % ptr->max_cap;
-   ptr->b = ( ptr->b + 1 ) % ptr->max_cap;
-   if( ptr->b == 0 )
-   {
-      ptr->wrap_a++;
-      ptr->wrap_b++;
-   }
-   return( ptr->b );
-}
-
-size_t 
-Pointer::incBy( const size_t in, Pointer *ptr )
-{
-   ptr->a = ( ptr->a + in ) % ptr->max_cap;
-   ptr->b = ( ptr->b + in ) % ptr->max_cap;
-   if( ptr->b < in )
-   {
-      ptr->wrap_a++;
-      ptr->wrap_b++;
-   }
-   return( ptr->b );
-}
-
-size_t 
-Pointer::wrapIndicator( Pointer *ptr )
-{
-   struct{
-      size_t a;
-      size_t b;
-   }copy;
-   do{
-      copy.a = ptr->wrap_a;
-      copy.b = ptr->wrap_b;
-   }while( copy.a ^ copy.b );
-   return( copy.b );
-}
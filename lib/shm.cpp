@@ -0,0 +1,322 @@
+/**
+ * shm.cpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 15:41:09 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "shm.hpp"
+#include "pointer.hpp"
+#include "futex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** "FIFOSHM1" **/
+static const std::uint64_t magic( 0x4649464f53484d31ULL );
+
+/** size of the huge pages we round up to and align on **/
+static const std::size_t huge_page_size( 1 << 21 );
+
+static std::uint64_t
+round_up( const std::uint64_t value, const std::uint64_t align )
+{
+   return( ( value + align - 1 ) / align * align );
+}
+
+static std::string
+error_string( const std::string &what )
+{
+   return( what + ": " + std::strerror( errno ) );
+}
+
+SHM::Geometry
+SHM::make_geometry( const std::size_t   capacity,
+                    const std::size_t   element_size,
+                    const std::size_t   signal_size,
+                    const std::uint32_t layout,
+                    const std::size_t   alignment,
+                    const bool          huge_pages )
+{
+   const std::uint64_t line( L1D_CACHE_LINE_SIZE );
+   Geometry g;
+   std::memset( (void*) &g, 0, sizeof( Geometry ) );
+   g.capacity      = capacity;
+   g.element_size  = element_size;
+   g.signal_size   = signal_size;
+   g.layout        = layout;
+   g.huge_pages    = ( huge_pages ? 1 : 0 );
+   g.read_offset   = round_up( sizeof( Header ), line );
+   g.write_offset  = round_up( g.read_offset + sizeof( Pointer ), line );
+   g.signal_offset = round_up( g.write_offset + sizeof( Pointer ), line );
+   g.signal_length = signal_size * capacity;
+   g.store_offset  = round_up( g.signal_offset + g.signal_length,
+                               std::max< std::uint64_t >( line, alignment ) );
+   g.store_length  = element_size * capacity;
+   g.length        = round_up( g.store_offset + g.store_length,
+                               ( huge_pages ? huge_page_size :
+                                              sysconf( _SC_PAGESIZE ) ) );
+   return( g );
+}
+
+void
+SHM::GenKey( char *buffer, const std::size_t length )
+{
+   static std::atomic< std::uint32_t > count( 0 );
+   std::snprintf( buffer,
+                  length,
+                  "/fifo_%d_%u",
+                  static_cast< int >( getpid() ),
+                  count.fetch_add( 1 ) );
+}
+
+SHM::Segment::Segment( const std::string &key ) :
+   name( key.size() > 0 && key[ 0 ] == '/' ? key : "/" + key ),
+   base( nullptr ),
+   length( 0 ),
+   producer( false ),
+   huge_mapped( false )
+{
+}
+
+SHM::Segment::~Segment()
+{
+   if( base != nullptr )
+   {
+      munmap( base, length );
+   }
+   if( producer )
+   {
+      /** the consumer normally got here first, ENOENT is fine **/
+      shm_unlink( name.c_str() );
+   }
+}
+
+int
+SHM::Segment::open_file( const std::size_t min_length )
+{
+   const int fd( shm_open( name.c_str(), O_RDWR | O_CREAT, 0600 ) );
+   if( fd < 0 )
+   {
+      throw bad_shm_alloc( error_string( "shm_open( " + name + " )" ) );
+   }
+   /** the other end may be doing the same, never shrink it **/
+   flock( fd, LOCK_EX );
+   struct stat st;
+   if( fstat( fd, &st ) != 0 ||
+       ( static_cast< std::size_t >( st.st_size ) < min_length &&
+         ftruncate( fd, min_length ) != 0 ) )
+   {
+      const auto message( error_string( "sizing " + name ) );
+      flock( fd, LOCK_UN );
+      close( fd );
+      throw bad_shm_alloc( message );
+   }
+   flock( fd, LOCK_UN );
+   return( fd );
+}
+
+void
+SHM::Segment::map( const int fd, const std::size_t length, const bool huge_pages )
+{
+   (this)->length = length;
+   if( huge_pages )
+   {
+#ifdef MAP_HUGETLB
+      /** only works if the file lives on hugetlbfs **/
+      base = mmap( nullptr,
+                   length,
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_HUGETLB,
+                   fd,
+                   0 );
+      if( base != MAP_FAILED )
+      {
+         huge_mapped = true;
+         return;
+      }
+#endif
+      /**
+       * otherwise ask for transparent huge pages, those need
+       * the mapping aligned to the huge page size so reserve a
+       * bit extra, map over it and trim the ends.
+       */
+      void *reserve( mmap( nullptr,
+                           length + huge_page_size,
+                           PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS,
+                           -1,
+                           0 ) );
+      if( reserve != MAP_FAILED )
+      {
+         auto *start( reinterpret_cast< char* >( reserve ) );
+         auto *aligned( reinterpret_cast< char* >(
+            round_up( reinterpret_cast< std::uintptr_t >( start ), huge_page_size ) ) );
+         base = mmap( aligned,
+                      length,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_FIXED,
+                      fd,
+                      0 );
+         if( aligned > start )
+         {
+            munmap( start, aligned - start );
+         }
+         munmap( aligned + length, ( start + huge_page_size ) - aligned );
+         if( base == MAP_FAILED )
+         {
+            munmap( aligned, length );
+            base = nullptr;
+            throw bad_shm_alloc( error_string( "mmap( " + name + " )" ) );
+         }
+#ifdef MADV_HUGEPAGE
+         huge_mapped = ( madvise( base, length, MADV_HUGEPAGE ) == 0 );
+#endif
+         return;
+      }
+   }
+   base = mmap( nullptr,
+                length,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED,
+                fd,
+                0 );
+   if( base == MAP_FAILED )
+   {
+      base = nullptr;
+      throw bad_shm_alloc( error_string( "mmap( " + name + " )" ) );
+   }
+}
+
+void
+SHM::Segment::create( const Geometry &geometry )
+{
+   const int fd( open_file( sizeof( Header ) ) );
+   try
+   {
+      /** claim it, a second producer on the same key loses here **/
+      map( fd, sizeof( Header ), false );
+      std::uint32_t expected( Empty );
+      const bool claimed( 
+         header().state.compare_exchange_strong( expected, 
+                                                 Creating,
+                                                 std::memory_order_acq_rel ) );
+      munmap( base, length );
+      base = nullptr;
+      if( ! claimed )
+      {
+         throw bad_shm_alloc( "key " + name + " is already in use" );
+      }
+      if( ftruncate( fd, geometry.length ) != 0 )
+      {
+         throw bad_shm_alloc( error_string( "sizing " + name ) );
+      }
+      map( fd, geometry.length, geometry.huge_pages != 0 );
+   }
+   catch( bad_shm_alloc & )
+   {
+      close( fd );
+      throw;
+   }
+   close( fd );
+   producer = true;
+   auto &head( header() );
+   head.magic    = magic;
+   head.version  = version;
+   head.geometry = geometry;
+}
+
+void
+SHM::Segment::ready()
+{
+   auto &head( header() );
+   head.state.store( Ready, std::memory_order_release );
+   Futex::wake( &head.state );
+}
+
+void
+SHM::Segment::attach()
+{
+   const int fd( open_file( sizeof( Header ) ) );
+   Geometry geometry;
+   try
+   {
+      map( fd, sizeof( Header ), false );
+      auto &head( header() );
+      /** sleep until the producer is done, no spinning **/
+      std::uint32_t state;
+      while( ( state = head.state.load( std::memory_order_acquire ) ) == Empty ||
+             state == Creating )
+      {
+         Futex::wait( &head.state, state );
+      }
+      if( head.magic != magic || head.version != version )
+      {
+         throw bad_shm_alloc( "key " + name + " is not a FIFO segment of version " +
+                              std::to_string( version ) );
+      }
+      /** claim it, a second consumer on the same key loses here **/
+      std::uint32_t expected( Ready );
+      if( ! head.state.compare_exchange_strong( expected, 
+                                                Attached,
+                                                std::memory_order_acq_rel ) )
+      {
+         throw bad_shm_alloc( "key " + name + " already has a consumer" );
+      }
+      geometry = head.geometry;
+      munmap( base, length );
+      base = nullptr;
+      map( fd, geometry.length, geometry.huge_pages != 0 );
+   }
+   catch( bad_shm_alloc & )
+   {
+      if( base != nullptr )
+      {
+         munmap( base, length );
+         base = nullptr;
+      }
+      close( fd );
+      throw;
+   }
+   close( fd );
+   /** both ends have it mapped now, the name isn't needed anymore **/
+   shm_unlink( name.c_str() );
+}
+
+SHM::Header&
+SHM::Segment::header()
+{
+   return( *reinterpret_cast< Header* >( base ) );
+}
+
+void*
+SHM::Segment::at( const std::uint64_t offset )
+{
+   return( reinterpret_cast< char* >( base ) + offset );
+}
+
+bool
+SHM::Segment::huge() const
+{
+   return( huge_mapped );
+}
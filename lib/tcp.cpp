@@ -0,0 +1,277 @@
+/**
+ * tcp.cpp -
+ * @author: Jonathan Beard
+ * @version: Sat Oct 17 18:30:02 2026
+ *
+ * Copyright 2014 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "tcp.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/** "FIFOTCP1" **/
+static const std::uint64_t magic( 0x4649464f54435031ULL );
+
+static std::string
+error_string( const std::string &what )
+{
+   return( what + ": " + std::strerror( errno ) );
+}
+
+/** resolves host:port, IPv4 only **/
+static struct sockaddr_in
+resolve( const std::string &host, const std::uint16_t port )
+{
+   struct sockaddr_in addr;
+   std::memset( &addr, 0, sizeof( addr ) );
+   addr.sin_family = AF_INET;
+   addr.sin_port   = htons( port );
+   if( host.empty() )
+   {
+      addr.sin_addr.s_addr = htonl( INADDR_ANY );
+      return( addr );
+   }
+   if( inet_pton( AF_INET, host.c_str(), &addr.sin_addr ) == 1 )
+   {
+      return( addr );
+   }
+   struct addrinfo hints;
+   std::memset( &hints, 0, sizeof( hints ) );
+   hints.ai_family   = AF_INET;
+   hints.ai_socktype = SOCK_STREAM;
+   struct addrinfo *result( nullptr );
+   if( getaddrinfo( host.c_str(), nullptr, &hints, &result ) != 0 || result == nullptr )
+   {
+      throw bad_tcp_connection( "can't resolve host " + host );
+   }
+   addr.sin_addr = reinterpret_cast< struct sockaddr_in* >( result->ai_addr )->sin_addr;
+   freeaddrinfo( result );
+   return( addr );
+}
+
+/** batching is done by us, don't let Nagle hold frames back **/
+static void
+no_delay( const int fd )
+{
+   const int flag( 1 );
+   setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof( flag ) );
+}
+
+Net::Hello
+Net::make_hello( const std::uint32_t layout,
+                 const std::uint64_t element_size,
+                 const std::uint64_t capacity )
+{
+   Hello hello;
+   std::memset( &hello, 0, sizeof( hello ) );
+   hello.magic        = magic;
+   hello.version      = version;
+   hello.layout       = layout;
+   hello.element_size = element_size;
+   hello.capacity     = capacity;
+   return( hello );
+}
+
+void
+Net::check_hello( const Hello &hello )
+{
+   if( hello.magic != magic || hello.version != version )
+   {
+      throw bad_tcp_connection( "peer isn't a FIFO endpoint of version " +
+                                std::to_string( version ) );
+   }
+}
+
+int
+Net::listen( const std::string &host,
+             const std::uint16_t port,
+             std::uint16_t &bound )
+{
+   auto addr( resolve( host, port ) );
+   const int fd( socket( AF_INET, SOCK_STREAM, 0 ) );
+   if( fd < 0 )
+   {
+      throw bad_tcp_connection( error_string( "socket" ) );
+   }
+   const int flag( 1 );
+   setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof( flag ) );
+   socklen_t length( sizeof( addr ) );
+   if( bind( fd, reinterpret_cast< struct sockaddr* >( &addr ), sizeof( addr ) ) != 0 ||
+       ::listen( fd, 1 ) != 0 ||
+       getsockname( fd, reinterpret_cast< struct sockaddr* >( &addr ), &length ) != 0 )
+   {
+      const auto message( error_string( "listen on " + host + ":" + std::to_string( port ) ) );
+      ::close( fd );
+      throw bad_tcp_connection( message );
+   }
+   bound = ntohs( addr.sin_port );
+   return( fd );
+}
+
+int
+Net::accept( const int fd )
+{
+   while( true )
+   {
+      const int conn( ::accept( fd, nullptr, nullptr ) );
+      if( conn >= 0 )
+      {
+         no_delay( conn );
+         return( conn );
+      }
+      if( errno != EINTR )
+      {
+         return( -1 );
+      }
+   }
+}
+
+int
+Net::connect( const std::string &host,
+              const std::uint16_t port,
+              const std::uint32_t timeout_ms )
+{
+   auto addr( resolve( host, port ) );
+   const auto deadline( std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds( timeout_ms ) );
+   auto delay( std::chrono::milliseconds( 1 ) );
+   while( true )
+   {
+      const int fd( socket( AF_INET, SOCK_STREAM, 0 ) );
+      if( fd < 0 )
+      {
+         throw bad_tcp_connection( error_string( "socket" ) );
+      }
+      if( ::connect( fd, reinterpret_cast< struct sockaddr* >( &addr ), sizeof( addr ) ) == 0 )
+      {
+         no_delay( fd );
+         return( fd );
+      }
+      const int  err( errno );
+      const auto message( error_string( "connect to " + host + ":" + std::to_string( port ) ) );
+      ::close( fd );
+      if( ( err != ECONNREFUSED && err != EINTR ) ||
+          std::chrono::steady_clock::now() > deadline )
+      {
+         throw bad_tcp_connection( message );
+      }
+      /** consumer isn't listening yet, back off **/
+      std::this_thread::sleep_for( delay );
+      delay = std::min( delay * 2, std::chrono::milliseconds( 100 ) );
+   }
+}
+
+/** drops n bytes from the front of iov **/
+static void
+advance( struct iovec *&iov, int &count, std::size_t n )
+{
+   while( count > 0 && n >= iov->iov_len )
+   {
+      n -= iov->iov_len;
+      iov++;
+      count--;
+   }
+   if( count > 0 )
+   {
+      iov->iov_base = reinterpret_cast< char* >( iov->iov_base ) + n;
+      iov->iov_len -= n;
+   }
+}
+
+bool
+Net::send_all( const int fd, struct iovec *iov, int count )
+{
+   while( count > 0 )
+   {
+      struct msghdr msg;
+      std::memset( &msg, 0, sizeof( msg ) );
+      msg.msg_iov    = iov;
+      msg.msg_iovlen = count;
+      /** sendmsg rather than writev so a dead peer doesn't raise SIGPIPE **/
+      const auto ret( sendmsg( fd, &msg, MSG_NOSIGNAL ) );
+      if( ret < 0 )
+      {
+         if( errno == EINTR )
+         {
+            continue;
+         }
+         return( false );
+      }
+      advance( iov, count, ret );
+   }
+   return( true );
+}
+
+bool
+Net::recv_all( const int fd, struct iovec *iov, int count )
+{
+   while( count > 0 )
+   {
+      const auto ret( readv( fd, iov, count ) );
+      if( ret < 0 && errno == EINTR )
+      {
+         continue;
+      }
+      if( ret <= 0 )
+      {
+         return( false );
+      }
+      advance( iov, count, ret );
+   }
+   return( true );
+}
+
+long
+Net::recv_some( const int fd, void *buffer, const std::size_t length )
+{
+   const auto ret( recv( fd, buffer, length, MSG_DONTWAIT ) );
+   if( ret > 0 )
+   {
+      return( ret );
+   }
+   if( ret < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) )
+   {
+      return( 0 );
+   }
+   return( -1 );
+}
+
+void
+Net::shutdown( const int fd )
+{
+   if( fd >= 0 )
+   {
+      ::shutdown( fd, SHUT_RDWR );
+   }
+}
+
+void
+Net::close( const int fd )
+{
+   if( fd >= 0 )
+   {
+      ::close( fd );
+   }
+}
@@ -0,0 +1,135 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <vector>
+#include "ringbuffer.tcc"
+#include "fifoarena.hpp"
+
+/**
+ * thousands of small queues out of one FIFOArena, nothing
+ * else allocated while they are made, every slot run and
+ * index cache line aligned inside the region, some of them
+ * used, one resized out of the arena, bulk teardown.
+ */
+#define BUFFSIZE  32
+#define QUEUES    2000
+#define SENDCOUNT 100000
+
+static std::atomic< std::size_t > allocations( 0 );
+
+void* operator new( std::size_t n )
+{
+   allocations++;
+   void *ptr( std::malloc( n ) );
+   if( ptr == nullptr )
+   {
+      throw std::bad_alloc();
+   }
+   return( ptr );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+   std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+   std::free( ptr );
+}
+
+template < class Q > void
+transfer( FIFO &fifo, const bool resize )
+{
+   std::thread producer( [&]()
+   {
+      for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+      {
+         fifo.push( i, ( i == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE ) );
+         if( resize && i == SENDCOUNT / 2 )
+         {
+            fifo.resize( BUFFSIZE * 4 );
+         }
+      }
+   } );
+   for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+   {
+      std::int64_t value( -1 );
+      RBSignal signal( RBSignal::NONE );
+      fifo.pop( value, &signal );
+      assert( value == i );
+      assert( signal == ( i == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   producer.join();
+}
+
+template < Layout::SlotLayout layout > void
+many()
+{
+   using Queue = RingBuffer< std::int64_t, Type::Heap, layout >;
+   const auto bytes( FIFOArena::bytes_for< Queue >( BUFFSIZE, QUEUES ) );
+   std::vector< FIFO* > queues( QUEUES, nullptr );
+   FIFOArena arena( bytes );
+   const auto before( allocations.load() );
+   arena.make_many< Queue >( BUFFSIZE, QUEUES, queues.data() );
+   assert( allocations.load() == before );
+   assert( arena.size() == QUEUES && arena.used() <= arena.capacity() );
+   for( auto *fifo : queues )
+   {
+      assert( arena.owns( fifo ) );
+      assert( fifo->capacity() == BUFFSIZE && fifo->size() == 0 );
+      /** an empty queue's first slot is the start of its store **/
+      auto range( fifo->allocate_range< std::int64_t >( BUFFSIZE ) );
+      assert( range.size() == BUFFSIZE && range.second.size() == 0 );
+      assert( arena.owns( range.first.ptr ) );
+      assert( reinterpret_cast< std::uintptr_t >( range.first.ptr ) % L1D_CACHE_LINE_SIZE == 0 );
+      fifo->push_range( 0 );
+   }
+   transfer< Queue >( *queues[ 0 ], false );
+   transfer< Queue >( *queues[ QUEUES - 1 ], true );
+   /** a few left holding items, the teardown destroys them **/
+   for( std::size_t q( 1 ); q < 10; q++ )
+   {
+      queues[ q ]->push( std::int64_t( q ) );
+   }
+   arena.clear();
+   assert( arena.size() == 0 && arena.used() == 0 );
+   /** and the space is there again **/
+   arena.make_many< Queue >( BUFFSIZE, QUEUES, queues.data() );
+   transfer< Queue >( *queues[ QUEUES / 2 ], false );
+}
+
+int
+main( int argc, char **argv )
+{
+   many< Layout::Split >();
+   many< Layout::Sparse >();
+   many< Layout::Interleaved >();
+
+   /** through the builder signature **/
+   {
+      FIFOArena arena( FIFOArena::bytes_for< RingBuffer< std::int64_t > >( BUFFSIZE, 4 ) );
+      FIFO *fifo( RingBuffer< std::int64_t >::make_new_fifo( BUFFSIZE, 64, &arena ) );
+      assert( arena.owns( fifo ) && arena.size() == 1 );
+      transfer< RingBuffer< std::int64_t > >( *fifo, false );
+      /** nullptr still means the heap **/
+      FIFO *heap( RingBuffer< std::int64_t >::make_new_fifo( BUFFSIZE, 64, nullptr ) );
+      assert( ! arena.owns( heap ) );
+      delete( heap );
+   }
+
+   /** huge pages if there are any reserved, plain ones otherwise **/
+   {
+      FIFOArena arena( 1 << 21, true );
+      auto *fifo( arena.make< RingBuffer< std::int64_t > >( BUFFSIZE ) );
+      assert( arena.owns( fifo ) );
+      transfer< RingBuffer< std::int64_t > >( *fifo, false );
+      std::cout << ( arena.huge() ? "huge pages\n" : "no huge pages reserved\n" );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,182 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <memory>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * coroutines on both ends of a queue, each resumed by the
+ * other when the queue turns non-empty / non-full.  Only built
+ * as C++20, otherwise there is nothing to test.
+ */
+#define BUFFSIZE  8
+#define SENDCOUNT 100000
+
+#if FIFO_COROUTINES
+static std::atomic< std::size_t > allocations( 0 );
+
+void* operator new( std::size_t n )
+{
+   allocations++;
+   void *ptr( std::malloc( n ) );
+   if( ptr == nullptr )
+   {
+      throw std::bad_alloc();
+   }
+   return( ptr );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+   std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+   std::free( ptr );
+}
+
+/** just enough of a task, runs eagerly, frame freed by the owner **/
+struct Task
+{
+   struct promise_type
+   {
+      Task get_return_object()
+      {
+         return( Task{ std::coroutine_handle< promise_type >::from_promise( *this ) } );
+      }
+      std::suspend_never  initial_suspend() noexcept { return( std::suspend_never() ); }
+      std::suspend_always final_suspend() noexcept   { return( std::suspend_always() ); }
+      void return_void() {}
+      void unhandled_exception() { std::abort(); }
+   };
+
+   std::coroutine_handle< promise_type > handle;
+};
+
+using Queue = RingBuffer< std::int64_t >;
+
+Task producer( Queue &fifo, std::atomic< int > &finished )
+{
+   for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+   {
+      co_await fifo.async_push( i, ( i == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   finished++;
+}
+
+Task consumer( Queue &fifo, std::atomic< int > &finished, const bool range )
+{
+   std::int64_t expected( 0 );
+   std::int64_t items[ BUFFSIZE ];
+   RBSignal     signals[ BUFFSIZE ];
+   while( expected < SENDCOUNT )
+   {
+      if( range )
+      {
+         const auto n( co_await fifo.async_pop_range( items, BUFFSIZE, signals ) );
+         assert( n > 0 && n <= BUFFSIZE );
+         for( std::size_t i( 0 ); i < n; i++ )
+         {
+            assert( items[ i ] == expected );
+            assert( signals[ i ] == ( expected == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE ) );
+            expected++;
+         }
+      }
+      else
+      {
+         std::int64_t value( -1 );
+         RBSignal     signal( RBSignal::NONE );
+         co_await fifo.async_pop( value, &signal );
+         assert( value == expected );
+         assert( signal == ( expected == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE ) );
+         expected++;
+      }
+   }
+   finished++;
+}
+
+/** neither side ever has to wait, nothing may be allocated **/
+Task no_wait( Queue &fifo, std::size_t &allocated )
+{
+   const auto before( allocations.load() );
+   for( std::int64_t i( 0 ); i < 1000; i++ )
+   {
+      co_await fifo.async_push( i );
+      std::int64_t value( -1 );
+      co_await fifo.async_pop( value );
+      assert( value == i );
+   }
+   allocated = allocations.load() - before;
+}
+
+/** the coroutines start on threads that leave once they suspend **/
+void both_ends( const bool range )
+{
+   Queue fifo( BUFFSIZE, 16, Wait::Policy( Wait::Park ) );
+   std::atomic< int > finished( 0 );
+   Task c, p;
+   std::thread consumer_thread( [&](){ c = consumer( fifo, finished, range ); } );
+   std::thread producer_thread( [&](){ p = producer( fifo, finished ); } );
+   consumer_thread.join();
+   producer_thread.join();
+   while( finished.load() != 2 )
+   {
+      std::this_thread::yield();
+   }
+   /** the last one through may still be in final_suspend's shadow **/
+   while( ! c.handle.done() || ! p.handle.done() )
+   {
+      std::this_thread::yield();
+   }
+   c.handle.destroy();
+   p.handle.destroy();
+}
+#endif
+
+int
+main( int argc, char **argv )
+{
+#if FIFO_COROUTINES
+   {
+      Queue fifo( BUFFSIZE, 16, Wait::Policy( Wait::Park ) );
+      std::size_t allocated( 1 );
+      auto task( no_wait( fifo, allocated ) );
+      assert( task.handle.done() );
+      assert( allocated == 0 );
+      task.handle.destroy();
+   }
+   both_ends( false );
+   both_ends( true );
+
+   /** a consumer waiting before anything is pushed, and a move only type **/
+   {
+      RingBuffer< std::unique_ptr< int > > fifo( 2, 16, Wait::Policy( Wait::Park ) );
+      std::unique_ptr< int > out;
+      bool popped( false );
+      auto waiter( [&]() -> Task
+      {
+         co_await fifo.async_pop( out );
+         popped = true;
+      } );
+      auto task( waiter() );
+      assert( ! popped );
+      FIFO &end( fifo );
+      end.push( std::unique_ptr< int >( new int( 7 ) ) );
+      /** resumed inline by the push **/
+      assert( popped && *out == 7 );
+      assert( task.handle.done() );
+      task.handle.destroy();
+   }
+   std::cout << "done\n";
+#else
+   std::cout << "no coroutine support, skipped\n";
+#endif
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,116 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * queues with the capacity fixed at compile time, every layout
+ * goes through single pushes, ranges that split at the end of
+ * the buffer and pops bigger than the buffer.
+ */
+#define BUFFSIZE  64
+#define BATCH     23
+#define SENDCOUNT 100000
+
+void
+producer( FIFO &buffer, const bool signals )
+{
+   std::int64_t current_count( 0 );
+   std::int64_t array[ BATCH ];
+   while( current_count < SENDCOUNT )
+   {
+      if( ( current_count / BATCH ) % 2 == 0 )
+      {
+         std::size_t n( 0 );
+         while( n < BATCH && current_count < SENDCOUNT )
+         {
+            array[ n++ ] = current_count++;
+         }
+         buffer.insert( array, array + n,
+            ( signals && current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+      else
+      {
+         const std::int64_t value( current_count++ );
+         buffer.push( value,
+            ( signals && current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer, const bool signals )
+{
+   std::int64_t expected( 0 );
+   std::int64_t items [ 3 * BUFFSIZE ];
+   RBSignal     signal[ 3 * BUFFSIZE ];
+   std::size_t  chunk( 1 );
+   while( expected < SENDCOUNT )
+   {
+      const auto n( std::min< std::int64_t >( chunk, SENDCOUNT - expected ) );
+      buffer.pop_range( items, n, signal );
+      for( std::int64_t i( 0 ); i < n; i++ )
+      {
+         assert( items[ i ] == expected );
+         expected++;
+         assert( signal[ i ] == ( signals && expected == SENDCOUNT ?
+                                  RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+      chunk = ( ( chunk + 6 ) % ( 3 * BUFFSIZE ) ) + 1;
+   }
+   return;
+}
+
+template < Layout::SlotLayout layout > void
+test()
+{
+   RingBuffer< std::int64_t, Type::Heap, layout, BUFFSIZE > buffer;
+   const bool signals( layout != Layout::SignalFree );
+   std::thread a( producer, std::ref( buffer ), signals );
+   std::thread b( consumer, std::ref( buffer ), signals );
+   a.join();
+   b.join();
+   assert( buffer.size() == 0 );
+   assert( buffer.space_avail() == BUFFSIZE );
+}
+
+int
+main( int argc, char **argv )
+{
+   test< Layout::Split >();
+   test< Layout::Interleaved >();
+   test< Layout::SignalFree >();
+   test< Layout::Sparse >();
+
+   /** fixed means fixed **/
+   RingBuffer< std::int64_t, Type::Heap, Layout::Split, BUFFSIZE > buffer;
+   assert( buffer.capacity() == BUFFSIZE );
+   const bool taken( buffer.resize( 2 * BUFFSIZE ) );
+   assert( ! taken );
+   FIFO &fifo( buffer );
+   for( std::int64_t i( 0 ); i < BUFFSIZE; i++ )
+   {
+      fifo.push( i );
+   }
+   assert( buffer.size() == BUFFSIZE );
+   assert( buffer.space_avail() == 0 );
+   std::int64_t value( 0 );
+   fifo.pop( value );
+   assert( value == 0 );
+   assert( buffer.size() == BUFFSIZE - 1 );
+   assert( buffer.capacity() == BUFFSIZE );
+
+   /** the builder works for them too **/
+   FIFO *built( RingBuffer< std::int64_t, Type::Heap,
+                            Layout::Split, BUFFSIZE >::make_new_fifo( BUFFSIZE, 64, nullptr ) );
+   built->push( value );
+   built->pop( value );
+   assert( value == 0 );
+   delete( built );
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,215 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include "ringbuffer.tcc"
+
+/**
+ * typed Producer / Consumer handles, no virtual calls on the
+ * hot path, mixed with the FIFO interface on the same queues
+ * across every layout and a fixed capacity queue.
+ */
+#define BUFFSIZE  64
+#define SENDCOUNT 200000
+
+static_assert( ! std::is_polymorphic< Typed::Producer< std::int64_t > >::value,
+               "handles have no vtable" );
+static_assert( ! std::is_polymorphic< Typed::Consumer< std::int64_t > >::value,
+               "handles have no vtable" );
+
+template < class Q > void
+transfer( Q &buffer )
+{
+   std::thread producer( [&]()
+   {
+      auto out( buffer.producer() );
+      std::int64_t i( 0 );
+      while( i < SENDCOUNT )
+      {
+         const auto signal( [&]( const std::int64_t n )
+         {
+            return( n == SENDCOUNT - 1 ? RBSignal::RBEOF : RBSignal::NONE );
+         } );
+         switch( i % 4 )
+         {
+            case( 0 ):
+            {
+               out.push( i, signal( i ) );
+               i++;
+            }
+            break;
+            case( 1 ):
+            {
+               out.allocate() = i;
+               out.push( signal( i ) );
+               i++;
+            }
+            break;
+            case( 2 ):
+            {
+               auto range( out.allocate_range( 2 ) );
+               const std::size_t n( std::min< std::size_t >( range.size(), SENDCOUNT - i ) );
+               for( std::size_t j( 0 ); j < n; j++ )
+               {
+                  range[ j ] = i + j;
+               }
+               out.push_range( n, signal( i + n - 1 ) );
+               i += n;
+            }
+            break;
+            default:
+            {
+               /** the FIFO interface still works on the same queue **/
+               FIFO &fifo( buffer );
+               fifo.push( i, signal( i ) );
+               i++;
+            }
+         }
+      }
+   } );
+   FIFO &fifo( buffer );
+   auto in( Typed::Consumer< std::int64_t,
+                             Type::Heap,
+                             Q::layout_t::value,
+                             Q::size_c::value >::from( fifo ) );
+   std::int64_t expected( 0 );
+   RBSignal last( RBSignal::NONE );
+   while( expected < SENDCOUNT )
+   {
+      switch( expected % 3 )
+      {
+         case( 0 ):
+         {
+            std::int64_t value( -1 );
+            in.pop( value, &last );
+            assert( value == expected );
+            expected++;
+         }
+         break;
+         case( 1 ):
+         {
+            std::int64_t values[ 3 ];
+            RBSignal     signals[ 3 ];
+            const std::size_t n( std::min< std::int64_t >( 3, SENDCOUNT - expected ) );
+            in.pop_range( values, n, signals );
+            for( std::size_t j( 0 ); j < n; j++ )
+            {
+               assert( values[ j ] == expected + std::int64_t( j ) );
+            }
+            last = signals[ n - 1 ];
+            expected += n;
+         }
+         break;
+         default:
+         {
+            RBSignal signals[ 4 ];
+            auto range( in.peek_range( 4, signals ) );
+            assert( range.size() >= 1 );
+            for( std::size_t j( 0 ); j < range.size(); j++ )
+            {
+               assert( range[ j ] == expected + std::int64_t( j ) );
+            }
+            last = signals[ range.size() - 1 ];
+            expected += range.size();
+            in.recycle( range.size() );
+         }
+      }
+   }
+   assert( last == RBSignal::RBEOF );
+   assert( in.size() == 0 );
+   producer.join();
+}
+
+/** exposes the template arguments transfer() needs **/
+template < Layout::SlotLayout layout, std::size_t SIZE >
+struct Queue : public RingBuffer< std::int64_t, Type::Heap, layout, SIZE >
+{
+   using layout_t = std::integral_constant< Layout::SlotLayout, layout >;
+   using size_c   = std::integral_constant< std::size_t, SIZE >;
+
+   Queue() : RingBuffer< std::int64_t, Type::Heap, layout, SIZE >( BUFFSIZE,
+                                                                 L1D_CACHE_LINE_SIZE )
+   {
+   }
+};
+
+int
+main( int argc, char **argv )
+{
+   {
+      Queue< Layout::Sparse, 0 > buffer;
+      transfer( buffer );
+   }
+   {
+      Queue< Layout::Split, 0 > buffer;
+      transfer( buffer );
+   }
+   {
+      Queue< Layout::Interleaved, 0 > buffer;
+      transfer( buffer );
+   }
+   {
+      Queue< Layout::Sparse, BUFFSIZE > buffer;
+      transfer( buffer );
+   }
+
+   /** non-blocking calls on a full and an empty queue **/
+   {
+      RingBuffer< std::int64_t > buffer( 4 );
+      auto out( buffer.producer() );
+      auto in ( buffer.consumer() );
+      std::int64_t value( -1 );
+      const bool popped( in.try_pop( value ) );
+      const std::size_t none( in.try_pop_range( &value, 1 ) );
+      assert( ! popped && none == 0 );
+      std::int64_t i( 0 );
+      while( out.try_push( i ) )
+      {
+         i++;
+      }
+      assert( i == std::int64_t( out.capacity() ) && out.space_avail() == 0 );
+      const auto *slot( out.try_allocate() );
+      const bool late( out.try_push_until( i, Wait::Deadline::min() ) );
+      assert( slot == nullptr && ! late );
+      const auto head( in.peek() );
+      assert( head == 0 );
+      in.recycle();
+      const bool pushed( out.try_push( std::int64_t( 99 ) ) );
+      assert( pushed );
+      std::int64_t values[ 8 ];
+      const std::size_t n( in.try_pop_range( values, 8 ) );
+      assert( n == 4 && values[ 0 ] == 1 && values[ 3 ] == 99 );
+   }
+
+   /** move only items, moved in and out **/
+   {
+      RingBuffer< std::unique_ptr< int > > buffer( 8 );
+      auto out( buffer.producer() );
+      auto in ( buffer.consumer() );
+      out.push( std::unique_ptr< int >( new int( 1 ) ) );
+      out.emplace( new int( 2 ) );
+      std::unique_ptr< int > item( new int( 3 ) );
+      const bool pushed( out.try_push( std::move( item ) ) );
+      assert( pushed && item == nullptr );
+      for( int i( 1 ); i <= 3; i++ )
+      {
+         std::unique_ptr< int > popped;
+         in.pop( popped );
+         assert( popped != nullptr && *popped == i );
+      }
+   }
+
+   /** from() on a plain FIFO& **/
+   {
+      RingBuffer< std::int64_t > buffer( 8 );
+      FIFO &fifo( buffer );
+      auto out( Typed::Producer< std::int64_t >::from( fifo ) );
+      out.push( 42 );
+      assert( &out.fifo() == &buffer && fifo.size() == 1 );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
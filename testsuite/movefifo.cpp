@@ -0,0 +1,251 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * non-trivial element types: items are moved or constructed in
+ * place on the way in, moved out on the way out and every slot
+ * is destroyed exactly once, including whatever is still queued
+ * when the FIFO goes away.
+ */
+#define BUFFSIZE  16
+#define SENDCOUNT 20000
+
+/** counts live instances and copies **/
+struct Tracked
+{
+   Tracked() : value( -1 )
+   {
+      live++;
+   }
+
+   Tracked( const std::int64_t value, const std::string &tag ) : value( value ),
+                                                                 tag( tag )
+   {
+      live++;
+   }
+
+   Tracked( const Tracked &other ) : value( other.value ),
+                                     tag( other.tag )
+   {
+      live++;
+      copies++;
+   }
+
+   Tracked( Tracked &&other ) : value( other.value ),
+                                tag( std::move( other.tag ) )
+   {
+      live++;
+   }
+
+   Tracked& operator = ( const Tracked &other )
+   {
+      value = other.value;
+      tag   = other.tag;
+      copies++;
+      return( *this );
+   }
+
+   Tracked& operator = ( Tracked &&other )
+   {
+      value = other.value;
+      tag   = std::move( other.tag );
+      return( *this );
+   }
+
+   ~Tracked()
+   {
+      live--;
+   }
+
+   std::int64_t   value;
+   std::string    tag;
+
+   static std::atomic< std::int64_t > live;
+   static std::atomic< std::int64_t > copies;
+};
+
+std::atomic< std::int64_t > Tracked::live( 0 );
+std::atomic< std::int64_t > Tracked::copies( 0 );
+
+static std::string
+tag( const std::int64_t i )
+{
+   /** long enough to stay off the small string buffer **/
+   return( std::string( 32, 'a' + ( i % 26 ) ) );
+}
+
+void
+producer( FIFO &buffer )
+{
+   for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+   {
+      switch( i % 4 )
+      {
+         case( 0 ):
+         {
+            buffer.emplace< Tracked >( i, tag( i ) );
+         }
+         break;
+         case( 1 ):
+         {
+            buffer.push( Tracked( i, tag( i ) ),
+                         ( i + 1 == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+         }
+         break;
+         case( 2 ):
+         {
+            auto &item( buffer.allocate< Tracked >() );
+            item.value = i;
+            item.tag   = tag( i );
+            buffer.push();
+         }
+         break;
+         default:
+         {
+            /** only part of the range is used, the rest is destroyed **/
+            auto range( buffer.allocate_range< Tracked >( 3 ) );
+            range[ 0 ].value = i;
+            range[ 0 ].tag   = tag( i );
+            buffer.push_range( 1, ( i + 1 == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+         }
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer )
+{
+   std::int64_t expected( 0 );
+   Tracked      items[ 5 ];
+   while( expected < SENDCOUNT )
+   {
+      if( expected % 7 == 0 )
+      {
+         const auto &head( buffer.peek< Tracked >() );
+         assert( head.value == expected && head.tag == tag( expected ) );
+         buffer.recycle( 1 );
+         expected++;
+      }
+      else if( expected % 3 == 0 && expected + 5 <= SENDCOUNT )
+      {
+         buffer.pop_range( items, 5 );
+         for( const auto &item : items )
+         {
+            assert( item.value == expected && item.tag == tag( expected ) );
+            expected++;
+         }
+      }
+      else
+      {
+         RBSignal signal( RBSignal::NONE );
+         buffer.pop( items[ 0 ], &signal );
+         assert( items[ 0 ].value == expected && items[ 0 ].tag == tag( expected ) );
+         expected++;
+         assert( signal == ( expected == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+   }
+   return;
+}
+
+template < class Buffer > void
+test( Buffer &buffer )
+{
+   const auto live_before( Tracked::live.load() );
+   Tracked::copies = 0;
+   std::thread a( producer, std::ref( buffer ) );
+   std::thread b( consumer, std::ref( buffer ) );
+   a.join();
+   b.join();
+   /** nothing went through a copy, and nothing was left behind **/
+   assert( Tracked::copies == 0 );
+   assert( Tracked::live   == live_before );
+}
+
+/** items still queued are destroyed along with the FIFO **/
+template < class Buffer > void
+test_leftovers()
+{
+   const auto live_before( Tracked::live.load() );
+   {
+      Buffer buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      for( std::int64_t i( 0 ); i < BUFFSIZE / 2; i++ )
+      {
+         fifo.emplace< Tracked >( i, tag( i ) );
+      }
+      Tracked item;
+      fifo.pop( item );
+      assert( item.value == 0 );
+      assert( Tracked::live == live_before + BUFFSIZE / 2 );
+   }
+   assert( Tracked::live == live_before );
+}
+
+int
+main( int argc, char **argv )
+{
+   {
+      RingBuffer< Tracked, Type::Heap > buffer( BUFFSIZE );
+      test( buffer );
+   }
+   {
+      RingBuffer< Tracked, Type::Heap, Layout::Interleaved > buffer( BUFFSIZE );
+      test( buffer );
+   }
+   {
+      RingBuffer< Tracked, Type::Heap, Layout::Split, BUFFSIZE > buffer;
+      test( buffer );
+   }
+   {
+      RingBuffer< Tracked, Type::MPMC > buffer( BUFFSIZE );
+      test( buffer );
+   }
+   test_leftovers< RingBuffer< Tracked, Type::Heap > >();
+   test_leftovers< RingBuffer< Tracked, Type::MPMC > >();
+   assert( Tracked::live == 0 );
+
+   /** move only types **/
+   {
+      RingBuffer< std::unique_ptr< std::int64_t >, Type::Heap > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      fifo.push( std::unique_ptr< std::int64_t >( new std::int64_t( 42 ) ) );
+      fifo.emplace< std::unique_ptr< std::int64_t > >( new std::int64_t( 43 ) );
+      std::unique_ptr< std::int64_t > out;
+      fifo.pop( out );
+      assert( out && *out == 42 );
+      fifo.pop( out );
+      assert( out && *out == 43 );
+   }
+
+   /** copying push still copies, once **/
+   {
+      RingBuffer< Tracked, Type::Heap > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      Tracked item( 1, tag( 1 ) );
+      Tracked::copies = 0;
+      fifo.push( item );
+      assert( Tracked::copies == 1 && item.tag == tag( 1 ) );
+      std::vector< Tracked > range( 3, item );
+      Tracked::copies = 0;
+      fifo.insert( range.begin(), range.end() );
+      assert( Tracked::copies == 3 );
+      Tracked out[ 4 ];
+      fifo.pop_range( out, 4 );
+      for( const auto &o : out )
+      {
+         assert( o.value == 1 && o.tag == tag( 1 ) );
+      }
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,234 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <atomic>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * exercises the MPSC, SPMC and MPMC buffers, each producer tags
+ * its items with its id and rotates through push, allocate,
+ * insert and allocate_range.  Consumers rotate through pop,
+ * pop_range and peek / recycle.  Every item has to arrive exactly
+ * once and each consumer has to see each producer's items in order.
+ */
+#define BUFFSIZE  61
+#define BATCH     7
+#define SENDCOUNT 30000
+
+static std::atomic< std::size_t > eof_count( 0 );
+
+static std::uint64_t tag( const std::uint64_t id, const std::uint64_t seq )
+{
+   return( ( id << 32 ) | seq );
+}
+
+void
+producer( FIFO &buffer, const std::uint64_t id )
+{
+   std::uint64_t seq( 0 );
+   std::uint64_t array[ BATCH ];
+   while( seq < SENDCOUNT )
+   {
+      switch( seq % 4 )
+      {
+         case( 0 ):
+         {
+            auto item( tag( id, seq++ ) );
+            buffer.push( item,
+               ( seq == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+         }
+         break;
+         case( 1 ):
+         {
+            auto &slot( buffer.allocate< std::uint64_t >() );
+            slot = tag( id, seq++ );
+            buffer.push( seq == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE );
+         }
+         break;
+         case( 2 ):
+         {
+            std::size_t n( 0 );
+            while( n < BATCH && seq < SENDCOUNT )
+            {
+               array[ n++ ] = tag( id, seq++ );
+            }
+            buffer.insert( array, array + n,
+               ( seq == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+         }
+         break;
+         default:
+         {
+            auto range( buffer.allocate_range< std::uint64_t >( BATCH ) );
+            assert( range.size() > 0 && range.size() <= BATCH );
+            /** leave one slot unused every so often **/
+            const std::size_t count( range.size() > 1 ? range.size() - 1 : 1 );
+            std::size_t i( 0 );
+            for( ; i < count && seq < SENDCOUNT; i++ )
+            {
+               range[ i ] = tag( id, seq++ );
+            }
+            buffer.push_range( i,
+               ( seq == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+         }
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer,
+          const std::size_t total,
+          std::vector< std::uint64_t > &out )
+{
+   std::uint64_t items  [ BATCH ];
+   RBSignal      signals[ BATCH ];
+   auto record( [&]( const std::uint64_t item, const RBSignal signal )
+   {
+      out.push_back( item );
+      if( signal == RBSignal::RBEOF )
+      {
+         eof_count++;
+      }
+   } );
+   while( out.size() < total )
+   {
+      const std::size_t left( total - out.size() );
+      switch( out.size() % 3 )
+      {
+         case( 0 ):
+         {
+            std::uint64_t item( 0 );
+            RBSignal signal( RBSignal::NONE );
+            buffer.pop( item, &signal );
+            record( item, signal );
+         }
+         break;
+         case( 1 ):
+         {
+            const std::size_t n( std::min< std::size_t >( left, BATCH ) );
+            buffer.pop_range( items, n, signals );
+            for( std::size_t i( 0 ); i < n; i++ )
+            {
+               record( items[ i ], signals[ i ] );
+            }
+         }
+         break;
+         default:
+         {
+            RBSignal signal( RBSignal::NONE );
+            const auto item( buffer.peek< std::uint64_t >( &signal ) );
+            /** peeking twice has to give back the same item **/
+            assert( buffer.peek< std::uint64_t >() == item );
+            buffer.recycle();
+            record( item, signal );
+         }
+      }
+   }
+   return;
+}
+
+template < Type::RingBufferType type > void
+run( const std::size_t producers,
+     const std::size_t consumers,
+     const Wait::Policy &policy )
+{
+   RingBuffer< std::uint64_t, type > buffer( BUFFSIZE, 16, policy );
+   const std::size_t total( producers * SENDCOUNT );
+   assert( total % consumers == 0 );
+   std::vector< std::vector< std::uint64_t > > out( consumers );
+   std::vector< std::thread > threads;
+   eof_count = 0;
+   for( std::size_t i( 0 ); i < producers; i++ )
+   {
+      threads.emplace_back( producer, std::ref( buffer ), i );
+   }
+   for( std::size_t i( 0 ); i < consumers; i++ )
+   {
+      threads.emplace_back( consumer,
+                            std::ref( buffer ),
+                            total / consumers,
+                            std::ref( out[ i ] ) );
+   }
+   for( auto &thread : threads )
+   {
+      thread.join();
+   }
+   assert( buffer.size() == 0 );
+   assert( eof_count == producers );
+   std::vector< std::vector< bool > > seen( producers,
+                                            std::vector< bool >( SENDCOUNT, false ) );
+   for( const auto &list : out )
+   {
+      std::vector< std::int64_t > last( producers, -1 );
+      for( const auto item : list )
+      {
+         const auto id ( item >> 32 );
+         const auto seq( static_cast< std::int64_t >( item & 0xffffffff ) );
+         assert( id < producers );
+         assert( seq > last[ id ] );
+         assert( ! seen[ id ][ seq ] );
+         seen[ id ][ seq ] = true;
+         last[ id ] = seq;
+      }
+   }
+   for( const auto &list : seen )
+   {
+      for( const auto flag : list )
+      {
+         assert( flag );
+      }
+   }
+}
+
+/**
+ * a thread still holding slots on a queue another thread destroys
+ * must not carry them over to a new queue built at the same address
+ */
+void
+stale_reservation()
+{
+   using Queue = RingBuffer< std::int64_t, Type::MPMC >;
+   alignas( Queue ) unsigned char storage[ sizeof( Queue ) ];
+   FIFO *fifo( new ( storage ) Queue( BUFFSIZE ) );
+   std::atomic< int > stage( 0 );
+   std::thread holder( [&]()
+   {
+      fifo->allocate< std::int64_t >() = -1;
+      stage.store( 1 );
+      while( stage.load() != 2 )
+      {
+         std::this_thread::yield();
+      }
+      fifo->allocate< std::int64_t >() = 5;
+      fifo->push();
+   } );
+   while( stage.load() != 1 )
+   {
+      std::this_thread::yield();
+   }
+   reinterpret_cast< Queue* >( storage )->~Queue();
+   fifo = new ( storage ) Queue( BUFFSIZE );
+   stage.store( 2 );
+   holder.join();
+   std::int64_t value( 0 );
+   fifo->pop( value );
+   assert( value == 5 );
+   assert( fifo->size() == 0 );
+   reinterpret_cast< Queue* >( storage )->~Queue();
+}
+
+int
+main( int argc, char **argv )
+{
+   stale_reservation();
+   run< Type::MPSC >( 3, 1, Wait::Policy() );
+   run< Type::SPMC >( 1, 3, Wait::Policy() );
+   run< Type::MPMC >( 3, 3, Wait::Policy() );
+   run< Type::MPMC >( 3, 3, Wait::Policy( Wait::Park ) );
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,116 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#if __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "ringbuffer.tcc"
+#include "placement.hpp"
+
+/**
+ * queues placed on NUMA nodes and threads pinned next to
+ * them, the box running this may well have a single node so
+ * the placement itself is checked with get_mempolicy where
+ * the kernel lets us.
+ */
+#define BUFFSIZE  1024
+#define SENDCOUNT 200000
+
+void
+transfer( FIFO &fifo, const Placement::Options &placement )
+{
+   std::thread producer( [&]()
+   {
+      Placement::pin( placement.write );
+      for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+      {
+         fifo.push( i );
+         if( i == SENDCOUNT / 2 )
+         {
+            /** the new buffer goes to the same nodes **/
+            fifo.resize( BUFFSIZE * 2 );
+         }
+      }
+   } );
+   Placement::pin( placement.read );
+   for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+   {
+      std::int64_t value( -1 );
+      fifo.pop( value );
+      assert( value == i );
+   }
+   producer.join();
+}
+
+int
+main( int argc, char **argv )
+{
+   const int nodes( Placement::nodes() );
+   assert( nodes >= 1 );
+   const int here( Placement::current_node() );
+   assert( here >= 0 && here < nodes );
+
+   /** Local and Consumer come out as node numbers **/
+   {
+      const auto resolved( Placement::Options( Placement::Consumer,
+                                               Placement::Local,
+                                               nodes - 1 ).resolved() );
+      assert( resolved.read == here && resolved.store == here && resolved.write == nodes - 1 );
+      assert( ! Placement::Options().placed() );
+      assert( ! Placement::Options().resolved().placed() );
+   }
+
+#if __linux__ && defined( SYS_get_mempolicy )
+   /** bound pages say so **/
+   {
+      const auto page( Placement::page_size() );
+      void *mem( nullptr );
+      const int ret( posix_memalign( &mem, page, 4 * page ) );
+      assert( ret == 0 && mem != nullptr );
+      if( Placement::bind( mem, 4 * page, nodes - 1 ) )
+      {
+         int mode( -1 );
+         const long got( syscall( SYS_get_mempolicy, &mode, nullptr, 0, mem, MPOL_F_ADDR ) );
+         assert( got == 0 && mode == MPOL_PREFERRED );
+      }
+      Placement::prefault( mem, 4 * page );
+      free( mem );
+   }
+#endif
+   const bool empty( Placement::bind( nullptr, 0, 0 ) );
+   assert( ! empty );
+   const bool any( Placement::bind( nullptr, 4096, Placement::Any ) );
+   assert( ! any );
+
+   /** producer on the last node, consumer and store on the first **/
+   {
+      const auto placement( Placement::Options::across( nodes - 1, 0 ) );
+      RingBuffer< std::int64_t > buffer( BUFFSIZE, 64, Wait::Policy(), placement );
+      transfer( buffer, placement );
+   }
+   /** everything wherever the constructing thread is **/
+   {
+      const Placement::Options placement( Placement::Local,
+                                          Placement::Local,
+                                          Placement::Local );
+      RingBuffer< std::int64_t, Type::Heap, Layout::Split > buffer( BUFFSIZE,
+                                                                   16,
+                                                                   Wait::Policy( Wait::Park ),
+                                                                   placement );
+      transfer( buffer, placement.resolved() );
+   }
+   /** no such node, the queue still works **/
+   {
+      const Placement::Options placement( nodes + 7, nodes + 7, nodes + 7, true );
+      RingBuffer< std::int64_t > buffer( BUFFSIZE, 16, Wait::Policy(), placement );
+      const bool pinned( Placement::pin( nodes + 7 ) );
+      assert( ! pinned );
+      transfer( buffer, Placement::Options() );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
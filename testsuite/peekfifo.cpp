@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * batch consumer working on the items in place through
+ * peek_range() and dropping them with recycle(), across
+ * the wrap point and with signals, for each layout.
+ */
+#define BUFFSIZE  16
+#define SENDCOUNT 100000
+
+struct Record
+{
+   std::int64_t id;
+   std::int64_t twice;
+};
+
+template < Layout::SlotLayout layout > void
+batches()
+{
+   RingBuffer< Record, Type::Heap, layout > buffer( BUFFSIZE );
+   FIFO &fifo( buffer );
+   std::thread producer( [&]()
+   {
+      for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+      {
+         fifo.push( Record{ i, 2 * i },
+                    ( i % 7 == 0 ? RBSignal::TERM : RBSignal::NONE ) );
+      }
+   } );
+   std::int64_t expected( 0 );
+   RBSignal     signals[ 5 ];
+   while( expected < SENDCOUNT )
+   {
+      const auto range( fifo.peek_range< Record >( 5, signals ) );
+      assert( range.size() > 0 && range.size() <= 5 );
+      for( const auto &record : range.first )
+      {
+         assert( record.id == expected && record.twice == 2 * expected );
+         expected++;
+      }
+      for( const auto &record : range.second )
+      {
+         assert( record.id == expected && record.twice == 2 * expected );
+         expected++;
+      }
+      for( std::size_t i( 0 ); i < range.size(); i++ )
+      {
+         const std::int64_t id( range[ i ].id );
+         assert( signals[ i ] == ( id % 7 == 0 ? RBSignal::TERM : RBSignal::NONE ) );
+      }
+      /** only the first is done with, the rest show up again **/
+      if( range.size() > 1 && expected % 3 == 0 )
+      {
+         fifo.recycle( 1 );
+         expected -= range.size() - 1;
+      }
+      else
+      {
+         fifo.recycle( range.size() );
+      }
+   }
+   producer.join();
+}
+
+int
+main( int argc, char **argv )
+{
+   batches< Layout::Split >();
+   batches< Layout::Sparse >();
+
+   /** the views wrap at the end of the buffer **/
+   {
+      RingBuffer< std::int64_t > buffer( 4 );
+      FIFO &fifo( buffer );
+      for( std::int64_t i( 0 ); i < 3; i++ )
+      {
+         fifo.push( i );
+      }
+      fifo.recycle( 3 );
+      for( std::int64_t i( 3 ); i < 7; i++ )
+      {
+         fifo.push( i );
+      }
+      const auto range( fifo.peek_range< std::int64_t >( 10 ) );
+      assert( range.first.size() == 1 && range.second.size() == 3 );
+      assert( range.first.contiguous() && range.second.contiguous() );
+      for( std::size_t i( 0 ); i < range.size(); i++ )
+      {
+         assert( range[ i ] == std::int64_t( i + 3 ) );
+      }
+      assert( fifo.size() == 4 );
+      fifo.recycle( 4 );
+      assert( fifo.size() == 0 );
+   }
+
+   /** the multi-consumer queues hand out one at a time **/
+   {
+      RingBuffer< std::int64_t, Type::MPMC > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      fifo.push( std::int64_t( 1 ) );
+      fifo.push( std::int64_t( 2 ), RBSignal::TERM );
+      RBSignal signal[ 2 ] = { RBSignal::QUIT, RBSignal::QUIT };
+      auto range( fifo.peek_range< std::int64_t >( 2, signal ) );
+      assert( range.size() == 1 && range[ 0 ] == 1 && signal[ 0 ] == RBSignal::NONE );
+      fifo.recycle( 1 );
+      range = fifo.peek_range< std::int64_t >( 2, signal );
+      assert( range.size() == 1 && range[ 0 ] == 2 && signal[ 0 ] == RBSignal::TERM );
+      fifo.recycle( 1 );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
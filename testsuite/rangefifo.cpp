@@ -0,0 +1,191 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * exercises allocate_range / push_range and insert, the buffer 
+ * size is deliberately not a multiple of the batch size so that
+ * ranges regularly get split at the end of the buffer.
+ */
+#define BUFFSIZE  61
+#define BATCH     16
+#define SENDCOUNT 100000
+
+/** no default constructor, so slots have to be built from the items **/
+struct Labelled
+{
+   explicit Labelled( const std::int64_t value ) : value( value ),
+                                                   label( std::to_string( value ) )
+   {
+   }
+
+   std::int64_t value;
+   std::string  label;
+};
+
+/** single pass iterator handing out Labelled items read from a stream **/
+class LabelReader
+{
+public:
+   using iterator_category = std::input_iterator_tag;
+   using value_type        = Labelled;
+   using difference_type   = std::ptrdiff_t;
+   using pointer           = const Labelled*;
+   using reference         = Labelled;
+
+   LabelReader() = default;
+   explicit LabelReader( std::istream &in ) : it( in )
+   {
+   }
+
+   Labelled operator*() const { return( Labelled( *it ) ); }
+   LabelReader& operator++() { ++it; return( *this ); }
+   bool operator!=( const LabelReader &other ) const { return( it != other.it ); }
+   bool operator==( const LabelReader &other ) const { return( it == other.it ); }
+
+private:
+   std::istream_iterator< std::int64_t > it;
+};
+
+void
+producer( FIFO &buffer )
+{
+   std::int64_t current_count( 0 );
+   while( current_count < SENDCOUNT )
+   {
+      auto range( buffer.allocate_range< std::int64_t >( BATCH ) );
+      assert( range.size() > 0 && range.size() <= BATCH );
+      /** only publish part of it every so often **/
+      const std::size_t count( ( current_count % 3 == 0 && range.size() > 1 ) ? 
+                                 range.size() - 1 : range.size() );
+      std::size_t i( 0 );
+      for( ; i < count && current_count < SENDCOUNT; i++ )
+      {
+         range[ i ] = current_count++;
+      }
+      buffer.push_range( i, 
+         ( current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   return;
+}
+
+/**
+ * alternates between a raw array (contiguous, bulk copied)
+ * and a std::deque (written through allocate_range)
+ */
+void
+inserter( FIFO &buffer )
+{
+   std::int64_t current_count( 0 );
+   std::int64_t            array[ BATCH ];
+   std::deque< std::int64_t > deque;
+   while( current_count < SENDCOUNT )
+   {
+      const bool use_array( ( current_count / BATCH ) % 2 == 0 );
+      std::size_t n( 0 );
+      deque.clear();
+      while( n < BATCH && current_count < SENDCOUNT )
+      {
+         array[ n++ ] = current_count;
+         deque.push_back( current_count++ );
+      }
+      const RBSignal signal( current_count == SENDCOUNT ? 
+                             RBSignal::RBEOF : RBSignal::NONE );
+      if( use_array )
+      {
+         buffer.insert( array, array + n, signal );
+      }
+      else
+      {
+         buffer.insert( deque.begin(), deque.end(), signal );
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer )
+{
+   std::int64_t expected( 0 );
+   std::int64_t value( 0 );
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      buffer.pop( value, &signal );
+      assert( value == expected );
+      expected++;
+   }
+   assert( expected == SENDCOUNT );
+   return;
+}
+
+int
+main( int argc, char **argv )
+{
+   RingBuffer< std::int64_t, Type::Heap, Layout::Split >        split( BUFFSIZE );
+   RingBuffer< std::int64_t, Type::Heap, Layout::Interleaved >  interleaved( BUFFSIZE );
+   for( FIFO *buffer : { (FIFO*) &split, (FIFO*) &interleaved } )
+   {
+      for( auto *func : { producer, inserter } )
+      {
+         std::thread a( func, std::ref( *buffer ) );
+         std::thread b( consumer, std::ref( *buffer ) );
+         a.join();
+         b.join();
+         assert( buffer->size() == 0 );
+      }
+   }
+   /** iterators that can't jump ahead, forward and single pass **/
+   {
+      FIFO &buffer( split );
+      const std::list< std::int64_t > list( { 1, 2, 3, 4, 5 } );
+      buffer.insert( list.begin(), list.end(), RBSignal::QUIT );
+      std::istringstream stream( "6 7 8" );
+      buffer.insert( std::istream_iterator< std::int64_t >( stream ),
+                     std::istream_iterator< std::int64_t >(),
+                     RBSignal::RBEOF );
+      assert( buffer.size() == 8 );
+      for( std::int64_t i( 1 ); i <= 8; i++ )
+      {
+         std::int64_t value( 0 );
+         RBSignal signal( RBSignal::NONE );
+         buffer.pop( value, &signal );
+         assert( value == i );
+         assert( signal == ( i == 5 ? RBSignal::QUIT : 
+                             i == 8 ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+   }
+   /** items built in place, no default constructor needed **/
+   {
+      RingBuffer< Labelled > labelled( BUFFSIZE );
+      std::list< Labelled > list;
+      for( std::int64_t i( 0 ); i < 40; i++ )
+      {
+         list.emplace_back( i );
+      }
+      labelled.insert( list.begin(), list.end() );
+      std::istringstream stream( "40 41 42" );
+      labelled.insert( LabelReader( stream ), LabelReader(), RBSignal::RBEOF );
+      FIFO &buffer( labelled );
+      assert( buffer.size() == 43 );
+      for( std::int64_t i( 0 ); i < 43; i++ )
+      {
+         Labelled item( -1 );
+         RBSignal signal( RBSignal::NONE );
+         buffer.pop( item, &signal );
+         assert( item.value == i && item.label == std::to_string( i ) );
+         assert( signal == ( i == 42 ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
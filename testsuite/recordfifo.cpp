@@ -0,0 +1,132 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "recordbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * sends records of varying length through a small record ring
+ * so that padding records show up regularly, once between two
+ * threads on the heap and once between two processes in SHM.
+ * Every record carries its sequence number followed by a byte
+ * pattern derived from it.
+ */
+#define RINGSIZE  1000
+#define MAXRECORD 300
+#define SENDCOUNT 50000
+
+static std::size_t length_of( const std::uint32_t seq )
+{
+   return( sizeof( std::uint32_t ) + ( seq * 7919 ) % MAXRECORD );
+}
+
+void
+producer( RecordBufferBase &buffer )
+{
+   for( std::uint32_t seq( 0 ); seq < SENDCOUNT; seq++ )
+   {
+      const std::size_t length( length_of( seq ) );
+      const RBSignal signal( seq + 1 == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE );
+      if( seq % 2 == 0 )
+      {
+         /** reserve more than needed and only commit part of it **/
+         auto *ptr( reinterpret_cast< unsigned char* >( buffer.reserve( length + 16 ) ) );
+         std::memcpy( ptr, &seq, sizeof( seq ) );
+         for( std::size_t i( sizeof( seq ) ); i < length; i++ )
+         {
+            ptr[ i ] = static_cast< unsigned char >( seq + i );
+         }
+         buffer.commit( length, signal );
+      }
+      else
+      {
+         unsigned char record[ MAXRECORD + sizeof( seq ) ];
+         std::memcpy( record, &seq, sizeof( seq ) );
+         for( std::size_t i( sizeof( seq ) ); i < length; i++ )
+         {
+            record[ i ] = static_cast< unsigned char >( seq + i );
+         }
+         buffer.push( record, length, signal );
+      }
+   }
+}
+
+bool
+consumer( RecordBufferBase &buffer )
+{
+   std::uint32_t expected( 0 );
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      const auto record( buffer.peek() );
+      const auto *ptr( reinterpret_cast< const unsigned char* >( record.data ) );
+      std::uint32_t seq( 0 );
+      std::memcpy( &seq, ptr, sizeof( seq ) );
+      if( seq != expected || record.length != length_of( seq ) )
+      {
+         return( false );
+      }
+      for( std::size_t i( sizeof( seq ) ); i < record.length; i++ )
+      {
+         if( ptr[ i ] != static_cast< unsigned char >( seq + i ) )
+         {
+            return( false );
+         }
+      }
+      signal = record.signal;
+      buffer.recycle();
+      expected++;
+   }
+   return( expected == SENDCOUNT );
+}
+
+int
+main( int argc, char **argv )
+{
+   {
+      RecordBuffer< Type::Heap > buffer( RINGSIZE );
+      bool ok( false );
+      std::thread a( producer, std::ref( buffer ) );
+      std::thread b( [&](){ ok = consumer( buffer ); } );
+      a.join();
+      b.join();
+      assert( ok );
+      assert( buffer.size() == 0 );
+   }
+   
+   char shmkey[ 256 ];
+   SHM::GenKey( shmkey, 256 );
+   const std::string key( shmkey );
+   const pid_t child( fork() );
+   switch( child )
+   {
+      case( 0 /* CHILD */ ):
+      {
+         RecordBuffer< Type::SharedMemory > buffer( 0, key, Direction::Consumer );
+         _exit( consumer( buffer ) ? EXIT_SUCCESS : EXIT_FAILURE );
+      }
+      break;
+      case( -1 /* failed to fork */ ):
+      {
+         std::cerr << "Failed to fork, exiting!!\n";
+         exit( EXIT_FAILURE );
+      }
+      break;
+      default: /* parent */
+      {
+         RecordBuffer< Type::SharedMemory > buffer( RINGSIZE, key, Direction::Producer );
+         producer( buffer );
+         int status( 0 );
+         waitpid( child, &status, 0 );
+         assert( WIFEXITED( status ) && WEXITSTATUS( status ) == EXIT_SUCCESS );
+      }
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
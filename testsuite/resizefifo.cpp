@@ -0,0 +1,225 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "autotuner.hpp"
+#include "signalvars.hpp"
+
+/**
+ * a third thread keeps resizing the queue, bigger and smaller
+ * than the traffic in flight, while a producer pushes and
+ * inserts and a consumer pops ranges and peeks.  Every item
+ * and signal must come out in order.
+ */
+#define BUFFSIZE 16
+
+typedef RingBuffer< std::int64_t, Type::Heap > TheBuffer;
+
+static RBSignal
+expected_signal( const std::int64_t value, const std::int64_t send_count )
+{
+   if( value == send_count )
+   {
+      return( RBSignal::RBEOF );
+   }
+   return( value % 7 == 0 ? RBSignal::QUIT : RBSignal::NONE );
+}
+
+void
+producer( FIFO &buffer, const std::int64_t send_count )
+{
+   std::int64_t i( 1 );
+   while( i <= send_count )
+   {
+      /** every run of three ending on a multiple of 7 goes in as a range **/
+      if( ( i + 2 ) % 7 == 0 && i + 2 < send_count )
+      {
+         const std::int64_t range[ 3 ] = { i, i + 1, i + 2 };
+         buffer.insert( range, range + 3, RBSignal::QUIT );
+         i += 3;
+      }
+      else
+      {
+         buffer.push( i, expected_signal( i, send_count ) );
+         i++;
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer, const std::int64_t send_count )
+{
+   std::int64_t expected( 1 );
+   std::int64_t items[ 5 ];
+   RBSignal     signals[ 5 ];
+   std::size_t  chunk( 1 );
+   while( expected <= send_count )
+   {
+      if( chunk == 5 )
+      {
+         RBSignal signal( RBSignal::NONE );
+         const auto value( buffer.peek< std::int64_t >( &signal ) );
+         assert( value == expected );
+         assert( signal == expected_signal( expected, send_count ) );
+         buffer.recycle( 1 );
+         expected++;
+      }
+      else
+      {
+         const auto n( std::min< std::int64_t >( chunk, send_count - expected + 1 ) );
+         buffer.pop_range( items, n, signals );
+         for( std::int64_t j( 0 ); j < n; j++ )
+         {
+            assert( items[ j ] == expected );
+            assert( signals[ j ] == expected_signal( expected, send_count ) );
+            expected++;
+         }
+      }
+      chunk = ( chunk % 5 ) + 1;
+   }
+   return;
+}
+
+void
+resizer( FIFO &buffer, std::atomic< bool > &done )
+{
+   const std::size_t caps[] = { 1, 3, 64, 2, 1000, 5, 16 };
+   std::size_t i( 0 );
+   while( ! done.load() )
+   {
+      const bool taken( buffer.resize( caps[ i++ % 7 ] ) );
+      assert( taken );
+      std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+   }
+   return;
+}
+
+/** size() from a thread that is neither end, while buffers come and go **/
+void
+watcher( FIFO &buffer, const std::int64_t send_count, std::atomic< bool > &done )
+{
+   while( ! done.load() )
+   {
+      const std::size_t used( buffer.size() );
+      assert( used <= std::size_t( send_count ) );
+      /** largest capacity resizer() asks for **/
+      const std::size_t free( buffer.space_avail() );
+      assert( free <= 1000 );
+   }
+   return;
+}
+
+/** pushes and pops one item so the producer picks up a pending resize **/
+static void
+cycle( FIFO &buffer )
+{
+   std::int64_t value( 0 );
+   buffer.push( value );
+   buffer.pop( value );
+}
+
+int
+main( int argc, char **argv )
+{
+   const std::int64_t send_count( 200000 );
+   for( const auto strategy : { Wait::Yield, Wait::Park } )
+   {
+      TheBuffer buffer( BUFFSIZE, 16, Wait::Policy( strategy ) );
+      std::atomic< bool > done( false );
+      std::thread a( producer, std::ref( buffer ), send_count );
+      std::thread b( consumer, std::ref( buffer ), send_count );
+      std::thread c( resizer,  std::ref( buffer ), std::ref( done ) );
+      std::thread d( watcher,  std::ref( buffer ), send_count, std::ref( done ) );
+      a.join();
+      b.join();
+      done = true;
+      c.join();
+      d.join();
+      assert( buffer.size() == 0 );
+   }
+
+   /** only heap queues resize **/
+   RingBuffer< std::int64_t, Type::MPMC > multi( BUFFSIZE );
+   const bool multi_taken( multi.resize( 2 * BUFFSIZE ) );
+   assert( ! multi_taken );
+
+   /** resize takes effect on the next write **/
+   TheBuffer buffer( 4 );
+   const bool requested( buffer.resize( 32 ) );
+   assert( requested );
+   assert( buffer.capacity() == 4 );
+   cycle( buffer );
+   assert( buffer.capacity() == 32 );
+
+   /** items left in the old buffer still count **/
+   TheBuffer old( 4 );
+   FIFO &drain( old );
+   for( std::int64_t i( 0 ); i < 4; i++ )
+   {
+      drain.push( i );
+   }
+   const bool taken( drain.resize( 32 ) );
+   assert( taken );
+   drain.push( std::int64_t( 4 ) );
+   assert( drain.capacity() == 32 && drain.size() == 5 );
+   assert( drain.space_avail() == 31 );
+   for( std::int64_t i( 0 ); i < 5; i++ )
+   {
+      std::int64_t value( -1 );
+      drain.pop( value );
+      assert( value == i && drain.size() == std::size_t( 4 - i ) );
+   }
+
+   /** a writer that blocks gets grown, an idle one shrunk **/
+   AutoTuner::Policy policy;
+   policy.min_cap      = 4;
+   policy.max_cap      = 64;
+   policy.idle_periods = 3;
+   AutoTuner tuner( policy );
+   TheBuffer tuned( 4 );
+   tuner.add( &tuned );
+   std::thread a( producer, std::ref( tuned ), 100 );
+   /** give the producer time to fill the queue and block **/
+   std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+   std::thread b( consumer, std::ref( tuned ), 100 );
+   a.join();
+   b.join();
+   tuner.tune();
+   cycle( tuned );
+   assert( tuned.capacity() == 8 );
+   for( int i( 0 ); i < 3; i++ )
+   {
+      tuner.tune();
+   }
+   cycle( tuned );
+   assert( tuned.capacity() == 4 );
+   /** already at min_cap **/
+   for( int i( 0 ); i < 3; i++ )
+   {
+      tuner.tune();
+   }
+   cycle( tuned );
+   assert( tuned.capacity() == 4 );
+
+   /** and the background thread does the same on its own **/
+   policy.period = std::chrono::milliseconds( 1 );
+   AutoTuner background( policy );
+   TheBuffer idle( 64 );
+   background.add( &idle );
+   background.start();
+   while( idle.capacity() > 4 )
+   {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+      cycle( idle );
+   }
+   background.stop();
+   background.remove( &idle );
+   tuner.remove( &tuned );
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -5,6 +5,9 @@
 #include <cassert>
 #include <cinttypes>
 #include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "ringbuffer.tcc"
 #include "signalvars.hpp"
 
@@ -35,25 +38,21 @@ struct Data
 };
 
 
-//#define USESharedMemory 1
-#define USELOCAL 1
 #define BUFFSIZE 64
 
-#ifdef USESharedMemory
-typedef RingBuffer< std::int64_t, 
-                    Type::SharedMemory 
-                    > TheBuffer;
-#elif defined USELOCAL
 typedef RingBuffer< std::int64_t          /* buffer type */,
                     Type::Heap            /* allocation type */
                     >  TheBuffer;
-#endif
+
+typedef RingBuffer< std::int64_t, 
+                    Type::SharedMemory 
+                    > TheSHMBuffer;
 
 
 
 
 void
-producer( Data &data, TheBuffer &buffer )
+producer( Data &data, FIFO &buffer )
 {
    std::int64_t current_count( 0 );
    while( current_count++ < data.send_count )
@@ -78,7 +77,7 @@ producer( Data &data, TheBuffer &buffer )
 }
 
 void 
-consumer( Data &data, TheBuffer &buffer )
+consumer( Data &data, FIFO &buffer )
 {
    std::int64_t   current_count( 0 );
    RBSignal signal( RBSignal::NONE );
@@ -94,22 +93,37 @@ consumer( Data &data, TheBuffer &buffer )
 
 std::string test( Data &data )
 {
-#ifdef USESharedMemory
+   TheBuffer buffer( BUFFSIZE );
+   std::thread a( producer, 
+                  std::ref( data ), 
+                  std::ref( buffer ) );
+
+   std::thread b( consumer, 
+                  std::ref( data ),
+                  std::ref( buffer ) );
+   a.join();
+   b.join();
+   return( "done" );
+}
+
+/** same again with the consumer in a child process **/
+std::string test_shm( Data &data )
+{
    char shmkey[ 256 ];
    SHM::GenKey( shmkey, 256 );
    std::string key( shmkey );
-   ProcWait *proc_wait( new ProcWait( 1 ) ); 
+   /** or the child prints whatever is still buffered a second time **/
+   std::cout.flush();
    const pid_t child( fork() );
    switch( child )
    {
       case( 0 /* CHILD */ ):
       {
-         TheBuffer buffer_b( BUFFSIZE,
-                             key, 
-                             Direction::Consumer, 
-                             false);
+         TheSHMBuffer buffer_b( BUFFSIZE,
+                                key, 
+                                Direction::Consumer );
          /** call consumer function directly **/
-         consumer( buffer_b );
+         consumer( data, buffer_b );
          exit( EXIT_SUCCESS );
       }
       break;
@@ -121,33 +135,21 @@ std::string test( Data &data )
       break;
       default: /* parent */
       {
-         proc_wait->AddProcess( child );
-         TheBuffer buffer_a( BUFFSIZE,
-                             key, 
-                             Direction::Producer, 
-                             false);
+         TheSHMBuffer buffer_a( BUFFSIZE,
+                                key, 
+                                Direction::Producer );
          /** call producer directly **/
          producer( data, buffer_a );
+         /** parent waits for child before the segment goes away **/
+         int status( 0 );
+         waitpid( child, &status, 0 );
+         if( ! WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS )
+         {
+            std::cerr << "consumer process failed\n";
+            exit( EXIT_FAILURE );
+         }
       }
    }
-  
-   /** parent waits for child **/
-   proc_wait->WaitForChildren();
-
-   delete( proc_wait );
-   
-#elif defined USELOCAL
-   TheBuffer buffer( BUFFSIZE );
-   std::thread a( producer, 
-                  std::ref( data ), 
-                  std::ref( buffer ) );
-
-   std::thread b( consumer, 
-                  std::ref( data ),
-                  std::ref( buffer ) );
-   a.join();
-   b.join();
-#endif
    return( "done" );
 }
 
@@ -165,10 +167,12 @@ main( int argc, char **argv )
    
    
    std::cout << test( data ) << "\n";
-   for( auto i( 1 ); i < test_data.size(); i++ )
+   assert( test_data.size() == std::size_t( data.send_count ) );
+   for( std::size_t i( 1 ); i <= test_data.size(); i++ )
    {
-           assert( test_data[ i-1 ] = i );
+           assert( test_data[ i-1 ] == std::int64_t( i ) );
    }
+   std::cout << test_shm( data ) << "\n";
    exit( 0 );
 }
 
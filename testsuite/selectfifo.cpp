@@ -0,0 +1,248 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#if __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+#include "ringbuffer.tcc"
+#include "fifoselector.hpp"
+#include "shm.hpp"
+#include "signalvars.hpp"
+
+/**
+ * one consumer thread serving many FIFOs through a selector,
+ * it only wakes when one of them has something, plus write
+ * interest, deadlines, polled SHM queues and the eventfd.
+ */
+#define BUFFSIZE  16
+#define QUEUES    8
+#define SENDCOUNT 20000
+
+using namespace std::chrono;
+
+void
+many_producers( const Wait::Strategy strategy )
+{
+   std::vector< std::unique_ptr< FIFO > > queues;
+   for( std::size_t q( 0 ); q < QUEUES; q++ )
+   {
+      if( q == QUEUES - 1 )
+      {
+         queues.emplace_back( new RingBuffer< std::int64_t, Type::MPSC >( BUFFSIZE, 16,
+                                                                         Wait::Policy( strategy ) ) );
+      }
+      else
+      {
+         queues.emplace_back( new RingBuffer< std::int64_t >( BUFFSIZE, 16, Wait::Policy( strategy ) ) );
+      }
+   }
+   FIFOSelector selector;
+   for( auto &queue : queues )
+   {
+      selector.add( queue.get(), FIFOSelector::Read );
+   }
+   std::vector< std::thread > producers;
+   for( std::size_t q( 0 ); q < QUEUES; q++ )
+   {
+      producers.emplace_back( [&, q]()
+      {
+         FIFO &fifo( *queues[ q ] );
+         for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+         {
+            fifo.push( i );
+            if( q % 3 == 0 && i % 1000 == 0 )
+            {
+               /** some go quiet for a while **/
+               std::this_thread::sleep_for( microseconds( 200 ) );
+            }
+         }
+      } );
+   }
+   std::int64_t expected[ QUEUES ] = { 0 };
+   std::size_t  done( 0 );
+   std::int64_t items[ BUFFSIZE ];
+   std::vector< FIFOSelector::Event > events;
+   while( done < QUEUES )
+   {
+      selector.select( events );
+      assert( ! events.empty() );
+      for( const auto &event : events )
+      {
+         assert( event.ready == FIFOSelector::Read );
+         std::size_t q( 0 );
+         while( queues[ q ].get() != event.fifo )
+         {
+            q++;
+         }
+         const auto n( event.fifo->try_pop_range( items, BUFFSIZE ) );
+         for( std::size_t i( 0 ); i < n; i++ )
+         {
+            assert( items[ i ] == expected[ q ] );
+            expected[ q ]++;
+         }
+         if( n > 0 && expected[ q ] == SENDCOUNT )
+         {
+            selector.remove( event.fifo );
+            done++;
+         }
+      }
+   }
+   for( auto &producer : producers )
+   {
+      producer.join();
+   }
+}
+
+int
+main( int argc, char **argv )
+{
+   many_producers( Wait::Yield );
+   many_producers( Wait::Park );
+
+   /** nothing there, the deadline holds **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      FIFOSelector selector;
+      selector.add( &buffer, FIFOSelector::Read );
+      std::vector< FIFOSelector::Event > events;
+      const auto now( selector.select( events, Wait::Deadline::min() ) );
+      assert( now == 0 );
+      const auto start( steady_clock::now() );
+      const auto later( selector.select_for( events, milliseconds( 5 ) ) );
+      assert( later == 0 );
+      assert( steady_clock::now() - start >= milliseconds( 5 ) );
+   }
+
+   /** a full FIFO turns writable once the consumer gets going **/
+   {
+      RingBuffer< std::int64_t > buffer( 2 );
+      FIFO &fifo( buffer );
+      fifo.push( std::int64_t( 1 ) );
+      fifo.push( std::int64_t( 2 ) );
+      FIFOSelector selector;
+      selector.add( &buffer, FIFOSelector::Write );
+      std::vector< FIFOSelector::Event > events;
+      const auto full( selector.select( events, Wait::Deadline::min() ) );
+      assert( full == 0 );
+      std::thread consumer( [&]()
+      {
+         std::this_thread::sleep_for( milliseconds( 10 ) );
+         std::int64_t value( 0 );
+         fifo.pop( value );
+      } );
+      const auto ready( selector.select_for( events, seconds( 30 ) ) );
+      assert( ready == 1 );
+      assert( events[ 0 ].fifo == &buffer && events[ 0 ].ready == FIFOSelector::Write );
+      consumer.join();
+   }
+
+   /** the other end is in "another process", found by polling **/
+   {
+      char shmkey[ 256 ];
+      SHM::GenKey( shmkey, 256 );
+      RingBuffer< std::int64_t, Type::SharedMemory > in( BUFFSIZE, shmkey, Direction::Producer );
+      RingBuffer< std::int64_t, Type::SharedMemory > out( 0, shmkey, Direction::Consumer );
+      assert( ! out.notifies() );
+      FIFOSelector selector( microseconds( 100 ) );
+      selector.add( &out, FIFOSelector::Read );
+      std::thread producer( [&]()
+      {
+         std::this_thread::sleep_for( milliseconds( 10 ) );
+         FIFO &fifo( in );
+         fifo.push( std::int64_t( 3 ) );
+      } );
+      std::vector< FIFOSelector::Event > events;
+      const auto ready( selector.select_for( events, seconds( 30 ) ) );
+      assert( ready == 1 );
+      std::int64_t value( 0 );
+      FIFO &fifo( out );
+      const bool popped( fifo.try_pop( value ) );
+      assert( popped && value == 3 );
+      producer.join();
+   }
+
+#if __linux__
+   /** inside somebody else's epoll loop **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      FIFOSelector selector;
+      selector.add( &buffer, FIFOSelector::Read );
+      const int epfd( epoll_create1( 0 ) );
+      assert( epfd >= 0 );
+      struct epoll_event ev;
+      ev.events  = EPOLLIN;
+      ev.data.fd = selector.fd();
+      const int added( epoll_ctl( epfd, EPOLL_CTL_ADD, selector.fd(), &ev ) );
+      assert( added == 0 );
+      std::vector< FIFOSelector::Event > events;
+      /** empty, and armed for the next push **/
+      const auto empty( selector.select( events, Wait::Deadline::min() ) );
+      assert( empty == 0 );
+      std::thread producer( [&]()
+      {
+         for( std::int64_t i( 0 ); i < 100; i++ )
+         {
+            fifo.push( i );
+            std::this_thread::sleep_for( microseconds( 50 ) );
+         }
+      } );
+      std::int64_t expected( 0 );
+      while( expected < 100 )
+      {
+         struct epoll_event out;
+         const int woke( epoll_wait( epfd, &out, 1, 30000 ) );
+         assert( woke == 1 );
+         assert( out.data.fd == selector.fd() );
+         while( selector.select( events, Wait::Deadline::min() ) > 0 )
+         {
+            std::int64_t value( 0 );
+            while( fifo.try_pop( value ) )
+            {
+               assert( value == expected );
+               expected++;
+            }
+         }
+      }
+      producer.join();
+      close( epfd );
+   }
+#endif
+
+   /** the selector can go away while the producer keeps going **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      std::atomic< bool > stop( false );
+      std::thread producer( [&]()
+      {
+         std::int64_t i( 0 );
+         while( ! stop )
+         {
+            if( ! fifo.try_push( i ) )
+            {
+               std::this_thread::yield();
+            }
+         }
+      } );
+      for( std::size_t i( 0 ); i < 1000; i++ )
+      {
+         FIFOSelector selector;
+         selector.add( &buffer, FIFOSelector::Read );
+         std::vector< FIFOSelector::Event > events;
+         selector.select_for( events, microseconds( 10 ) );
+         std::int64_t items[ BUFFSIZE ];
+         fifo.try_pop_range( items, BUFFSIZE );
+      }
+      stop = true;
+      producer.join();
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,192 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <atomic>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * runs a producer and a consumer in separate processes over a
+ * SharedMemory queue.  The consumer doesn't pass a capacity, it
+ * is read from the segment.  Each layout is run once with the
+ * consumer started first and once with the producer first.
+ */
+#define BUFFSIZE  61
+#define BATCH     16
+#define SENDCOUNT 100000
+
+template < Layout::SlotLayout layout > int
+consumer( const std::string key )
+{
+   RingBuffer< std::int64_t, Type::SharedMemory, layout > buffer( 0,
+                                                                  key,
+                                                                  Direction::Consumer );
+   if( buffer.capacity() != BUFFSIZE )
+   {
+      return( EXIT_FAILURE );
+   }
+   FIFO &fifo( buffer );
+   std::int64_t expected( 0 );
+   std::int64_t items[ BATCH ];
+   RBSignal     signals[ BATCH ];
+   RBSignal     signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      if( SENDCOUNT - expected >= BATCH )
+      {
+         fifo.pop_range( items, BATCH, signals );
+         for( std::size_t i( 0 ); i < BATCH; i++ )
+         {
+            if( items[ i ] != expected++ )
+            {
+               return( EXIT_FAILURE );
+            }
+         }
+         signal = signals[ BATCH - 1 ];
+      }
+      else
+      {
+         std::int64_t item( 0 );
+         fifo.pop( item, &signal );
+         if( item != expected++ )
+         {
+            return( EXIT_FAILURE );
+         }
+      }
+   }
+   return( expected == SENDCOUNT ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+template < Layout::SlotLayout layout > void
+producer( const std::string key, const bool huge_pages )
+{
+   RingBuffer< std::int64_t, Type::SharedMemory, layout > buffer( BUFFSIZE,
+                                                                  key,
+                                                                  Direction::Producer,
+                                                                  16,
+                                                                  Wait::Policy(),
+                                                                  huge_pages );
+   FIFO &fifo( buffer );
+   std::int64_t current_count( 0 );
+   while( current_count < SENDCOUNT )
+   {
+      auto &ref( fifo.allocate< std::int64_t >() );
+      ref = current_count++;
+      fifo.push( current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE );
+   }
+   /** wait for the consumer before unmapping **/
+   while( buffer.size() > 0 )
+   {
+      std::this_thread::yield();
+   }
+}
+
+template < Layout::SlotLayout layout > void
+run( const bool consumer_first, const bool huge_pages )
+{
+   char shmkey[ 256 ];
+   SHM::GenKey( shmkey, 256 );
+   const std::string key( shmkey );
+   const pid_t child( fork() );
+   switch( child )
+   {
+      case( 0 /* CHILD */ ):
+      {
+         if( ! consumer_first )
+         {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+         }
+         _exit( consumer< layout >( key ) );
+      }
+      break;
+      case( -1 /* failed to fork */ ):
+      {
+         std::cerr << "Failed to fork, exiting!!\n";
+         exit( EXIT_FAILURE );
+      }
+      break;
+      default: /* parent */
+      {
+         if( consumer_first )
+         {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+         }
+         producer< layout >( key, huge_pages );
+         int status( 0 );
+         waitpid( child, &status, 0 );
+         assert( WIFEXITED( status ) && WEXITSTATUS( status ) == EXIT_SUCCESS );
+      }
+   }
+}
+
+/** one producer and one consumer per key, the second of each is turned away **/
+void
+claims()
+{
+   char key[ 256 ];
+   SHM::GenKey( key, 256 );
+   const auto geometry( SHM::make_geometry( BUFFSIZE, 
+                                            sizeof( std::int64_t ), 
+                                            0, 
+                                            Layout::Split, 
+                                            64, 
+                                            false ) );
+   SHM::Segment first( key ), second( key );
+   first.create( geometry );
+   bool refused( false );
+   try
+   {
+      second.create( geometry );
+   }
+   catch( bad_shm_alloc & )
+   {
+      refused = true;
+   }
+   assert( refused );
+   /** both consumers are waiting on the segment before it is ready **/
+   std::atomic< int > attached( 0 ), turned_away( 0 );
+   std::vector< std::thread > consumers;
+   for( int i( 0 ); i < 2; i++ )
+   {
+      consumers.emplace_back( [&]()
+      {
+         SHM::Segment reader( key );
+         try
+         {
+            reader.attach();
+            attached++;
+         }
+         catch( bad_shm_alloc & )
+         {
+            turned_away++;
+         }
+      } );
+   }
+   std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+   first.ready();
+   for( auto &consumer : consumers )
+   {
+      consumer.join();
+   }
+   refused = ( attached == 1 && turned_away == 1 );
+   assert( refused );
+}
+
+int
+main( int argc, char **argv )
+{
+   claims();
+   run< Layout::Split >( true, false );
+   run< Layout::Split >( false, false );
+   run< Layout::Interleaved >( true, true );
+   run< Layout::Interleaved >( false, false );
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
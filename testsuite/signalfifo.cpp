@@ -0,0 +1,271 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * signals on the Sparse layout (the heap default), only some
+ * elements carry one and each must come out with its element
+ * through every pop path.  Also the asynchronous signals and
+ * get_write_finished().
+ */
+#define BUFFSIZE  16
+#define SENDCOUNT 100000
+
+static_assert( std::is_same< RingBuffer< std::int64_t >,
+                             RingBuffer< std::int64_t, Type::Heap, Layout::Sparse > >::value,
+               "heap queues default to the sparse layout" );
+
+/** which elements get a signal, every one when dense is set **/
+static RBSignal
+signal_for( const std::int64_t i, const bool dense )
+{
+   if( i + 1 == SENDCOUNT )
+   {
+      return( RBSignal::RBEOF );
+   }
+   if( dense || i % 97 == 0 )
+   {
+      return( RBSignal::TERM );
+   }
+   return( RBSignal::NONE );
+}
+
+void
+producer( FIFO &buffer, const bool dense )
+{
+   std::int64_t i( 0 );
+   std::int64_t array[ 5 ];
+   while( i < SENDCOUNT )
+   {
+      switch( i % 3 )
+      {
+         case( 0 ):
+         {
+            buffer.push( i, signal_for( i, dense ) );
+            i++;
+         }
+         break;
+         case( 1 ):
+         {
+            /** the signal only goes on the last of the range **/
+            std::size_t n( 0 );
+            while( n < 5 && i < SENDCOUNT )
+            {
+               array[ n++ ] = i++;
+               if( n < 5 && i < SENDCOUNT && signal_for( i - 1, dense ) != RBSignal::NONE )
+               {
+                  break;
+               }
+            }
+            buffer.insert( array, array + n, signal_for( i - 1, dense ) );
+         }
+         break;
+         default:
+         {
+            auto range( buffer.allocate_range< std::int64_t >( 2 ) );
+            range[ 0 ] = i++;
+            buffer.push_range( 1, signal_for( i - 1, dense ) );
+         }
+      }
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer, const bool dense )
+{
+   std::int64_t expected( 0 );
+   std::int64_t items [ 7 ];
+   RBSignal     signal[ 7 ];
+   while( expected < SENDCOUNT )
+   {
+      if( expected % 5 == 0 )
+      {
+         RBSignal peeked( RBSignal::NONE );
+         const auto &head( buffer.peek< std::int64_t >( &peeked ) );
+         assert( head == expected );
+         assert( peeked == signal_for( expected, dense ) );
+         buffer.recycle( 1 );
+         expected++;
+      }
+      else if( expected % 3 == 0 && expected + 7 <= SENDCOUNT )
+      {
+         buffer.pop_range( items, 7, signal );
+         for( std::size_t i( 0 ); i < 7; i++ )
+         {
+            assert( items[ i ] == expected );
+            assert( signal[ i ] == signal_for( expected, dense ) );
+            expected++;
+         }
+      }
+      else
+      {
+         std::int64_t value( 0 );
+         RBSignal     popped( RBSignal::NONE );
+         buffer.pop( value, &popped );
+         assert( value == expected );
+         assert( popped == signal_for( expected, dense ) );
+         expected++;
+      }
+   }
+   return;
+}
+
+template < class Buffer > void
+test( Buffer &buffer, const bool dense )
+{
+   std::thread a( producer, std::ref( buffer ), dense );
+   std::thread b( consumer, std::ref( buffer ), dense );
+   a.join();
+   b.join();
+   assert( buffer.size() == 0 );
+   bool finished( false );
+   buffer.get_write_finished( finished );
+   assert( finished );
+}
+
+int
+main( int argc, char **argv )
+{
+   for( const bool dense : { false, true } )
+   {
+      {
+         RingBuffer< std::int64_t > buffer( BUFFSIZE );
+         test( buffer, dense );
+      }
+      {
+         RingBuffer< std::int64_t, Type::Heap, Layout::Sparse, BUFFSIZE > buffer;
+         test( buffer, dense );
+      }
+      {
+         /** same stream on the old layout **/
+         RingBuffer< std::int64_t, Type::Heap, Layout::Split > buffer( BUFFSIZE );
+         test( buffer, dense );
+      }
+   }
+
+   /** finished only once the end of the stream is in the queue **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      bool finished( true );
+      fifo.push( std::int64_t( 1 ) );
+      fifo.get_write_finished( finished );
+      assert( ! finished );
+      auto &item( fifo.allocate< std::int64_t >() );
+      item = 2;
+      fifo.get_write_finished( finished );
+      assert( ! finished );
+      fifo.push( RBSignal::RBEOF );
+      fifo.get_write_finished( finished );
+      assert( finished );
+      std::int64_t value( 0 );
+      RBSignal signal( RBSignal::NONE );
+      fifo.pop( value, &signal );
+      assert( value == 1 && signal == RBSignal::NONE );
+      fifo.pop( value, &signal );
+      assert( value == 2 && signal == RBSignal::RBEOF );
+   }
+
+   /** signals survive a resize, queued ones stay with the old buffer **/
+   {
+      RingBuffer< std::int64_t > buffer( 4 );
+      FIFO &fifo( buffer );
+      fifo.push( std::int64_t( 0 ), RBSignal::TERM );
+      fifo.push( std::int64_t( 1 ) );
+      const bool taken( buffer.resize( 16 ) );
+      assert( taken );
+      for( std::int64_t i( 2 ); i < 12; i++ )
+      {
+         fifo.push( i, ( i % 4 == 0 ? RBSignal::TERM : RBSignal::NONE ) );
+      }
+      for( std::int64_t i( 0 ); i < 12; i++ )
+      {
+         std::int64_t value( -1 );
+         RBSignal signal( RBSignal::NONE );
+         fifo.pop( value, &signal );
+         assert( value == i );
+         assert( signal == ( i % 4 == 0 ? RBSignal::TERM : RBSignal::NONE ) );
+      }
+   }
+
+   /** asynchronous signals go around the elements **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      const auto none( fifo.get_signal() );
+      assert( none == RBSignal::NONE );
+      for( std::int64_t i( 0 ); i < BUFFSIZE; i++ )
+      {
+         fifo.push( i );
+      }
+      /** a full queue doesn't hold them up **/
+      const bool term( fifo.send_signal( RBSignal::TERM ) );
+      const bool eof ( fifo.send_signal( RBSignal::RBEOF ) );
+      assert( term && eof );
+      const auto first ( fifo.get_signal() );
+      const auto second( fifo.get_signal() );
+      const auto third ( fifo.get_signal() );
+      assert( first == RBSignal::TERM && second == RBSignal::RBEOF && third == RBSignal::NONE );
+      /** the channel itself is bounded **/
+      std::size_t sent( 0 );
+      while( fifo.send_signal( RBSignal::TERM ) )
+      {
+         sent++;
+      }
+      assert( sent > 0 );
+      for( std::size_t i( 0 ); i < sent; i++ )
+      {
+         const auto signal( fifo.get_signal() );
+         assert( signal == RBSignal::TERM );
+      }
+      const auto drained( fifo.get_signal() );
+      assert( drained == RBSignal::NONE );
+   }
+
+   /** several senders, nothing lost or doubled **/
+   {
+      RingBuffer< std::int64_t, Type::MPMC > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      const std::size_t per_thread( 10000 );
+      std::vector< std::thread > senders;
+      for( std::size_t t( 0 ); t < 3; t++ )
+      {
+         senders.emplace_back( [&]()
+         {
+            for( std::size_t i( 0 ); i < per_thread; i++ )
+            {
+               while( ! fifo.send_signal( RBSignal::TERM ) )
+               {
+                  std::this_thread::yield();
+               }
+            }
+         } );
+      }
+      std::size_t received( 0 );
+      while( received < 3 * per_thread )
+      {
+         const auto signal( fifo.get_signal() );
+         if( signal == RBSignal::NONE )
+         {
+            std::this_thread::yield();
+            continue;
+         }
+         assert( signal == RBSignal::TERM );
+         received++;
+      }
+      for( auto &sender : senders )
+      {
+         sender.join();
+      }
+      const auto drained( fifo.get_signal() );
+      assert( drained == RBSignal::NONE );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,152 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cassert>
+#include <string>
+#include "ringbuffer.tcc"
+
+/**
+ * a small queue that spills into a file backed overflow while
+ * the consumer stalls, the producer never waits unless the
+ * overflow is full too, everything comes out in order with
+ * its signals, and the queue goes back to memory afterwards.
+ */
+#define BUFFSIZE  16
+#define SPILLSIZE 4096
+#define SENDCOUNT 300000
+
+static RBSignal signal_for( const std::int64_t i, const std::int64_t last )
+{
+   if( i == last )
+   {
+      return( RBSignal::RBEOF );
+   }
+   return( i % 100 == 99 ? RBSignal::QUIT : RBSignal::NONE );
+}
+
+/** consumer asleep, all of it fits in memory plus overflow **/
+template < class Q > void
+stall( Q &buffer )
+{
+   FIFO &fifo( buffer );
+   const std::int64_t count( BUFFSIZE + SPILLSIZE );
+   for( int round( 0 ); round < 3; round++ )
+   {
+      for( std::int64_t i( 0 ); i < count; i++ )
+      {
+         const bool pushed( fifo.try_push( i, signal_for( i, count - 1 ) ) );
+         assert( pushed );
+      }
+      assert( buffer.spilling() && fifo.size() == count );
+      /** and only then does it fill up **/
+      const bool full( ! fifo.try_push( std::int64_t( -1 ) ) );
+      assert( full );
+      for( std::int64_t i( 0 ); i < count; i++ )
+      {
+         std::int64_t value( -1 );
+         RBSignal signal( RBSignal::NONE );
+         fifo.pop( value, &signal );
+         assert( value == i && signal == signal_for( i, count - 1 ) );
+      }
+      /** the consumer is past the memory buffer, the producer comes back **/
+      fifo.push( std::int64_t( 7 ) );
+      assert( ! buffer.spilling() && fifo.capacity() == BUFFSIZE );
+      std::int64_t value( -1 );
+      fifo.pop( value );
+      assert( value == 7 );
+   }
+}
+
+/** consumer that naps now and then **/
+template < class Q > void
+stream( Q &buffer )
+{
+   FIFO &fifo( buffer );
+   std::thread producer( [&]()
+   {
+      for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+      {
+         fifo.push( i, signal_for( i, SENDCOUNT - 1 ) );
+      }
+   } );
+   std::int64_t expected( 0 );
+   std::int64_t items[ 64 ];
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      if( expected % 50000 < 64 )
+      {
+         std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+      }
+      const auto n( fifo.pop_until_signal( items, 64, &signal ) );
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         assert( items[ i ] == expected + std::int64_t( i ) );
+      }
+      expected += n;
+      assert( signal == signal_for( expected - 1, SENDCOUNT - 1 ) );
+   }
+   assert( expected == SENDCOUNT );
+   producer.join();
+}
+
+template < Layout::SlotLayout layout > void
+run()
+{
+   RingBuffer< std::int64_t, Type::Heap, layout > buffer( BUFFSIZE );
+   const bool spills( buffer.spill_to( "/tmp", SPILLSIZE ) );
+   const bool again ( buffer.spill_to( "/tmp", SPILLSIZE ) );
+   assert( spills && ! again );
+   assert( ! buffer.spilling() );
+   stall( buffer );
+   stream( buffer );
+}
+
+int
+main( int argc, char **argv )
+{
+   run< Layout::Split >();
+   run< Layout::Sparse >();
+   run< Layout::Interleaved >();
+
+   /** items that own memory, a resize in the middle of a spill **/
+   {
+      RingBuffer< std::string > buffer( 4 );
+      const bool spills( buffer.spill_to( "/tmp", 64 ) );
+      assert( spills );
+      FIFO &fifo( buffer );
+      for( int i( 0 ); i < 28; i++ )
+      {
+         fifo.push( std::string( 40, 'a' + ( i % 26 ) ) );
+         if( i == 20 )
+         {
+            fifo.resize( 8 );
+         }
+      }
+      assert( ! buffer.spilling() && fifo.capacity() == 8 );
+      for( int i( 0 ); i < 28; i++ )
+      {
+         std::string value;
+         fifo.pop( value );
+         assert( value == std::string( 40, 'a' + ( i % 26 ) ) );
+      }
+      /** left in the overflow for the destructor **/
+      for( int i( 0 ); i < 20; i++ )
+      {
+         fifo.push( std::string( 40, 'z' ) );
+      }
+      assert( buffer.spilling() );
+   }
+
+   /** fixed capacity queues don't spill **/
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Split, BUFFSIZE > buffer( BUFFSIZE,
+                                                                           L1D_CACHE_LINE_SIZE );
+      const bool spills( buffer.spill_to( "/tmp", SPILLSIZE ) );
+      assert( ! spills );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,150 @@
+#ifndef FIFO_INSTRUMENT
+#define FIFO_INSTRUMENT 1
+#endif
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "instrument.hpp"
+#include "signalvars.hpp"
+
+/**
+ * builds with the instrumentation on, checks that the registry
+ * sees every queue, that the counts add up and that snapshots
+ * can be taken while traffic is flowing.
+ */
+#define BUFFSIZE 8
+
+typedef RingBuffer< std::int64_t, Type::Heap > TheBuffer;
+
+static_assert( std::is_empty< Stats::Probe< false > >::value,
+               "disabled probe must not take up space" );
+
+void
+producer( FIFO &buffer, const std::int64_t send_count )
+{
+   for( std::int64_t i( 1 ); i <= send_count; i++ )
+   {
+      buffer.push( i, ( i == send_count ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer, const std::int64_t send_count )
+{
+   std::int64_t expected( 1 );
+   std::int64_t value( 0 );
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      buffer.pop( value, &signal );
+      assert( value == expected );
+      expected++;
+   }
+   assert( value == send_count );
+   return;
+}
+
+static Stats::Snapshot
+find( const std::string &label )
+{
+   for( const auto &snapshot : Stats::Registry::instance().snapshot() )
+   {
+      if( snapshot.label == label )
+      {
+         return( snapshot );
+      }
+   }
+   assert( false );
+   return( Stats::Snapshot() );
+}
+
+static std::uint64_t
+total( const std::array< std::uint64_t, Stats::bins > &histogram )
+{
+   return( std::accumulate( histogram.begin(), histogram.end(), std::uint64_t( 0 ) ) );
+}
+
+int
+main( int argc, char **argv )
+{
+   const std::int64_t send_count( 100000 );
+   {
+      TheBuffer buffer( BUFFSIZE );
+      buffer.set_label( "busy" );
+      std::atomic< bool > done( false );
+      std::thread a( producer, std::ref( buffer ), send_count );
+      std::thread b( consumer, std::ref( buffer ), send_count );
+      /** snapshots while the queue is in use only ever go up **/
+      std::uint64_t last( 0 );
+      std::thread c( [&]()
+      {
+         while( ! done )
+         {
+            const auto snapshot( find( "busy" ) );
+            assert( snapshot.write.items >= last );
+            assert( snapshot.read.items <= snapshot.write.items );
+            last = snapshot.write.items;
+            std::this_thread::yield();
+         }
+      } );
+      a.join();
+      b.join();
+      done = true;
+      c.join();
+
+      const auto snapshot( find( "busy" ) );
+      assert( snapshot.capacity     == BUFFSIZE );
+      assert( snapshot.write.items  == std::uint64_t( send_count ) );
+      assert( snapshot.read.items   == std::uint64_t( send_count ) );
+      assert( total( snapshot.write.episode_cycles ) == snapshot.write.episodes );
+      assert( total( snapshot.read.episode_cycles )  == snapshot.read.episodes );
+      /** one sample per FIFO_INSTRUMENT_SAMPLE items written **/
+      assert( total( snapshot.occupancy ) == std::uint64_t( send_count / FIFO_INSTRUMENT_SAMPLE ) );
+      for( std::size_t i( Stats::bin( BUFFSIZE ) + 1 ); i < Stats::bins; i++ )
+      {
+         assert( snapshot.occupancy[ i ] == 0 );
+      }
+      std::cout << snapshot;
+   }
+   /** gone from the registry once destroyed **/
+   for( const auto &snapshot : Stats::Registry::instance().snapshot() )
+   {
+      assert( snapshot.label != "busy" );
+   }
+
+   /** a producer that has to wait on a late consumer **/
+   {
+      TheBuffer buffer( 2, 16, Wait::Policy( Wait::Park ) );
+      buffer.set_label( "late" );
+      std::thread a( producer, std::ref( buffer ), 100 );
+      std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+      std::thread b( consumer, std::ref( buffer ), 100 );
+      a.join();
+      b.join();
+      const auto snapshot( find( "late" ) );
+      assert( snapshot.write.episodes > 0 );
+      assert( snapshot.write.blocked_cycles > 0 );
+      std::cout << snapshot;
+   }
+
+   /** a resize shows up as the new capacity **/
+   {
+      TheBuffer buffer( 4 );
+      buffer.set_label( "resized" );
+      buffer.resize( 16 );
+      FIFO &fifo( buffer );
+      std::int64_t value( 0 );
+      fifo.push( value );
+      fifo.pop( value );
+      assert( find( "resized" ).capacity == 16 );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
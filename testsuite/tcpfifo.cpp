@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * sends a sequence over loopback between a TCP producer and
+ * consumer end.  The consumer ring is smaller than the producer
+ * ring so that the producer regularly runs out of credit.
+ */
+#define PRODUCERSIZE 256
+#define CONSUMERSIZE 61
+#define BATCH        16
+#define SENDCOUNT    200000
+
+template < Layout::SlotLayout layout > void
+producer( const std::uint16_t port )
+{
+   RingBuffer< std::int64_t, Type::TCP, layout > buffer( PRODUCERSIZE,
+                                                         "127.0.0.1",
+                                                         port,
+                                                         Direction::Producer );
+   /** nothing sent yet, the whole remote ring is available **/
+   assert( buffer.space_avail() == PRODUCERSIZE + CONSUMERSIZE );
+   FIFO &fifo( buffer );
+   std::int64_t current_count( 0 );
+   std::vector< std::int64_t > batch;
+   while( current_count < SENDCOUNT )
+   {
+      if( ( current_count / BATCH ) % 2 == 0 )
+      {
+         auto &ref( fifo.allocate< std::int64_t >() );
+         ref = current_count++;
+         fifo.push( current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE );
+      }
+      else
+      {
+         batch.clear();
+         while( batch.size() < BATCH && current_count < SENDCOUNT )
+         {
+            batch.push_back( current_count++ );
+         }
+         fifo.insert( batch.begin(), batch.end(),
+            ( current_count == SENDCOUNT ? RBSignal::RBEOF : RBSignal::NONE ) );
+      }
+   }
+   /** destructor waits for everything to go out **/
+}
+
+template < Layout::SlotLayout layout > void
+run()
+{
+   RingBuffer< std::int64_t, Type::TCP, layout > buffer( CONSUMERSIZE,
+                                                         "127.0.0.1",
+                                                         0,
+                                                         Direction::Consumer );
+   std::thread a( producer< layout >, buffer.port() );
+   FIFO &fifo( buffer );
+   std::int64_t expected( 0 );
+   std::int64_t items  [ BATCH ];
+   RBSignal     signals[ BATCH ];
+   RBSignal     signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      if( SENDCOUNT - expected >= BATCH )
+      {
+         fifo.pop_range( items, BATCH, signals );
+         for( std::size_t i( 0 ); i < BATCH; i++ )
+         {
+            assert( items[ i ] == expected );
+            expected++;
+         }
+         signal = signals[ BATCH - 1 ];
+      }
+      else
+      {
+         std::int64_t item( 0 );
+         fifo.pop( item, &signal );
+         assert( item == expected );
+         expected++;
+      }
+   }
+   assert( expected == SENDCOUNT );
+   a.join();
+}
+
+int
+main( int argc, char **argv )
+{
+   run< Layout::Split >();
+   run< Layout::Interleaved >();
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,238 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "shm.hpp"
+#include "signalvars.hpp"
+
+/**
+ * the non-blocking and timed calls, a full or empty queue
+ * hands control straight back (or at the deadline) and one
+ * thread can serve several queues by polling them.
+ */
+#define BUFFSIZE  8
+#define QUEUES    4
+#define SENDCOUNT 50000
+
+using namespace std::chrono;
+
+/** in and out are the two ends, the same object unless SHM **/
+void
+check_empty_full( FIFO &in, FIFO &out, const std::size_t cap )
+{
+   std::int64_t value( -1 );
+   std::int64_t items[ 4 ];
+   const bool popped( out.try_pop( value ) );
+   assert( ! popped );
+   const std::size_t none( out.try_pop_range( items, 4 ) );
+   assert( none == 0 );
+   {
+      const auto start( steady_clock::now() );
+      const bool waited( out.try_pop_for( value, milliseconds( 5 ) ) );
+      assert( ! waited );
+      assert( steady_clock::now() - start >= milliseconds( 5 ) );
+   }
+   /** fill it up without ever blocking **/
+   std::size_t pushed( 0 );
+   for( std::int64_t i( 0 ); in.try_push( i ); i++ )
+   {
+      pushed++;
+      assert( pushed <= cap );
+   }
+   assert( pushed == cap );
+   const auto *none_left( in.try_allocate< std::int64_t >() );
+   assert( none_left == nullptr );
+   {
+      const auto start( steady_clock::now() );
+      const std::int64_t extra( 99 );
+      const bool waited( in.try_push_for( extra, milliseconds( 5 ) ) );
+      assert( ! waited );
+      assert( steady_clock::now() - start >= milliseconds( 5 ) );
+   }
+   const bool late( in.try_push_until( std::int64_t( 99 ), 
+                                       steady_clock::now() + microseconds( 100 ) ) );
+   assert( ! late );
+   /** and drain it the same way **/
+   const bool first( out.try_pop( value ) );
+   assert( first && value == 0 );
+   auto *slot( in.try_allocate< std::int64_t >() );
+   assert( slot != nullptr );
+   *slot = cap;
+   in.push( RBSignal::RBEOF );
+   RBSignal signals[ 4 ];
+   std::int64_t expected( 1 );
+   std::size_t n( 0 );
+   while( ( n = out.try_pop_range( items, 4, signals ) ) > 0 )
+   {
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         assert( items[ i ] == expected );
+         assert( signals[ i ] == ( expected == std::int64_t( cap ) ?
+                                   RBSignal::RBEOF : RBSignal::NONE ) );
+         expected++;
+      }
+   }
+   assert( expected == std::int64_t( cap ) + 1 );
+}
+
+/** one consumer thread polls every queue, never blocking on any **/
+void
+poll_many( const Wait::Strategy strategy )
+{
+   std::vector< std::unique_ptr< RingBuffer< std::int64_t > > > queues;
+   for( std::size_t q( 0 ); q < QUEUES; q++ )
+   {
+      queues.emplace_back( new RingBuffer< std::int64_t >( BUFFSIZE, 16, Wait::Policy( strategy ) ) );
+   }
+   std::vector< std::thread > producers;
+   for( std::size_t q( 0 ); q < QUEUES; q++ )
+   {
+      producers.emplace_back( [&, q]()
+      {
+         FIFO &fifo( *queues[ q ] );
+         /** a different rate on each so some sit empty while others fill **/
+         for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+         {
+            if( q % 2 == 0 )
+            {
+               fifo.push( i );
+            }
+            else
+            {
+               while( ! fifo.try_push_for( i, microseconds( 50 * ( q + 1 ) ) ) )
+               {
+               }
+            }
+         }
+      } );
+   }
+   std::int64_t expected[ QUEUES ] = { 0 };
+   std::size_t  done( 0 );
+   std::int64_t items[ BUFFSIZE ];
+   while( done < QUEUES )
+   {
+      bool idle( true );
+      for( std::size_t q( 0 ); q < QUEUES; q++ )
+      {
+         if( expected[ q ] == SENDCOUNT )
+         {
+            continue;
+         }
+         FIFO &fifo( *queues[ q ] );
+         const auto n( q == 0 ? fifo.try_pop_range( items, BUFFSIZE ) :
+                                ( fifo.try_pop( items[ 0 ] ) ? 1 : 0 ) );
+         for( std::size_t i( 0 ); i < n; i++ )
+         {
+            assert( items[ i ] == expected[ q ] );
+            expected[ q ]++;
+         }
+         idle = ( idle && n == 0 );
+         if( expected[ q ] == SENDCOUNT )
+         {
+            done++;
+         }
+      }
+      if( idle )
+      {
+         /** nothing anywhere, let the producers run **/
+         std::this_thread::yield();
+      }
+   }
+   for( auto &producer : producers )
+   {
+      producer.join();
+   }
+}
+
+int
+main( int argc, char **argv )
+{
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE );
+      check_empty_full( buffer, buffer, BUFFSIZE );
+   }
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Split, BUFFSIZE > buffer(
+         Wait::Policy( Wait::Park ) );
+      check_empty_full( buffer, buffer, BUFFSIZE );
+   }
+   {
+      RingBuffer< std::int64_t, Type::MPMC > buffer( BUFFSIZE, 16, Wait::Policy( Wait::Park ) );
+      check_empty_full( buffer, buffer, BUFFSIZE );
+   }
+   {
+      char shmkey[ 256 ];
+      SHM::GenKey( shmkey, 256 );
+      RingBuffer< std::int64_t, Type::SharedMemory > in( BUFFSIZE, shmkey, Direction::Producer );
+      RingBuffer< std::int64_t, Type::SharedMemory > out( 0, shmkey, Direction::Consumer );
+      check_empty_full( in, out, BUFFSIZE );
+   }
+
+   /** a rvalue that didn't go in is left alone **/
+   {
+      RingBuffer< std::unique_ptr< std::int64_t > > buffer( 1 );
+      FIFO &fifo( buffer );
+      std::unique_ptr< std::int64_t > first( new std::int64_t( 1 ) );
+      std::unique_ptr< std::int64_t > second( new std::int64_t( 2 ) );
+      const bool in( fifo.try_push( std::move( first ) ) );
+      assert( in && ! first );
+      const bool full( ! fifo.try_push( std::move( second ) ) );
+      assert( full && second );
+      std::unique_ptr< std::int64_t > out;
+      const bool popped( fifo.try_pop( out ) );
+      assert( popped && *out == 1 );
+      const bool retried( fifo.try_push( std::move( second ) ) );
+      assert( retried && ! second );
+   }
+
+   /** the timed calls return as soon as the other side shows up **/
+   {
+      RingBuffer< std::int64_t > buffer( BUFFSIZE, 16, Wait::Policy( Wait::Park, 0, 0 ) );
+      FIFO &fifo( buffer );
+      std::thread late( [&]()
+      {
+         std::this_thread::sleep_for( milliseconds( 10 ) );
+         fifo.push( std::int64_t( 7 ) );
+      } );
+      std::int64_t value( 0 );
+      const bool popped( fifo.try_pop_for( value, seconds( 30 ) ) );
+      assert( popped && value == 7 );
+      late.join();
+      /** a timeout too big to add to now() is no timeout at all **/
+      std::thread later( [&]()
+      {
+         std::this_thread::sleep_for( milliseconds( 10 ) );
+         fifo.push( std::int64_t( 8 ) );
+      } );
+      const bool forever( fifo.try_pop_for( value, hours::max() ) );
+      assert( forever && value == 8 );
+      later.join();
+   }
+
+   /** the infinite queue never waits **/
+   {
+      RingBuffer< std::int64_t, Type::Infinite > buffer( BUFFSIZE );
+      FIFO &fifo( buffer );
+      std::int64_t value( 5 );
+      std::int64_t items[ 3 ];
+      const bool pushed( fifo.try_push( value ) );
+      assert( pushed );
+      const bool popped( fifo.try_pop( value ) );
+      assert( popped && value == 5 );
+      const std::size_t n( fifo.try_pop_range( items, 3 ) );
+      assert( n == 3 && items[ 2 ] == 5 );
+      const auto *slot( fifo.try_allocate< std::int64_t >() );
+      assert( slot != nullptr );
+      fifo.push();
+   }
+
+   poll_many( Wait::Yield );
+   poll_many( Wait::Park );
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
@@ -0,0 +1,168 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include "ringbuffer.tcc"
+
+/**
+ * pop_until_signal, bulk pops that stop right after the first
+ * signalled item and never wait for more than the first one,
+ * so a consumer can't hang at the end of the stream.
+ */
+#define BUFFSIZE  64
+#define SENDCOUNT 500000
+#define BATCH     128
+
+/** signal every so often and RBEOF on the last one **/
+static RBSignal signal_for( const std::int64_t i )
+{
+   if( i == SENDCOUNT - 1 )
+   {
+      return( RBSignal::RBEOF );
+   }
+   return( i % 1000 == 999 ? RBSignal::QUIT : RBSignal::NONE );
+}
+
+void
+scan()
+{
+   /** every length and position through the vector and scalar parts **/
+   for( std::size_t n( 0 ); n < 70; n++ )
+   {
+      std::vector< RBSignal > signals( n, RBSignal::NONE );
+      assert( Signals::find( signals.data(), n ) == n );
+      for( std::size_t at( 0 ); at < n; at++ )
+      {
+         signals[ at ] = RBSignal::TERM;
+         assert( Signals::find( signals.data(), n ) == at );
+         /** a later one doesn't matter **/
+         signals[ n - 1 ] = RBSignal::RBEOF;
+         assert( Signals::find( signals.data(), n ) == at );
+         std::fill( signals.begin(), signals.end(), RBSignal::NONE );
+      }
+   }
+}
+
+template < class Q > void
+single( Q &buffer, const bool wrap )
+{
+   FIFO &fifo( buffer );
+   std::int64_t items[ BATCH ];
+   RBSignal signal( RBSignal::TERM );
+   if( wrap )
+   {
+      /** move the pointers so the next run crosses the end **/
+      for( std::int64_t i( 0 ); i < BUFFSIZE - 3; i++ )
+      {
+         fifo.push( i );
+      }
+      const auto n( fifo.pop_until_signal( items, BATCH, &signal ) );
+      assert( n == BUFFSIZE - 3 && signal == RBSignal::NONE );
+   }
+   for( std::int64_t i( 0 ); i < 20; i++ )
+   {
+      fifo.push( i, ( i == 6 ? RBSignal::QUIT :
+                      i == 19 ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   const auto first( fifo.pop_until_signal( items, BATCH, &signal ) );
+   assert( first == 7 );
+   assert( signal == RBSignal::QUIT && items[ 0 ] == 0 && items[ 6 ] == 6 );
+   /** no more than asked for, even with no signal in sight **/
+   const auto second( fifo.pop_until_signal( items, 5, &signal ) );
+   assert( second == 5 );
+   assert( signal == RBSignal::NONE && items[ 0 ] == 7 && items[ 4 ] == 11 );
+   const auto third( fifo.pop_until_signal( items, BATCH, &signal ) );
+   assert( third == 8 );
+   assert( signal == RBSignal::RBEOF && items[ 7 ] == 19 );
+   assert( fifo.size() == 0 );
+}
+
+template < class Q > void
+stream( Q &buffer )
+{
+   FIFO &fifo( buffer );
+   std::thread producer( [&]()
+   {
+      for( std::int64_t i( 0 ); i < SENDCOUNT; i++ )
+      {
+         fifo.push( i, signal_for( i ) );
+      }
+   } );
+   std::int64_t expected( 0 );
+   std::int64_t items[ BATCH ];
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      const auto n( fifo.pop_until_signal( items, BATCH, &signal ) );
+      assert( n > 0 && n <= BATCH );
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         assert( items[ i ] == expected + std::int64_t( i ) );
+         /** only the last of a batch may carry a signal **/
+         assert( i == n - 1 || signal_for( items[ i ] ) == RBSignal::NONE );
+      }
+      expected += n;
+      assert( signal == signal_for( expected - 1 ) );
+   }
+   assert( expected == SENDCOUNT );
+   producer.join();
+}
+
+int
+main( int argc, char **argv )
+{
+   scan();
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Split > buffer( BUFFSIZE );
+      single( buffer, false );
+      single( buffer, true );
+      stream( buffer );
+   }
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Interleaved > buffer( BUFFSIZE );
+      single( buffer, true );
+      stream( buffer );
+   }
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Sparse > buffer( BUFFSIZE );
+      single( buffer, true );
+      stream( buffer );
+   }
+   {
+      RingBuffer< std::int64_t, Type::Heap, Layout::Split, BUFFSIZE > buffer( BUFFSIZE,
+                                                                           L1D_CACHE_LINE_SIZE );
+      single( buffer, true );
+      /** and through the typed handle **/
+      auto out( buffer.producer() );
+      auto in ( buffer.consumer() );
+      out.push( 1 );
+      out.push( 2, RBSignal::RBEOF );
+      std::int64_t items[ 4 ];
+      RBSignal signal( RBSignal::NONE );
+      const auto n( in.pop_until_signal( items, 4, &signal ) );
+      assert( n == 2 && signal == RBSignal::RBEOF );
+   }
+   {
+      RingBuffer< std::int64_t, Type::MPMC > buffer( BUFFSIZE );
+      single( buffer, true );
+      stream( buffer );
+   }
+   {
+      RingBuffer< std::int64_t, Type::Infinite > infinite( BUFFSIZE );
+      FIFO &buffer( infinite );
+      std::int64_t items[ 8 ];
+      RBSignal signal( RBSignal::TERM );
+      buffer.push( std::int64_t( 3 ) );
+      const auto first( buffer.pop_until_signal( items, 8, &signal ) );
+      assert( first == 8 );
+      assert( signal == RBSignal::NONE && items[ 7 ] == 3 );
+      buffer.push( std::int64_t( 4 ), RBSignal::RBEOF );
+      const auto second( buffer.pop_until_signal( items, 8, &signal ) );
+      assert( second == 1 );
+      assert( signal == RBSignal::RBEOF && items[ 0 ] == 4 );
+   }
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}
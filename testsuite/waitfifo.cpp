@@ -0,0 +1,74 @@
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <cstdint>
+#include <cassert>
+#include "ringbuffer.tcc"
+#include "signalvars.hpp"
+
+/**
+ * runs the same producer / consumer pair under each wait 
+ * strategy, the buffer is kept small so that both sides 
+ * spend plenty of time blocked.
+ */
+#define BUFFSIZE 8
+
+typedef RingBuffer< std::int64_t, Type::Heap > TheBuffer;
+
+void
+producer( FIFO &buffer, const std::int64_t send_count )
+{
+   for( std::int64_t i( 1 ); i <= send_count; i++ )
+   {
+      buffer.push( i, ( i == send_count ? RBSignal::RBEOF : RBSignal::NONE ) );
+   }
+   return;
+}
+
+void
+consumer( FIFO &buffer, const std::int64_t send_count )
+{
+   std::int64_t expected( 1 );
+   std::int64_t value( 0 );
+   RBSignal signal( RBSignal::NONE );
+   while( signal != RBSignal::RBEOF )
+   {
+      buffer.pop( value, &signal );
+      assert( value == expected );
+      expected++;
+   }
+   assert( value == send_count );
+   return;
+}
+
+int
+main( int argc, char **argv )
+{
+   /** busy spin needs a free core per side to make progress quickly **/
+   const std::int64_t spin_count( 
+      std::thread::hardware_concurrency() > 1 ? 100000 : 1000 );
+   const struct
+   {
+      Wait::Strategy strategy;
+      std::int64_t   send_count;
+   } runs[] = { { Wait::Spin,  spin_count },
+                { Wait::Yield, 100000     },
+                { Wait::Park,  100000     } };
+   for( const auto &run : runs )
+   {
+      TheBuffer buffer( BUFFSIZE, 16, Wait::Policy( run.strategy ) );
+      std::thread a( producer, std::ref( buffer ), run.send_count );
+      std::thread b( consumer, std::ref( buffer ), run.send_count );
+      a.join();
+      b.join();
+      assert( buffer.size() == 0 );
+   }
+   /** park immediately, no spinning at all **/
+   TheBuffer buffer( BUFFSIZE, 16, Wait::Policy( Wait::Park, 0, 0 ) );
+   std::thread a( producer, std::ref( buffer ), 100000 );
+   std::thread b( consumer, std::ref( buffer ), 100000 );
+   a.join();
+   b.join();
+   std::cout << "done\n";
+   return( EXIT_SUCCESS );
+}